@@ -7,12 +7,19 @@
  *   3. Find GOT entries for any function
  *   4. Calculate offsets for exploitation
  *
+ * Symbols are looked up through DT_GNU_HASH when the object has one (a
+ * bloom filter rejects most misses before any bucket is touched), with
+ * the SysV DT_HASH table as the fallback. Many distro libraries ship
+ * only DT_GNU_HASH. Lookups honor symbol versions (DT_VERSYM/DT_VERDEF)
+ * the way ld.so does: a bare name gets the default version, name@VER
+ * gets exactly that one, hidden or not.
+ *
  * This technique is useful when:
  *   - dlsym is not available or blocked
  *   - You have arbitrary read but limited execution
  *   - Building shellcode that needs to find libc functions
  *
- * Compile: gcc -o got_resolver got_resolver.c
+ * Compile: gcc -o got_resolver got_resolver.c -ldl
  *
  * EDUCATIONAL PURPOSES ONLY
  */
@@ -25,6 +32,8 @@
 #include <unistd.h>
 #include <link.h>
 #include <elf.h>
+#include <dlfcn.h>
+#include <time.h>
 
 /* Color codes */
 #define RED     "\033[1;31m"
@@ -44,12 +53,28 @@ typedef struct {
     char *strtab;
     size_t strtab_size;
     ElfW(Word) *hash;
+    const uint32_t *gnu_hash;
     ElfW(Addr) *pltgot;
     ElfW(Rela) *jmprel;
     size_t pltrelsz;
+    ElfW(Rela) *rela;
+    size_t relasz;
+    ElfW(Half) *versym;
+    ElfW(Verdef) *verdef;
+    ElfW(Word) verdefnum;
     uintptr_t base;
 } dyn_info_t;
 
+/*
+ * ld.so rebases the d_ptr entries of objects it relocates, but not those
+ * whose .dynamic is read-only (the vDSO): those still hold link-time
+ * addresses and need l_addr added.
+ */
+static uintptr_t dyn_ptr(struct link_map *lm, ElfW(Dyn) *dyn) {
+    uintptr_t ptr = dyn->d_un.d_ptr;
+    return ptr < lm->l_addr ? ptr + lm->l_addr : ptr;
+}
+
 int parse_dynamic_section(struct link_map *lm, dyn_info_t *info) {
     if (!lm || !lm->l_ld) return -1;
 
@@ -59,26 +84,44 @@ int parse_dynamic_section(struct link_map *lm, dyn_info_t *info) {
     for (ElfW(Dyn) *dyn = lm->l_ld; dyn->d_tag != DT_NULL; dyn++) {
         switch (dyn->d_tag) {
             case DT_SYMTAB:
-                info->symtab = (ElfW(Sym) *)dyn->d_un.d_ptr;
+                info->symtab = (ElfW(Sym) *)dyn_ptr(lm, dyn);
                 break;
             case DT_STRTAB:
-                info->strtab = (char *)dyn->d_un.d_ptr;
+                info->strtab = (char *)dyn_ptr(lm, dyn);
                 break;
             case DT_STRSZ:
                 info->strtab_size = dyn->d_un.d_val;
                 break;
             case DT_HASH:
-                info->hash = (ElfW(Word) *)dyn->d_un.d_ptr;
+                info->hash = (ElfW(Word) *)dyn_ptr(lm, dyn);
+                break;
+            case DT_GNU_HASH:
+                info->gnu_hash = (const uint32_t *)dyn_ptr(lm, dyn);
                 break;
             case DT_PLTGOT:
-                info->pltgot = (ElfW(Addr) *)dyn->d_un.d_ptr;
+                info->pltgot = (ElfW(Addr) *)dyn_ptr(lm, dyn);
                 break;
             case DT_JMPREL:
-                info->jmprel = (ElfW(Rela) *)dyn->d_un.d_ptr;
+                info->jmprel = (ElfW(Rela) *)dyn_ptr(lm, dyn);
                 break;
             case DT_PLTRELSZ:
                 info->pltrelsz = dyn->d_un.d_val;
                 break;
+            case DT_RELA:
+                info->rela = (ElfW(Rela) *)dyn_ptr(lm, dyn);
+                break;
+            case DT_RELASZ:
+                info->relasz = dyn->d_un.d_val;
+                break;
+            case DT_VERSYM:
+                info->versym = (ElfW(Half) *)dyn_ptr(lm, dyn);
+                break;
+            case DT_VERDEF:
+                info->verdef = (ElfW(Verdef) *)dyn_ptr(lm, dyn);
+                break;
+            case DT_VERDEFNUM:
+                info->verdefnum = dyn->d_un.d_val;
+                break;
         }
     }
 
@@ -101,17 +144,65 @@ static unsigned long elf_hash(const char *name) {
     return h;
 }
 
-void *resolve_symbol(dyn_info_t *info, const char *name) {
-    if (!info->symtab || !info->strtab || !info->hash)
-        return NULL;
+/* GNU hash function (DJB: h * 33 + c) */
+static uint32_t gnu_hash(const char *name) {
+    uint32_t h = 5381;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+        h = (h << 5) + h + *p;
+    return h;
+}
+
+/*
+ * Symbol versions. DT_VERSYM gives each dynamic symbol a version index
+ * (bit 15: hidden, i.e. not the default); DT_VERDEF lists the versions
+ * the object defines, each with the ELF hash of its name precomputed by
+ * the linker (vd_hash). A wanted version is turned into this object's
+ * index once, so the chain walk only compares integers.
+ */
+#ifndef VERSYM_HIDDEN
+#define VERSYM_HIDDEN       0x8000
+#define VERSYM_VERSION      0x7fff
+#endif
+
+#define VER_WANT_DEFAULT    (-1)    /* bare name: default version only */
+#define VER_WANT_NONE       (-2)    /* object lacks the wanted version */
+
+static int version_index(dyn_info_t *info, const char *version, unsigned long hash) {
+    if (!version) return VER_WANT_DEFAULT;
+    if (!info->verdef || !info->versym) return VER_WANT_DEFAULT;  /* unversioned object */
+
+    ElfW(Verdef) *vd = info->verdef;
+    for (ElfW(Word) i = 0; i < info->verdefnum; i++) {
+        ElfW(Verdaux) *aux = (ElfW(Verdaux) *)((char *)vd + vd->vd_aux);
+        if (vd->vd_hash == hash && !(vd->vd_flags & VER_FLG_BASE) &&
+            strcmp(&info->strtab[aux->vda_name], version) == 0) {
+            return vd->vd_ndx;
+        }
+        if (!vd->vd_next) break;
+        vd = (ElfW(Verdef) *)((char *)vd + vd->vd_next);
+    }
+    return VER_WANT_NONE;
+}
+
+static int version_matches(dyn_info_t *info, ElfW(Word) symidx, int want) {
+    if (!info->versym) return 1;
+
+    ElfW(Half) v = info->versym[symidx];
+    ElfW(Half) ndx = v & VERSYM_VERSION;
 
+    if (ndx == VER_NDX_LOCAL) return 0;
+    if (want == VER_WANT_DEFAULT) return !(v & VERSYM_HIDDEN);
+    /* An unversioned definition also satisfies a versioned reference */
+    return ndx == want || (ndx == VER_NDX_GLOBAL && !(v & VERSYM_HIDDEN));
+}
+
+static void *resolve_sysv(dyn_info_t *info, const char *name, unsigned long hash, int want) {
     /* Hash table structure: [nbucket, nchain, bucket[nbucket], chain[nchain]] */
     ElfW(Word) nbucket = info->hash[0];
     ElfW(Word) nchain = info->hash[1];
     ElfW(Word) *bucket = &info->hash[2];
     ElfW(Word) *chain = &bucket[nbucket];
 
-    unsigned long hash = elf_hash(name);
     ElfW(Word) symidx = bucket[hash % nbucket];
 
     while (symidx != STN_UNDEF) {
@@ -119,7 +210,8 @@ void *resolve_symbol(dyn_info_t *info, const char *name) {
         const char *sym_name = &info->strtab[sym->st_name];
 
         if (strcmp(sym_name, name) == 0) {
-            if (sym->st_value != 0) {
+            if (sym->st_value != 0 && sym->st_shndx != SHN_UNDEF &&
+                version_matches(info, symidx, want)) {
                 return (void *)(info->base + sym->st_value);
             }
         }
@@ -131,6 +223,73 @@ void *resolve_symbol(dyn_info_t *info, const char *name) {
     return NULL;
 }
 
+/*
+ * GNU hash table structure:
+ *   [nbuckets, symoffset, bloom_size, bloom_shift,
+ *    bloom[bloom_size] (ElfW(Addr) words), buckets[nbuckets], chain[]]
+ *
+ * Only symbols from symoffset on are hashed, sorted by bucket. chain[i]
+ * holds the hash of symbol symoffset + i with bit 0 replaced by an
+ * end-of-chain marker.
+ */
+static void *resolve_gnu(dyn_info_t *info, const char *name, uint32_t h1, int want) {
+    const uint32_t *ht = info->gnu_hash;
+    uint32_t nbuckets = ht[0];
+    uint32_t symoffset = ht[1];
+    uint32_t bloom_size = ht[2];
+    uint32_t bloom_shift = ht[3];
+    const ElfW(Addr) *bloom = (const ElfW(Addr) *)&ht[4];
+    const uint32_t *buckets = (const uint32_t *)&bloom[bloom_size];
+    const uint32_t *chain = &buckets[nbuckets];
+    const unsigned bits = sizeof(ElfW(Addr)) * 8;
+
+    if (nbuckets == 0 || bloom_size == 0) return NULL;
+
+    /* Bloom filter: two bits per symbol; a clear bit means a sure miss */
+    ElfW(Addr) word = bloom[(h1 / bits) & (bloom_size - 1)];
+    ElfW(Addr) mask = ((ElfW(Addr))1 << (h1 % bits)) |
+                      ((ElfW(Addr))1 << ((h1 >> bloom_shift) % bits));
+    if ((word & mask) != mask) return NULL;
+
+    uint32_t symidx = buckets[h1 % nbuckets];
+    if (symidx < symoffset) return NULL;
+
+    for (;; symidx++) {
+        uint32_t h2 = chain[symidx - symoffset];
+
+        if ((h1 | 1) == (h2 | 1)) {
+            ElfW(Sym) *sym = &info->symtab[symidx];
+            if (sym->st_value != 0 && version_matches(info, symidx, want) &&
+                strcmp(&info->strtab[sym->st_name], name) == 0) {
+                return (void *)(info->base + sym->st_value);
+            }
+        }
+        if (h2 & 1) break;  /* End of chain */
+    }
+
+    return NULL;
+}
+
+/* Resolve name@version; version NULL means the default version */
+void *resolve_symbol_version(dyn_info_t *info, const char *name, const char *version) {
+    if (!info->symtab || !info->strtab)
+        return NULL;
+
+    int want = version_index(info, version, version ? elf_hash(version) : 0);
+    if (want == VER_WANT_NONE)
+        return NULL;
+
+    if (info->gnu_hash)
+        return resolve_gnu(info, name, gnu_hash(name), want);
+    if (info->hash)
+        return resolve_sysv(info, name, elf_hash(name), want);
+    return NULL;
+}
+
+void *resolve_symbol(dyn_info_t *info, const char *name) {
+    return resolve_symbol_version(info, name, NULL);
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * FIND GOT ENTRY FOR A FUNCTION
  * ═══════════════════════════════════════════════════════════════════════════ */
@@ -156,6 +315,125 @@ void *find_got_entry(dyn_info_t *info, const char *name) {
     return NULL;
 }
 
+/*
+ * GOT slot index: every symbol-bearing GOT slot of one object, from
+ * DT_JMPREL (JUMP_SLOT) and DT_RELA (GLOB_DAT), built once so that
+ * checking all slots of a large object is linear rather than one
+ * relocation scan per name.
+ *
+ *   refs[]      sorted by slot address  → slot to symbol (binary search)
+ *   by_name[]   open addressing on the GNU hash of the name → name to slot
+ *
+ * Where a name has several slots, the JUMP_SLOT one is found first, as
+ * with find_got_entry().
+ */
+
+typedef struct {
+    ElfW(Addr) *slot;           /* runtime address of the GOT slot */
+    uint32_t hash;              /* GNU hash of the symbol name */
+    uint32_t symidx;
+    uint32_t type;              /* R_X86_64_JUMP_SLOT or R_X86_64_GLOB_DAT */
+} got_ref_t;
+
+typedef struct {
+    dyn_info_t *info;
+    got_ref_t *refs;
+    size_t nrefs;
+    size_t njump_slot;
+    uint32_t *by_name;          /* index + 1 into refs; 0 = empty */
+    size_t mask;
+} got_index_t;
+
+static int cmp_got_ref(const void *a, const void *b) {
+    const got_ref_t *x = a, *y = b;
+    return (x->slot > y->slot) - (x->slot < y->slot);
+}
+
+static size_t collect_got_refs(dyn_info_t *info, ElfW(Rela) *rels, size_t size,
+                               uint32_t type, got_ref_t *out) {
+    size_t n = 0;
+
+    for (size_t i = 0; rels && i < size / sizeof(ElfW(Rela)); i++) {
+        ElfW(Word) symidx = ELF64_R_SYM(rels[i].r_info);
+        if (ELF64_R_TYPE(rels[i].r_info) != type || symidx == STN_UNDEF) continue;
+
+        const char *name = &info->strtab[info->symtab[symidx].st_name];
+        out[n++] = (got_ref_t){
+            .slot = (ElfW(Addr) *)(info->base + rels[i].r_offset),
+            .hash = gnu_hash(name),
+            .symidx = symidx,
+            .type = type,
+        };
+    }
+    return n;
+}
+
+int got_index_build(got_index_t *gi, dyn_info_t *info) {
+    memset(gi, 0, sizeof(*gi));
+    gi->info = info;
+
+    size_t max = info->pltrelsz / sizeof(ElfW(Rela)) + info->relasz / sizeof(ElfW(Rela));
+    if (max == 0) return 0;
+
+    gi->refs = malloc(max * sizeof(*gi->refs));
+    if (!gi->refs) return -1;
+    gi->nrefs = collect_got_refs(info, info->jmprel, info->pltrelsz, R_X86_64_JUMP_SLOT, gi->refs);
+    gi->njump_slot = gi->nrefs;
+    gi->nrefs += collect_got_refs(info, info->rela, info->relasz, R_X86_64_GLOB_DAT,
+                                  gi->refs + gi->nrefs);
+    qsort(gi->refs, gi->nrefs, sizeof(*gi->refs), cmp_got_ref);
+
+    size_t cap = 16;
+    while (cap < 2 * gi->nrefs) cap *= 2;
+    gi->by_name = calloc(cap, sizeof(*gi->by_name));
+    if (!gi->by_name) {
+        free(gi->refs);
+        gi->refs = NULL;
+        return -1;
+    }
+    gi->mask = cap - 1;
+
+    /* JUMP_SLOT entries first, so they sit earlier on every probe path */
+    for (int pass = 0; pass < 2; pass++) {
+        uint32_t type = pass == 0 ? R_X86_64_JUMP_SLOT : R_X86_64_GLOB_DAT;
+        for (size_t r = 0; r < gi->nrefs; r++) {
+            if (gi->refs[r].type != type) continue;
+            size_t i = gi->refs[r].hash & gi->mask;
+            while (gi->by_name[i]) i = (i + 1) & gi->mask;
+            gi->by_name[i] = r + 1;
+        }
+    }
+    return 0;
+}
+
+void got_index_free(got_index_t *gi) {
+    free(gi->refs);
+    free(gi->by_name);
+    memset(gi, 0, sizeof(*gi));
+}
+
+const char *got_ref_name(got_index_t *gi, const got_ref_t *ref) {
+    return &gi->info->strtab[gi->info->symtab[ref->symidx].st_name];
+}
+
+/* Name → GOT slot; the indexed counterpart of find_got_entry() */
+const got_ref_t *got_index_find(got_index_t *gi, const char *name) {
+    if (!gi->by_name) return NULL;
+
+    uint32_t hash = gnu_hash(name);
+    for (size_t i = hash & gi->mask; gi->by_name[i]; i = (i + 1) & gi->mask) {
+        const got_ref_t *ref = &gi->refs[gi->by_name[i] - 1];
+        if (ref->hash == hash && strcmp(got_ref_name(gi, ref), name) == 0) return ref;
+    }
+    return NULL;
+}
+
+/* GOT slot address → the relocation (and so the symbol) that fills it */
+const got_ref_t *got_index_slot(got_index_t *gi, const void *slot) {
+    got_ref_t key = { .slot = (ElfW(Addr) *)slot };
+    return bsearch(&key, gi->refs, gi->nrefs, sizeof(*gi->refs), cmp_got_ref);
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * FIND R_DEBUG
  * ═══════════════════════════════════════════════════════════════════════════ */
@@ -184,6 +462,306 @@ struct link_map *find_library(struct r_debug *debug, const char *name) {
     return NULL;
 }
 
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BATCH RESOLUTION ACROSS THE LINK_MAP
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    const char *name;
+    const char *version;        /* NULL: default version */
+    uint32_t gnu_hash;
+    unsigned long elf_hash;
+    unsigned long ver_hash;
+    void *addr;                 /* NULL until resolved */
+    struct link_map *object;    /* defining object */
+} sym_request_t;
+
+/*
+ * Resolve n names in one sweep over the link_map, in load order (the
+ * global lookup scope): both hashes of each name are computed once, and
+ * each object's dynamic section is parsed once for the whole batch. The
+ * first object defining a name wins, as in ld.so. Returns the number of
+ * names resolved.
+ */
+size_t resolve_batch(struct r_debug *debug, sym_request_t *reqs, size_t n) {
+    size_t pending = n;
+
+    for (size_t i = 0; i < n; i++) {
+        reqs[i].gnu_hash = gnu_hash(reqs[i].name);
+        reqs[i].elf_hash = elf_hash(reqs[i].name);
+        reqs[i].ver_hash = reqs[i].version ? elf_hash(reqs[i].version) : 0;
+        reqs[i].addr = NULL;
+        reqs[i].object = NULL;
+    }
+
+    for (struct link_map *lm = debug->r_map; lm != NULL && pending; lm = lm->l_next) {
+        dyn_info_t info;
+        if (parse_dynamic_section(lm, &info) < 0) continue;
+        if (!info.gnu_hash && !info.hash) continue;
+
+        for (size_t i = 0; i < n; i++) {
+            if (reqs[i].addr) continue;
+
+            int want = version_index(&info, reqs[i].version, reqs[i].ver_hash);
+            if (want == VER_WANT_NONE) continue;
+
+            void *addr = info.gnu_hash ? resolve_gnu(&info, reqs[i].name, reqs[i].gnu_hash, want)
+                                       : resolve_sysv(&info, reqs[i].name, reqs[i].elf_hash, want);
+            if (addr) {
+                reqs[i].addr = addr;
+                reqs[i].object = lm;
+                pending--;
+            }
+        }
+    }
+
+    return n - pending;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * GLOBAL SYMBOL INDEX
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/*
+ * One open-addressing table over every object in r_debug->r_map, keyed
+ * by GNU hash, so that repeated lookups in a long-running monitor cost
+ * O(1) instead of a chain walk per object.
+ *
+ * The index follows the link_map incrementally. sym_index_sync() only
+ * runs while r_state is RT_CONSISTENT, the state analyze_r_debug_state()
+ * reports once ld.so has finished a dlopen/dlclose. It indexes objects
+ * that appeared since the last sync and marks those that vanished as
+ * dead. Dead entries are skipped by lookups and dropped when the table is
+ * next rehashed, so a sync after one dlopen costs one object, not all.
+ *
+ * Only default-version definitions are indexed (what a bare name
+ * resolves to). Several objects may define the same name: all
+ * definitions are kept and the one earliest in the link_map wins, as in
+ * the global scope.
+ * Entries point into the objects' string tables, so call
+ * sym_index_sync() after every dlclose before looking anything up.
+ */
+
+typedef struct {
+    const char *name;           /* NULL = empty slot */
+    uint32_t hash;              /* GNU hash */
+    uint32_t object;            /* index into sym_index_t.objects */
+    void *addr;
+} sym_slot_t;
+
+typedef struct {
+    struct link_map *lm;        /* identity: the link_map node ... */
+    ElfW(Addr) l_addr;          /* ... and what it described when indexed */
+    ElfW(Dyn) *l_ld;
+    uint32_t order;             /* position in r_map at the last sync */
+    uint32_t nsyms;             /* entries it owns in the table */
+    int live;                   /* seen by the sync in progress */
+} indexed_object_t;
+
+typedef struct {
+    struct r_debug *debug;
+    sym_slot_t *slots;
+    size_t mask;                /* capacity - 1 (power of two) */
+    size_t used;                /* occupied slots, dead entries included */
+    size_t dead;                /* entries owned by objects no longer loaded */
+    indexed_object_t *objects;
+    size_t nobjects;
+    size_t objects_cap;
+} sym_index_t;
+
+static void index_insert(sym_index_t *idx, const char *name, uint32_t hash,
+                         uint32_t object, void *addr) {
+    size_t i = hash & idx->mask;
+
+    for (; idx->slots[i].name; i = (i + 1) & idx->mask) {
+        sym_slot_t *slot = &idx->slots[i];
+        /* Duplicate default definitions in one object: keep the first, as resolve_symbol() does */
+        if (slot->hash == hash && slot->object == object && strcmp(slot->name, name) == 0) return;
+    }
+    idx->slots[i] = (sym_slot_t){ name, hash, object, addr };
+    idx->used++;
+    idx->objects[object].nsyms++;
+}
+
+/* Rehash into a table with room for extra more entries; drops dead objects */
+static int index_rehash(sym_index_t *idx, size_t extra) {
+    size_t live = idx->used - idx->dead;
+    size_t cap = 64;
+    while (cap < 2 * (live + extra)) cap *= 2;
+
+    sym_slot_t *old = idx->slots;
+    size_t old_cap = old ? idx->mask + 1 : 0;
+    sym_slot_t *slots = calloc(cap, sizeof(*slots));
+    if (!slots) return -1;
+
+    /* Renumber the objects still loaded (lm is cleared when one goes away) */
+    uint32_t *remap = malloc((idx->nobjects + 1) * sizeof(*remap));
+    if (!remap) {
+        free(slots);
+        return -1;
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < idx->nobjects; i++) {
+        if (idx->objects[i].lm) {
+            remap[i] = n;
+            idx->objects[n] = idx->objects[i];
+            idx->objects[n].nsyms = 0;
+            n++;
+        } else {
+            remap[i] = UINT32_MAX;
+        }
+    }
+    idx->nobjects = n;
+
+    idx->slots = slots;
+    idx->mask = cap - 1;
+    idx->used = 0;
+    idx->dead = 0;
+    for (size_t i = 0; i < old_cap; i++) {
+        sym_slot_t *slot = &old[i];
+        if (!slot->name || remap[slot->object] == UINT32_MAX) continue;
+        index_insert(idx, slot->name, slot->hash, remap[slot->object], slot->addr);
+    }
+
+    free(remap);
+    free(old);
+    return 0;
+}
+
+/* Number of entries in the dynamic symbol table, from whichever hash table exists */
+static uint32_t dynsym_count(dyn_info_t *info) {
+    if (info->hash) return info->hash[1];
+
+    const uint32_t *ht = info->gnu_hash;
+    uint32_t nbuckets = ht[0], symoffset = ht[1], bloom_size = ht[2];
+    const uint32_t *buckets = (const uint32_t *)((const ElfW(Addr) *)&ht[4] + bloom_size);
+    const uint32_t *chain = &buckets[nbuckets];
+    uint32_t last = 0;
+
+    for (uint32_t b = 0; b < nbuckets; b++)
+        if (buckets[b] > last) last = buckets[b];
+    if (last < symoffset) return symoffset;
+    while (!(chain[last - symoffset] & 1)) last++;
+    return last + 1;
+}
+
+static int index_object(sym_index_t *idx, struct link_map *lm, uint32_t order) {
+    dyn_info_t info;
+    if (parse_dynamic_section(lm, &info) < 0 || (!info.gnu_hash && !info.hash)) {
+        info.symtab = NULL;
+    }
+
+    if (idx->nobjects == idx->objects_cap) {
+        size_t cap = idx->objects_cap ? idx->objects_cap * 2 : 32;
+        indexed_object_t *objects = realloc(idx->objects, cap * sizeof(*objects));
+        if (!objects) return -1;
+        idx->objects = objects;
+        idx->objects_cap = cap;
+    }
+    uint32_t object = idx->nobjects++;
+    idx->objects[object] = (indexed_object_t){ lm, lm->l_addr, lm->l_ld, order, 0, 1 };
+    if (!info.symtab) return 0;
+
+    uint32_t nsyms = dynsym_count(&info);
+    if ((idx->used + nsyms) * 2 > idx->mask + 1 || !idx->slots) {
+        if (index_rehash(idx, nsyms) < 0) return -1;
+        object = idx->nobjects - 1;
+    }
+
+    for (uint32_t i = 1; i < nsyms; i++) {
+        ElfW(Sym) *sym = &info.symtab[i];
+        if (sym->st_value == 0 || sym->st_shndx == SHN_UNDEF) continue;
+        if (ELF64_ST_BIND(sym->st_info) == STB_LOCAL) continue;
+        if (!version_matches(&info, i, VER_WANT_DEFAULT)) continue;
+
+        const char *name = &info.strtab[sym->st_name];
+        index_insert(idx, name, gnu_hash(name), object, (void *)(info.base + sym->st_value));
+    }
+    return 0;
+}
+
+void sym_index_init(sym_index_t *idx, struct r_debug *debug) {
+    memset(idx, 0, sizeof(*idx));
+    idx->debug = debug;
+}
+
+void sym_index_free(sym_index_t *idx) {
+    free(idx->slots);
+    free(idx->objects);
+    memset(idx, 0, sizeof(*idx));
+}
+
+/*
+ * Bring the index up to date with the link_map. Returns the number of
+ * objects indexed or dropped (0: nothing changed), or -1 if the link_map
+ * is mid-update (r_state != RT_CONSISTENT) or memory ran out; the index
+ * is then left as it was.
+ */
+int sym_index_sync(sym_index_t *idx) {
+    if (idx->debug->r_state != RT_CONSISTENT) return -1;
+
+    for (size_t i = 0; i < idx->nobjects; i++) idx->objects[i].live = 0;
+
+    int changed = 0;
+    uint32_t order = 0;
+    size_t hint = 0;
+
+    for (struct link_map *lm = idx->debug->r_map; lm != NULL; lm = lm->l_next, order++) {
+        /* Objects usually keep their relative order, so start where the last match was */
+        size_t found = idx->nobjects;
+        for (size_t k = 0; k < idx->nobjects; k++) {
+            size_t i = (hint + k) % idx->nobjects;
+            indexed_object_t *o = &idx->objects[i];
+            if (o->lm == lm && o->l_addr == lm->l_addr && o->l_ld == lm->l_ld) {
+                found = i;
+                break;
+            }
+        }
+
+        if (found < idx->nobjects) {
+            idx->objects[found].live = 1;
+            idx->objects[found].order = order;
+            hint = found + 1;
+        } else {
+            if (index_object(idx, lm, order) < 0) return -1;
+            changed++;
+        }
+    }
+
+    /* Whatever was not seen has been unloaded: its entries go dead */
+    for (size_t i = 0; i < idx->nobjects; i++) {
+        indexed_object_t *o = &idx->objects[i];
+        if (!o->live && o->lm) {
+            idx->dead += o->nsyms;
+            o->lm = NULL;
+            changed++;
+        }
+    }
+    if (idx->dead > (idx->used - idx->dead) && index_rehash(idx, 0) < 0) return -1;
+
+    return changed;
+}
+
+/* O(1) expected; the earliest object in the link_map that defines name wins */
+void *sym_index_lookup(sym_index_t *idx, const char *name, struct link_map **object) {
+    if (!idx->slots) return NULL;
+
+    uint32_t hash = gnu_hash(name);
+    sym_slot_t *best = NULL;
+
+    for (size_t i = hash & idx->mask; idx->slots[i].name; i = (i + 1) & idx->mask) {
+        sym_slot_t *slot = &idx->slots[i];
+        indexed_object_t *o = &idx->objects[slot->object];
+
+        if (slot->hash != hash || !o->lm || strcmp(slot->name, name) != 0) continue;
+        if (!best || o->order < idx->objects[best->object].order) best = slot;
+    }
+
+    if (!best) return NULL;
+    if (object) *object = idx->objects[best->object].lm;
+    return best->addr;
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * DEMONSTRATION
  * ═══════════════════════════════════════════════════════════════════════════ */
@@ -209,7 +787,7 @@ void demonstrate_resolution(void) {
     }
 
     printf("[*] Found libc: %s\n", libc->l_name);
-    printf("[*] Base address: " GREEN "0x%016lx" RESET "\n\n", libc->l_addr);
+    printf("[*] Base address: " GREEN "0x%016lx" RESET "\n", libc->l_addr);
 
     /* Parse libc's dynamic section */
     dyn_info_t libc_info;
@@ -218,6 +796,15 @@ void demonstrate_resolution(void) {
         return;
     }
 
+    if (libc_info.gnu_hash) {
+        printf("[*] Symbol table: DT_GNU_HASH (%u buckets, %u bloom words)\n\n",
+               libc_info.gnu_hash[0], libc_info.gnu_hash[2]);
+    } else if (libc_info.hash) {
+        printf("[*] Symbol table: DT_HASH (%u buckets)\n\n", libc_info.hash[0]);
+    } else {
+        printf(RED "[!] libc has no DT_GNU_HASH or DT_HASH table\n\n" RESET);
+    }
+
     printf(CYAN "───────────────────────────────────────────────────────────────────\n" RESET);
     printf(CYAN "  Resolving symbols WITHOUT dlsym()\n" RESET);
     printf(CYAN "───────────────────────────────────────────────────────────────────\n" RESET);
@@ -241,6 +828,101 @@ void demonstrate_resolution(void) {
         }
     }
 
+    /* Same name, several definitions: the version picks one */
+    printf("\n");
+    const char *versioned[][2] = {
+        {"realpath", NULL}, {"realpath", "GLIBC_2.2.5"}, {"realpath", "GLIBC_2.3"},
+        {"memcpy", NULL}, {"memcpy", "GLIBC_2.2.5"}, {"memcpy", "GLIBC_2.14"},
+        {"system", "GLIBC_9.9"},
+    };
+    int num_versioned = sizeof(versioned) / sizeof(versioned[0]);
+
+    printf("  %-24s  %-20s  %-20s\n", "Symbol@Version", "Resolved Address", "Offset from base");
+    printf("  %-24s  %-20s  %-20s\n", "──────────────", "────────────────", "────────────────");
+
+    for (int i = 0; i < num_versioned; i++) {
+        char label[64];
+        snprintf(label, sizeof(label), "%s@%s", versioned[i][0],
+                 versioned[i][1] ? versioned[i][1] : "(default)");
+        void *addr = resolve_symbol_version(&libc_info, versioned[i][0], versioned[i][1]);
+        if (addr) {
+            printf("  %-24s  " GREEN "0x%016lx" RESET "  " YELLOW "0x%08lx" RESET "\n",
+                   label, (uintptr_t)addr, (uintptr_t)addr - libc_info.base);
+        } else {
+            printf("  %-24s  " RED "NOT FOUND" RESET "\n", label);
+        }
+    }
+
+    /* Resolve a batch against every loaded object at once */
+    printf("\n");
+    printf(CYAN "───────────────────────────────────────────────────────────────────\n" RESET);
+    printf(CYAN "  Batch resolution across the whole link_map\n" RESET);
+    printf(CYAN "───────────────────────────────────────────────────────────────────\n" RESET);
+    printf("\n");
+
+    sym_request_t batch[] = {
+        { .name = "system" }, { .name = "printf" }, { .name = "dlopen" },
+        { .name = "_dl_debug_state" }, { .name = "__libc_start_main" },
+        { .name = "no_such_symbol" },
+    };
+    size_t num_batch = sizeof(batch) / sizeof(batch[0]);
+    size_t resolved = resolve_batch(debug, batch, num_batch);
+
+    printf("  %-18s  %-20s  %s\n", "Symbol", "Resolved Address", "Defined in");
+    printf("  %-18s  %-20s  %s\n", "──────", "────────────────", "──────────");
+
+    for (size_t i = 0; i < num_batch; i++) {
+        if (batch[i].addr) {
+            const char *obj = batch[i].object->l_name;
+            printf("  %-18s  " GREEN "0x%016lx" RESET "  %s\n",
+                   batch[i].name, (uintptr_t)batch[i].addr, obj && *obj ? obj : "(main executable)");
+        } else {
+            printf("  %-18s  " RED "NOT FOUND" RESET "\n", batch[i].name);
+        }
+    }
+    printf("\n  %zu of %zu resolved in one pass\n", resolved, num_batch);
+
+    /* Global index, kept current across dlopen/dlclose */
+    printf("\n");
+    printf(CYAN "───────────────────────────────────────────────────────────────────\n" RESET);
+    printf(CYAN "  Global symbol index (follows dlopen/dlclose via r_state)\n" RESET);
+    printf(CYAN "───────────────────────────────────────────────────────────────────\n" RESET);
+    printf("\n");
+
+    sym_index_t index;
+    sym_index_init(&index, debug);
+    int changed = sym_index_sync(&index);
+    printf("  Initial sync:       %d objects, %zu symbols indexed\n", changed, index.used);
+
+    const int rounds = 100000;
+    struct timespec t0, t1, t2;
+    sym_request_t one = { .name = "system" };
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < rounds; i++) sym_index_lookup(&index, "system", NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (int i = 0; i < rounds; i++) resolve_batch(debug, &one, 1);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    printf("  Lookup 'system':    %.0f ns indexed, %.0f ns walking the link_map\n",
+           ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / rounds,
+           ((t2.tv_sec - t1.tv_sec) * 1e9 + (t2.tv_nsec - t1.tv_nsec)) / rounds);
+
+    struct link_map *owner = NULL;
+    printf("  'cos' before:       %s\n", sym_index_lookup(&index, "cos", NULL) ? "found" : "not loaded");
+
+    void *libm = dlopen("libm.so.6", RTLD_NOW | RTLD_LOCAL);
+    if (libm) {
+        changed = sym_index_sync(&index);
+        void *cos_addr = sym_index_lookup(&index, "cos", &owner);
+        printf("  After dlopen(libm): %d object(s) re-indexed, 'cos' = " GREEN "0x%016lx" RESET " in %s\n",
+               changed, (uintptr_t)cos_addr, owner ? owner->l_name : "?");
+
+        dlclose(libm);
+        changed = sym_index_sync(&index);
+        printf("  After dlclose:      %d object(s) dropped, 'cos' %s\n", changed,
+               sym_index_lookup(&index, "cos", NULL) ? "still found" : "gone");
+    }
+    sym_index_free(&index);
+
     /* Find main executable */
     printf("\n");
     printf(CYAN "───────────────────────────────────────────────────────────────────\n" RESET);
@@ -251,23 +933,42 @@ void demonstrate_resolution(void) {
     struct link_map *main_exe = debug->r_map;
     dyn_info_t main_info;
 
-    if (parse_dynamic_section(main_exe, &main_info) == 0) {
+    got_index_t main_got;
+    if (parse_dynamic_section(main_exe, &main_info) == 0 && got_index_build(&main_got, &main_info) == 0) {
         const char *got_targets[] = {"puts", "printf", "malloc", "free"};
         int num_got = sizeof(got_targets) / sizeof(got_targets[0]);
 
-        printf("  %-12s  %-20s  %-20s\n", "Function", "GOT Entry Address", "Current Value");
-        printf("  %-12s  %-20s  %-20s\n", "────────", "─────────────────", "─────────────");
+        printf("  %-12s  %-20s  %-20s  %s\n", "Function", "GOT Entry Address", "Current Value", "Kind");
+        printf("  %-12s  %-20s  %-20s  %s\n", "────────", "─────────────────", "─────────────", "────");
 
         for (int i = 0; i < num_got; i++) {
-            void *got = find_got_entry(&main_info, got_targets[i]);
-            if (got) {
-                uintptr_t value = *(uintptr_t *)got;
-                printf("  %-12s  " CYAN "0x%016lx" RESET "  " GREEN "0x%016lx" RESET "\n",
-                       got_targets[i], (uintptr_t)got, value);
+            const got_ref_t *ref = got_index_find(&main_got, got_targets[i]);
+            if (ref) {
+                uintptr_t value = *ref->slot;
+                printf("  %-12s  " CYAN "0x%016lx" RESET "  " GREEN "0x%016lx" RESET "  %s\n",
+                       got_targets[i], (uintptr_t)ref->slot, value,
+                       ref->type == R_X86_64_JUMP_SLOT ? "JUMP_SLOT" : "GLOB_DAT");
             } else {
                 printf("  %-12s  " RED "NOT FOUND" RESET "\n", got_targets[i]);
             }
         }
+        got_index_free(&main_got);
+    }
+
+    /* Every GOT slot of libc, both directions, from one index build */
+    got_index_t libc_got;
+    if (got_index_build(&libc_got, &libc_info) == 0) {
+        size_t roundtrip = 0;
+        for (size_t i = 0; i < libc_got.nrefs; i++) {
+            const got_ref_t *ref = &libc_got.refs[i];
+            const got_ref_t *by_slot = got_index_slot(&libc_got, ref->slot);
+            const got_ref_t *by_name = got_index_find(&libc_got, got_ref_name(&libc_got, ref));
+            if (by_slot == ref && by_name && by_name->symidx == ref->symidx) roundtrip++;
+        }
+        printf("\n  libc GOT: %zu symbol slots (%zu JUMP_SLOT, %zu GLOB_DAT), "
+               "%zu mapped slot ↔ name\n", libc_got.nrefs, libc_got.njump_slot,
+               libc_got.nrefs - libc_got.njump_slot, roundtrip);
+        got_index_free(&libc_got);
     }
 
     printf("\n");
@@ -0,0 +1,673 @@
+/*
+ * dep_graph.c - Transitive DT_NEEDED dependency graph
+ *
+ * See dep_graph.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "dep_graph.h"
+#include "elf_view.h"
+#include "fs_walk.h"
+
+/*
+ * Nodes live in fixed-size chunks that never move, so a worker can read
+ * a node it was handed without holding the lock while others add nodes.
+ */
+#define CHUNK_BITS      12
+#define CHUNK_SIZE      (1u << CHUNK_BITS)
+#define MAX_CHUNKS      4096            /* 16M nodes */
+#define MAX_THREADS     256
+
+typedef struct {
+    dg_node_t node;
+    uint32_t *adj;                      /* written only by the worker parsing this node */
+    uint8_t  *adj_source;
+    uint32_t  nadj;
+    uint32_t  cap;
+} build_node_t;
+
+typedef struct key_entry {
+    struct key_entry *next;
+    uint64_t          hash;
+    uint32_t          id;
+    char              key[];
+} key_entry_t;
+
+typedef struct {
+    const dep_graph_opts_t *opts;
+
+    pthread_mutex_t lock;
+    build_node_t   *chunks[MAX_CHUNKS];
+    uint32_t        nnodes;
+
+    /* "P<path>", "I<dev>:<ino>" and "M<soname>" → node id */
+    key_entry_t   **buckets;
+    size_t          nbuckets;
+    size_t          nkeys;
+
+    /* Current and next BFS level */
+    const uint32_t *frontier;
+    size_t          nfrontier;
+    size_t          cursor;
+    uint32_t       *next;
+    size_t          nnext;
+    size_t          capnext;
+    uint32_t        depth;
+
+    unsigned long   parsed;
+    int             oom;
+} builder_t;
+
+static build_node_t *node_at(builder_t *b, uint32_t id) {
+    return &b->chunks[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * NODE TABLE (caller holds b->lock)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static uint64_t key_hash(const char *s) {
+    /* FNV-1a */
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*s) {
+        h = (h ^ (unsigned char)*s++) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static key_entry_t *key_entry(builder_t *b, const char *key) {
+    if (!b->nbuckets) return NULL;
+    uint64_t hash = key_hash(key);
+    for (key_entry_t *e = b->buckets[hash & (b->nbuckets - 1)]; e; e = e->next) {
+        if (e->hash == hash && strcmp(e->key, key) == 0) return e;
+    }
+    return NULL;
+}
+
+static int key_find(builder_t *b, const char *key, uint32_t *id) {
+    key_entry_t *e = key_entry(b, key);
+    if (e) *id = e->id;
+    return e != NULL;
+}
+
+static void key_add(builder_t *b, const char *key, uint32_t id) {
+    if (b->nkeys >= b->nbuckets) {
+        size_t nb = b->nbuckets ? b->nbuckets * 2 : 1024;
+        key_entry_t **buckets = calloc(nb, sizeof(*buckets));
+        if (buckets) {
+            for (size_t i = 0; i < b->nbuckets; i++) {
+                key_entry_t *e = b->buckets[i];
+                while (e) {
+                    key_entry_t *next = e->next;
+                    e->next = buckets[e->hash & (nb - 1)];
+                    buckets[e->hash & (nb - 1)] = e;
+                    e = next;
+                }
+            }
+            free(b->buckets);
+            b->buckets = buckets;
+            b->nbuckets = nb;
+        }
+    }
+
+    size_t len = strlen(key) + 1;
+    key_entry_t *e = b->nbuckets ? malloc(sizeof(*e) + len) : NULL;
+    if (!e) {
+        b->oom = 1;
+        return;
+    }
+    e->hash = key_hash(key);
+    e->id = id;
+    memcpy(e->key, key, len);
+    e->next = b->buckets[e->hash & (b->nbuckets - 1)];
+    b->buckets[e->hash & (b->nbuckets - 1)] = e;
+    b->nkeys++;
+}
+
+static int new_node(builder_t *b, const char *path, const char *soname,
+                    uint32_t flags, uint32_t *id) {
+    uint32_t n = b->nnodes;
+    if ((n >> CHUNK_BITS) >= MAX_CHUNKS) {
+        b->oom = 1;
+        return -1;
+    }
+    build_node_t **chunk = &b->chunks[n >> CHUNK_BITS];
+    if (!*chunk && !(*chunk = calloc(CHUNK_SIZE, sizeof(build_node_t)))) {
+        b->oom = 1;
+        return -1;
+    }
+
+    dg_node_t *node = &node_at(b, n)->node;
+    node->path = strdup(path);
+    node->soname = soname ? strdup(soname) : NULL;
+    node->flags = flags;
+    node->depth = b->depth + ((flags & DG_ROOT) ? 0 : 1);
+    if (!node->path) {
+        b->oom = 1;
+        return -1;
+    }
+
+    b->nnodes++;
+    *id = n;
+    return 0;
+}
+
+static void push_next(builder_t *b, uint32_t id) {
+    if (b->nnext == b->capnext) {
+        size_t cap = b->capnext ? b->capnext * 2 : 256;
+        uint32_t *next = realloc(b->next, cap * sizeof(*next));
+        if (!next) {
+            b->oom = 1;
+            return;
+        }
+        b->next = next;
+        b->capnext = cap;
+    }
+    b->next[b->nnext++] = id;
+}
+
+/*
+ * Node for a file that exists. Known paths are a single lookup; a new
+ * path costs one stat() (done unlocked) to catch another name for a
+ * file we already have. New nodes are queued for the next level.
+ * Returns 0 and *id, or -1.
+ */
+static int intern_file(builder_t *b, const char *path, const struct stat *known,
+                       const char *soname, uint32_t flags, uint32_t *id) {
+    char pkey[PATH_MAX + 2], ikey[64];
+    snprintf(pkey, sizeof(pkey), "P%s", path);
+
+    pthread_mutex_lock(&b->lock);
+    int found = key_find(b, pkey, id);
+    pthread_mutex_unlock(&b->lock);
+    if (found) return 0;
+
+    struct stat st;
+    if (known) {
+        st = *known;
+    } else if (stat(path, &st) < 0) {
+        return -1;
+    }
+    snprintf(ikey, sizeof(ikey), "I%lx:%lx", (unsigned long)st.st_dev,
+             (unsigned long)st.st_ino);
+
+    int rc = 0;
+    pthread_mutex_lock(&b->lock);
+    if (!key_find(b, pkey, id)) {
+        if (key_find(b, ikey, id)) {
+            key_add(b, pkey, *id);              /* another name for a known file */
+        } else if (new_node(b, path, soname, flags, id) == 0) {
+            key_add(b, pkey, *id);
+            key_add(b, ikey, *id);
+            push_next(b, *id);
+        } else {
+            rc = -1;
+        }
+    }
+    pthread_mutex_unlock(&b->lock);
+    return rc;
+}
+
+static int intern_missing(builder_t *b, const char *soname, uint32_t *id) {
+    char key[PATH_MAX + 2];
+    snprintf(key, sizeof(key), "M%s", soname);
+
+    int rc = 0;
+    pthread_mutex_lock(&b->lock);
+    if (!key_find(b, key, id)) {
+        if (new_node(b, soname, soname, DG_MISSING, id) == 0) {
+            key_add(b, key, *id);
+        } else {
+            rc = -1;
+        }
+    }
+    pthread_mutex_unlock(&b->lock);
+    return rc;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BFS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void add_edge(build_node_t *bn, uint32_t to, ldso_source_t source) {
+    for (uint32_t i = 0; i < bn->nadj; i++) {
+        if (bn->adj[i] == to) return;       /* same library needed twice */
+    }
+    if (bn->nadj == bn->cap) {
+        uint32_t cap = bn->cap ? bn->cap * 2 : 8;
+        uint32_t *adj = realloc(bn->adj, cap * sizeof(*adj));
+        if (!adj) return;
+        bn->adj = adj;
+        uint8_t *src = realloc(bn->adj_source, cap);
+        if (!src) return;
+        bn->adj_source = src;
+        bn->cap = cap;
+    }
+    bn->adj[bn->nadj] = to;
+    bn->adj_source[bn->nadj] = (uint8_t)source;
+    bn->nadj++;
+}
+
+static void process_node(builder_t *b, uint32_t id) {
+    build_node_t *bn = node_at(b, id);
+    dg_node_t *n = &bn->node;
+    elf_view_t view;
+    ldso_object_t obj;
+
+    if (n->flags & DG_MISSING) return;
+
+    if (elf_view_open(&view, n->path) < 0) {
+        n->flags |= DG_UNREADABLE;
+        return;
+    }
+    __atomic_fetch_add(&b->parsed, 1, __ATOMIC_RELAXED);
+
+    if (!view.dynamic || !view.dynstr) {
+        n->flags |= DG_STATIC;
+        elf_view_close(&view);
+        return;
+    }
+
+    const char *soname;
+    if (elf_view_has(&view, DT_SONAME) &&
+        (soname = elf_view_dynstr(&view, elf_view_dyn(&view, DT_SONAME)))) {
+        char *copy = strdup(soname);
+        if (copy) {
+            free(n->soname);
+            n->soname = copy;
+        }
+    }
+
+    ldso_object_from_view(&obj, &view, NULL);
+
+    for (size_t i = 0; i < view.dyn_count; i++) {
+        if (view.dynamic[i].d_tag != DT_NEEDED) continue;
+        const char *name = elf_view_dynstr(&view, view.dynamic[i].d_un.d_val);
+        if (!name) continue;
+
+        ldso_result_t res;
+        uint32_t to;
+        if (ldso_resolve(b->opts->ldso, &obj, name, &res) == 0 &&
+            intern_file(b, res.path, NULL, name, 0, &to) == 0) {
+            add_edge(bn, to, res.source);
+        } else if (intern_missing(b, name, &to) == 0) {
+            add_edge(bn, to, LDSO_NOT_FOUND);
+        }
+    }
+
+    ldso_object_release(&obj);
+    /* Cut short under us: what was read past the new end is not the file's */
+    if (elf_view_truncated(&view)) n->flags |= DG_UNREADABLE;
+    elf_view_close(&view);
+}
+
+static void *level_worker(void *arg) {
+    builder_t *b = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&b->cursor, 1, __ATOMIC_RELAXED);
+        if (i >= b->nfrontier) break;
+        process_node(b, b->frontier[i]);
+    }
+    return NULL;
+}
+
+static void run_level(builder_t *b) {
+    int nthreads = b->opts->nthreads > 0 ? b->opts->nthreads : fs_walk_default_threads();
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+    if ((size_t)nthreads > b->nfrontier) nthreads = (int)b->nfrontier;
+
+    pthread_t tids[MAX_THREADS];
+    int started = 0;
+    b->cursor = 0;
+    for (int i = 0; i < nthreads; i++) {
+        if (pthread_create(&tids[started], NULL, level_worker, b) == 0) started++;
+    }
+    if (started == 0) {
+        level_worker(b);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * ROOTS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void add_root(const char *path, int fd, void *arg) {
+    builder_t *b = arg;
+    struct stat st;
+    uint32_t id;
+
+    if (fstat(fd, &st) == 0) {
+        intern_file(b, path, &st, NULL, DG_ROOT, &id);
+    }
+}
+
+static void collect_roots(builder_t *b, dep_graph_t *g) {
+    const dep_graph_opts_t *opts = b->opts;
+    const char **dirs = calloc(opts->nroots ? opts->nroots : 1, sizeof(*dirs));
+    int ndirs = 0;
+
+    /* Plain files are roots as given; directories are walked for ELF files */
+    for (int i = 0; i < opts->nroots; i++) {
+        struct stat st;
+        if (stat(opts->roots[i], &st) < 0) {
+            g->walk_errors++;
+        } else if (S_ISDIR(st.st_mode)) {
+            if (dirs) dirs[ndirs++] = opts->roots[i];
+        } else {
+            uint32_t id;
+            if (intern_file(b, opts->roots[i], &st, NULL, DG_ROOT, &id) < 0) {
+                g->walk_errors++;
+            }
+        }
+    }
+
+    if (ndirs) {
+        fs_walk_opts_t wo = {
+            .roots = dirs,
+            .nroots = ndirs,
+            .nthreads = opts->nthreads,
+            .elf_only = 1,
+            .fn = add_root,
+            .arg = b,
+        };
+        fs_walk_stats_t ws;
+        fs_walk(&wo, &ws);
+        g->walk_errors += ws.errors;
+    }
+    free(dirs);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * CSR PACKING
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static int cmp_node_path(const void *a, const void *b, void *arg) {
+    builder_t *bld = arg;
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return strcmp(node_at(bld, x)->node.path, node_at(bld, y)->node.path);
+}
+
+#define EDGE_UNSEEN     UINT32_MAX          /* no root reaches the edge yet */
+#define EDGE_MISSING    (UINT32_MAX - 1)    /* some root cannot satisfy it */
+
+/*
+ * ld.so reuses an object already loaded into the same process whose
+ * soname matches before it searches at all, so a soname that does not
+ * resolve from its own loader (libsystemd-core needing
+ * libsystemd-shared, found only through the executable's RUNPATH) is
+ * satisfied when the process has loaded a node with that soname.
+ *
+ * That holds per process, not per fleet: an edge u → MISSING S is
+ * redirected to the node with soname S only if every root whose load
+ * closure holds u also holds that node. One BFS per root, over the
+ * resolved edges, settles each edge; to[base[u] + e] is its target in
+ * the end, or EDGE_MISSING where some root leaves S to the search and
+ * the hijack exposure stands. Such a MISSING node gets the node of
+ * that soname other roots load, if any, in *elsewhere.
+ *
+ * order holds every node sorted by path, so the first match wins the
+ * same way whatever order the threads found the nodes in.
+ */
+static int alias_loaded(builder_t *b, const uint32_t *order, const uint32_t *base,
+                        uint32_t *to, uint32_t *elsewhere) {
+    uint32_t n = b->nnodes;
+    uint32_t *same = malloc((n ? n : 1) * sizeof(*same));     /* next node of the soname */
+    uint32_t *mark = calloc(n ? n : 1, sizeof(*mark));
+    uint32_t *queue = malloc((n ? n : 1) * sizeof(*queue));
+    char key[PATH_MAX + 2];
+    uint32_t stamp = 0;
+
+    if (!same || !mark || !queue) {
+        free(same);
+        free(mark);
+        free(queue);
+        return -1;
+    }
+
+    /* "S<soname>" → the first node with it by path; same[] chains the rest */
+    for (uint32_t k = n; k-- > 0;) {
+        uint32_t i = order[k];
+        const dg_node_t *node = &node_at(b, i)->node;
+        key_entry_t *head;
+        same[i] = DG_NONE;
+        if ((node->flags & DG_MISSING) || !node->soname) continue;
+        snprintf(key, sizeof(key), "S%s", node->soname);
+        if ((head = key_entry(b, key)) != NULL) {
+            same[i] = head->id;
+            head->id = i;
+        } else {
+            key_add(b, key, i);
+        }
+    }
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t i = order[k], head;
+        const dg_node_t *node = &node_at(b, i)->node;
+        elsewhere[i] = DG_NONE;
+        if (!(node->flags & DG_MISSING)) continue;
+        snprintf(key, sizeof(key), "S%s", node->path);
+        if (key_find(b, key, &head)) elsewhere[i] = head;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        const build_node_t *bn = node_at(b, i);
+        for (uint32_t e = 0; e < bn->nadj; e++) {
+            int missing = node_at(b, bn->adj[e])->node.flags & DG_MISSING;
+            to[base[i] + e] = missing ? EDGE_UNSEEN : bn->adj[e];
+        }
+    }
+
+    for (uint32_t r = 0; r < n; r++) {
+        if (!(node_at(b, r)->node.flags & DG_ROOT)) continue;
+
+        uint32_t head = 0, tail = 0;
+        mark[r] = ++stamp;
+        queue[tail++] = r;
+        while (head < tail) {
+            const build_node_t *bn = node_at(b, queue[head++]);
+            for (uint32_t e = 0; e < bn->nadj; e++) {
+                uint32_t v = bn->adj[e];
+                if (mark[v] == stamp || (node_at(b, v)->node.flags & DG_MISSING)) continue;
+                mark[v] = stamp;
+                queue[tail++] = v;
+            }
+        }
+
+        for (uint32_t q = 0; q < tail; q++) {
+            uint32_t u = queue[q];
+            const build_node_t *bn = node_at(b, u);
+            for (uint32_t e = 0; e < bn->nadj; e++) {
+                uint32_t *t = &to[base[u] + e];
+                uint32_t x = elsewhere[bn->adj[e]];
+                if (*t == EDGE_MISSING || !(node_at(b, bn->adj[e])->node.flags & DG_MISSING)) continue;
+                while (x != DG_NONE && mark[x] != stamp) x = same[x];
+                *t = x == DG_NONE || (*t != EDGE_UNSEEN && *t != x) ? EDGE_MISSING : x;
+            }
+        }
+    }
+
+    free(same);
+    free(mark);
+    free(queue);
+    return b->oom ? -1 : 0;
+}
+
+static int pack(builder_t *b, dep_graph_t *g) {
+    uint32_t n = b->nnodes;
+    uint32_t *order = malloc((n ? n : 1) * sizeof(*order));
+    uint32_t *rank = malloc((n ? n : 1) * sizeof(*rank));
+    uint32_t *base = malloc(((size_t)n + 1) * sizeof(*base));
+    uint32_t *elsewhere = malloc((n ? n : 1) * sizeof(*elsewhere));
+    uint32_t *to = NULL;
+    int rc = -1;
+
+    g->nodes = calloc(n ? n : 1, sizeof(*g->nodes));
+    g->edge_off = calloc(n + 1, sizeof(*g->edge_off));
+    if (!order || !rank || !base || !elsewhere || !g->nodes || !g->edge_off) goto out;
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        order[i] = i;
+        base[i] = (uint32_t)total;
+        total += node_at(b, i)->nadj;
+    }
+    base[n] = (uint32_t)total;
+    qsort_r(order, n, sizeof(*order), cmp_node_path, b);
+
+    to = malloc((total ? total : 1) * sizeof(*to));
+    g->edges = malloc((total ? total : 1) * sizeof(*g->edges));
+    g->edge_source = malloc(total ? total : 1);
+    if (!to || !g->edges || !g->edge_source) goto out;
+    if (alias_loaded(b, order, base, to, elsewhere) < 0) goto out;
+
+    /* A MISSING node stays while some edge still ends on it; rank[] is UINT32_MAX otherwise */
+    for (uint32_t i = 0; i < n; i++) {
+        rank[i] = (node_at(b, i)->node.flags & DG_MISSING) ? UINT32_MAX : 0;
+    }
+    for (uint64_t e = 0; e < total; e++) {
+        if (to[e] == EDGE_MISSING || to[e] == EDGE_UNSEEN) to[e] = EDGE_MISSING;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        const build_node_t *bn = node_at(b, i);
+        for (uint32_t e = 0; e < bn->nadj; e++) {
+            if (to[base[i] + e] == EDGE_MISSING) rank[bn->adj[e]] = 0;
+        }
+    }
+    uint32_t kept = 0;
+    for (uint32_t k = 0; k < n; k++) {
+        if (rank[order[k]] == 0) rank[order[k]] = kept++;
+    }
+
+    uint32_t ne = 0;
+    for (uint32_t k = 0, i = 0; k < n; k++) {
+        build_node_t *bn = node_at(b, order[k]);
+        if (rank[order[k]] == UINT32_MAX) continue;
+        g->nodes[i] = bn->node;
+        g->nodes[i].elsewhere = elsewhere[order[k]] != DG_NONE ?
+                                rank[elsewhere[order[k]]] : DG_NONE;
+        bn->node.path = bn->node.soname = NULL;     /* moved */
+        g->edge_off[i] = ne;
+
+        for (uint32_t e = 0; e < bn->nadj; e++) {
+            uint32_t t = to[base[order[k]] + e];
+            uint32_t dst = rank[t == EDGE_MISSING ? bn->adj[e] : t];
+            int dup = 0;
+            for (uint32_t j = g->edge_off[i]; j < ne; j++) dup |= g->edges[j] == dst;
+            if (dup) continue;
+            g->edges[ne] = dst;
+            g->edge_source[ne] = t != EDGE_MISSING && t != bn->adj[e] ?
+                                 LDSO_LOADED : bn->adj_source[e];
+            ne++;
+        }
+        if (g->nodes[i].flags & DG_ROOT) g->nroots++;
+        i++;
+    }
+    g->edge_off[kept] = ne;
+
+    g->nnodes = kept;
+    g->nedges = ne;
+    rc = 0;
+
+out:
+    free(order);
+    free(rank);
+    free(base);
+    free(elsewhere);
+    free(to);
+    return rc;
+}
+
+static void builder_free(builder_t *b) {
+    for (uint32_t c = 0; c < MAX_CHUNKS && b->chunks[c]; c++) {
+        for (uint32_t i = 0; i < CHUNK_SIZE; i++) {
+            build_node_t *bn = &b->chunks[c][i];
+            free(bn->node.path);
+            free(bn->node.soname);
+            free(bn->adj);
+            free(bn->adj_source);
+        }
+        free(b->chunks[c]);
+    }
+    for (size_t i = 0; i < b->nbuckets; i++) {
+        key_entry_t *e = b->buckets[i];
+        while (e) {
+            key_entry_t *next = e->next;
+            free(e);
+            e = next;
+        }
+    }
+    free(b->buckets);
+    free(b->next);
+    pthread_mutex_destroy(&b->lock);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * PUBLIC API
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int dep_graph_build(dep_graph_t *g, const dep_graph_opts_t *opts) {
+    builder_t *b = calloc(1, sizeof(*b));
+    if (!b) return -1;
+
+    memset(g, 0, sizeof(*g));
+    b->opts = opts;
+    pthread_mutex_init(&b->lock, NULL);
+
+    /* Level 0: the roots; each level queues what it discovers into b->next */
+    collect_roots(b, g);
+
+    while (b->nnext && !b->oom) {
+        uint32_t *frontier = b->next;
+        b->frontier = frontier;
+        b->nfrontier = b->nnext;
+        b->next = NULL;
+        b->nnext = b->capnext = 0;
+
+        run_level(b);
+        free(frontier);
+        b->depth++;
+    }
+    g->levels = b->depth;
+    g->parsed = b->parsed;
+
+    int rc = b->oom ? -1 : pack(b, g);
+    builder_free(b);
+    free(b);
+    if (rc < 0) dep_graph_free(g);
+    return rc;
+}
+
+void dep_graph_free(dep_graph_t *g) {
+    for (uint32_t i = 0; g->nodes && i < g->nnodes; i++) {
+        free(g->nodes[i].path);
+        free(g->nodes[i].soname);
+    }
+    free(g->nodes);
+    free(g->edge_off);
+    free(g->edges);
+    free(g->edge_source);
+    memset(g, 0, sizeof(*g));
+}
+
+int64_t dep_graph_find(const dep_graph_t *g, const char *path) {
+    uint32_t lo = 0, hi = g->nnodes;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int c = strcmp(g->nodes[mid].path, path);
+        if (c == 0) return mid;
+        if (c < 0) lo = mid + 1; else hi = mid;
+    }
+    return -1;
+}
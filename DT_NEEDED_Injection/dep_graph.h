@@ -0,0 +1,91 @@
+/*
+ * dep_graph.h - Transitive DT_NEEDED dependency graph
+ *
+ * Builds the full "who loads what" graph for a set of binaries in one
+ * pass. Every root is an ELF file found under the given paths; every
+ * DT_NEEDED entry is resolved with the ld.so emulation (../common/ldso.h)
+ * and the library it lands on becomes a node of its own, which is parsed
+ * once no matter how many objects need it:
+ *
+ *   /usr/bin/a ──┐
+ *   /usr/bin/b ──┼──→ libfoo.so.1 ──→ libc.so.6
+ *   /usr/bin/c ──┘          └──────→ libbar.so.2 ──┘
+ *
+ * Nodes are deduplicated by (st_dev, st_ino), so /lib/x/libc.so.6 and
+ * /usr/lib/x/libc.so.6 on merged-/usr systems are one node. A soname
+ * that does not resolve becomes a MISSING node named after the soname,
+ * unless every root that loads the needing object also loads a node
+ * with that soname: ld.so would reuse that already-loaded object, and
+ * the edge goes there, marked LDSO_LOADED. A node with the soname that
+ * only other roots load does not count; the MISSING node names it as
+ * elsewhere.
+ *
+ * The walk is a level-synchronous parallel BFS: each level's frontier is
+ * shared by the worker threads, and newly discovered libraries form the
+ * next level. When done, nodes are sorted by path and the edges are
+ * packed into CSR form (edge_off/edges), so the result is identical
+ * whatever the thread count.
+ *
+ * A shared library's own DT_NEEDED entries are resolved in its own
+ * context (its DT_RPATH/DT_RUNPATH plus the global search path). RPATH
+ * inherited from whichever executable loaded it is not applied, because
+ * the node is shared by all of them.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef DEP_GRAPH_H
+#define DEP_GRAPH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ldso.h"
+
+#define DG_ROOT         0x01    /* named on the command line or found by the walk */
+#define DG_MISSING      0x02    /* soname did not resolve; path is the soname */
+#define DG_UNREADABLE   0x04    /* resolved, but could not be parsed */
+#define DG_STATIC       0x08    /* no dynamic segment */
+
+#define DG_NONE         UINT32_MAX
+
+typedef struct {
+    char     *path;             /* resolved file path, or the soname if MISSING */
+    char     *soname;           /* DT_SONAME, or the name it was first needed as */
+    uint32_t  flags;
+    uint32_t  depth;            /* BFS level it was discovered at (roots: 0) */
+    uint32_t  elsewhere;        /* MISSING: a node with this soname that other
+                                   roots load, or DG_NONE */
+} dg_node_t;
+
+typedef struct {
+    dg_node_t *nodes;
+    uint32_t   nnodes;
+
+    /* CSR adjacency: edges of node n are edges[edge_off[n] .. edge_off[n+1]) */
+    uint32_t  *edge_off;
+    uint32_t  *edges;
+    uint8_t   *edge_source;     /* ldso_source_t of each edge */
+    uint32_t   nedges;
+
+    /* Build statistics */
+    uint32_t   nroots;
+    uint32_t   levels;
+    unsigned long parsed;       /* ELF files opened and indexed */
+    unsigned long walk_errors;
+} dep_graph_t;
+
+typedef struct {
+    const char **roots;         /* files or directory trees */
+    int          nroots;
+    int          nthreads;      /* <= 0: one per online CPU */
+    ldso_ctx_t  *ldso;
+} dep_graph_opts_t;
+
+int dep_graph_build(dep_graph_t *g, const dep_graph_opts_t *opts);
+void dep_graph_free(dep_graph_t *g);
+
+/* Node index by exact path, or -1 */
+int64_t dep_graph_find(const dep_graph_t *g, const char *path);
+
+#endif /* DEP_GRAPH_H */
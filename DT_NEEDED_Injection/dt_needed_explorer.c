@@ -5,11 +5,17 @@
  *   1. Lists all required shared libraries
  *   2. Shows the order libraries are loaded
  *   3. Demonstrates how DT_NEEDED affects library search
+ *   4. Resolves each entry the way ld.so would (see ../common/ldso.h)
+ *   5. Builds the transitive dependency graph of whole trees (--graph)
+ *   6. Answers "who loads this library?" from a saved index (--who-uses)
  *
  * DT_NEEDED entries tell the dynamic linker which shared libraries
  * a binary requires. The linker loads these BEFORE main() runs.
  *
- * Compile: gcc -o dt_needed_explorer dt_needed_explorer.c -ldl
+ * Compile: gcc -I../common -pthread -o dt_needed_explorer dt_needed_explorer.c dep_graph.c \
+ *              rdep_index.c ../common/out_sink.c \
+ *              ../common/elf_view.c ../common/read_batch.c ../common/ldso.c \
+ *              ../common/fs_walk.c ../common/task_pool.c -ldl
  *
  * EDUCATIONAL PURPOSES ONLY
  */
@@ -19,12 +25,19 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include <unistd.h>
-#include <fcntl.h>
-#include <sys/mman.h>
 #include <sys/stat.h>
 #include <elf.h>
 #include <link.h>
+#include <errno.h>
+#include <time.h>
+
+#include "elf_view.h"
+#include "ldso.h"
+#include "dep_graph.h"
+#include "rdep_index.h"
+#include "out_sink.h"
 
 /* Color codes */
 #define RED     "\033[1;31m"
@@ -35,6 +48,8 @@
 #define CYAN    "\033[1;36m"
 #define RESET   "\033[0m"
 
+#define MAX_ROOTS   256         /* files or directories given to --graph */
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * PRINT EXPLANATION
  * ═══════════════════════════════════════════════════════════════════════════ */
@@ -95,34 +110,21 @@ void print_explanation(void) {
  * ANALYZE ELF FILE
  * ═══════════════════════════════════════════════════════════════════════════ */
 
-int analyze_elf(const char *filename) {
-    int fd = open(filename, O_RDONLY);
-    if (fd < 0) {
-        perror("open");
-        return -1;
-    }
-
-    struct stat st;
-    if (fstat(fd, &st) < 0) {
-        perror("fstat");
-        close(fd);
-        return -1;
-    }
-
-    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-    if (map == MAP_FAILED) {
-        perror("mmap");
-        close(fd);
-        return -1;
-    }
+static void print_search_dir(const char *dir, ldso_source_t source, void *arg) {
+    int *n = arg;
+    printf("    %2d. %-16s %s\n", ++*n, ldso_source_name(source), dir);
+}
 
-    Elf64_Ehdr *ehdr = (Elf64_Ehdr *)map;
+int analyze_elf(ldso_ctx_t *ldso, const char *filename) {
+    elf_view_t view;
+    ldso_object_t obj;
 
-    /* Verify ELF magic */
-    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0) {
-        fprintf(stderr, RED "[!] Not an ELF file\n" RESET);
-        munmap(map, st.st_size);
-        close(fd);
+    if (elf_view_open(&view, filename) < 0) {
+        if (errno == ENOEXEC) {
+            fprintf(stderr, RED "[!] Not an ELF file\n" RESET);
+        } else {
+            perror("open");
+        }
         return -1;
     }
 
@@ -131,62 +133,41 @@ int analyze_elf(const char *filename) {
     printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
     printf("\n");
 
-    /* Find dynamic section */
-    Elf64_Phdr *phdr = (Elf64_Phdr *)((char *)map + ehdr->e_phoff);
-    Elf64_Dyn *dynamic = NULL;
-    size_t dynamic_size = 0;
-
-    for (int i = 0; i < ehdr->e_phnum; i++) {
-        if (phdr[i].p_type == PT_DYNAMIC) {
-            dynamic = (Elf64_Dyn *)((char *)map + phdr[i].p_offset);
-            dynamic_size = phdr[i].p_filesz;
-            break;
-        }
-    }
-
-    if (!dynamic) {
+    /* Dynamic segment and string table were located by elf_view_open() */
+    if (!view.dynamic) {
         printf("  " YELLOW "No dynamic section found (static binary?)\n" RESET);
-        munmap(map, st.st_size);
-        close(fd);
+        elf_view_close(&view);
         return 0;
     }
 
-    /* Find string table */
-    char *strtab = NULL;
-    for (Elf64_Dyn *dyn = dynamic; dyn->d_tag != DT_NULL; dyn++) {
-        if (dyn->d_tag == DT_STRTAB) {
-            /* For executables, this is a virtual address; for analysis we need file offset */
-            /* Find the section that contains this address */
-            for (int i = 0; i < ehdr->e_phnum; i++) {
-                if (phdr[i].p_type == PT_LOAD &&
-                    dyn->d_un.d_ptr >= phdr[i].p_vaddr &&
-                    dyn->d_un.d_ptr < phdr[i].p_vaddr + phdr[i].p_filesz) {
-                    size_t offset = dyn->d_un.d_ptr - phdr[i].p_vaddr + phdr[i].p_offset;
-                    strtab = (char *)map + offset;
-                    break;
-                }
-            }
-            break;
-        }
-    }
-
-    if (!strtab) {
+    if (!view.dynstr) {
         printf("  " RED "Could not find string table\n" RESET);
-        munmap(map, st.st_size);
-        close(fd);
+        elf_view_close(&view);
         return -1;
     }
 
+    ldso_object_from_view(&obj, &view, NULL);
+
     /* Print DT_NEEDED entries */
     printf("  " YELLOW "DT_NEEDED entries (required libraries):\n" RESET);
     printf("  ─────────────────────────────────────────────────────────────────\n\n");
 
     int count = 0;
-    for (Elf64_Dyn *dyn = dynamic; dyn->d_tag != DT_NULL; dyn++) {
+    for (size_t i = 0; i < view.dyn_count; i++) {
+        const Elf64_Dyn *dyn = &view.dynamic[i];
         if (dyn->d_tag == DT_NEEDED) {
-            const char *libname = strtab + dyn->d_un.d_val;
+            const char *libname = elf_view_dynstr(&view, dyn->d_un.d_val);
+            if (!libname) libname = "(bad string offset)";
             printf("    [%2d] " GREEN "%s" RESET "\n", count, libname);
             printf("         String offset: 0x%lx\n", dyn->d_un.d_val);
+
+            ldso_result_t res;
+            if (ldso_resolve(ldso, &obj, libname, &res) == 0) {
+                printf("         Resolves to:   %s " CYAN "(via %s)" RESET "\n",
+                       res.path, ldso_source_name(res.source));
+            } else {
+                printf("         Resolves to:   " RED "NOT FOUND" RESET "\n");
+            }
             count++;
         }
     }
@@ -202,34 +183,34 @@ int analyze_elf(const char *filename) {
     printf("  " YELLOW "Other relevant dynamic entries:\n" RESET);
     printf("  ─────────────────────────────────────────────────────────────────\n\n");
 
-    for (Elf64_Dyn *dyn = dynamic; dyn->d_tag != DT_NULL; dyn++) {
-        switch (dyn->d_tag) {
-            case DT_RPATH:
-                printf("    DT_RPATH:   " MAGENTA "%s" RESET "\n", strtab + dyn->d_un.d_val);
-                break;
-            case DT_RUNPATH:
-                printf("    DT_RUNPATH: " MAGENTA "%s" RESET "\n", strtab + dyn->d_un.d_val);
-                break;
-            case DT_SONAME:
-                printf("    DT_SONAME:  " BLUE "%s" RESET "\n", strtab + dyn->d_un.d_val);
-                break;
-        }
+    const char *str;
+    if (elf_view_has(&view, DT_RPATH) &&
+        (str = elf_view_dynstr(&view, elf_view_dyn(&view, DT_RPATH)))) {
+        printf("    DT_RPATH:   " MAGENTA "%s" RESET "\n", str);
+    }
+    if (elf_view_has(&view, DT_RUNPATH) &&
+        (str = elf_view_dynstr(&view, elf_view_dyn(&view, DT_RUNPATH)))) {
+        printf("    DT_RUNPATH: " MAGENTA "%s" RESET "\n", str);
+    }
+    if (elf_view_has(&view, DT_SONAME) &&
+        (str = elf_view_dynstr(&view, elf_view_dyn(&view, DT_SONAME)))) {
+        printf("    DT_SONAME:  " BLUE "%s" RESET "\n", str);
     }
 
     printf("\n");
 
-    /* Show loading order explanation */
-    printf("  " YELLOW "Library search order:\n" RESET);
+    /* Show the search order as ld.so would apply it to this binary */
+    printf("  " YELLOW "Library search order (expanded for this binary):\n" RESET);
     printf("  ─────────────────────────────────────────────────────────────────\n");
-    printf("    1. DT_RPATH (deprecated, searched first)\n");
-    printf("    2. LD_LIBRARY_PATH environment variable\n");
-    printf("    3. DT_RUNPATH\n");
-    printf("    4. /etc/ld.so.cache\n");
-    printf("    5. /lib, /usr/lib (default paths)\n");
+    int n = 0;
+    ldso_search_dirs(ldso, &obj, print_search_dir, &n);
+    if (obj.nodeflib) {
+        printf("    " YELLOW "(DF_1_NODEFLIB: ld.so.cache and default paths skipped)\n" RESET);
+    }
     printf("\n");
 
-    munmap(map, st.st_size);
-    close(fd);
+    ldso_object_release(&obj);
+    elf_view_close(&view);
     return 0;
 }
 
@@ -267,22 +248,341 @@ void show_runtime_libraries(void) {
     printf("  Total: " GREEN "%d" RESET " loaded objects\n\n", count);
 }
 
+/* ═══════════════════════════════════════════════════════════════════════════
+ * DEPENDENCY GRAPH MODE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static uint32_t *in_degrees(const dep_graph_t *g) {
+    uint32_t *deg = calloc(g->nnodes ? g->nnodes : 1, sizeof(*deg));
+    if (!deg) return NULL;
+    for (uint32_t e = 0; e < g->nedges; e++) {
+        deg[g->edges[e]]++;
+    }
+    return deg;
+}
+
+static void print_graph_report(const dep_graph_t *g, int show_edges) {
+    uint32_t libs = 0, missing = 0, unreadable = 0;
+    for (uint32_t n = 0; n < g->nnodes; n++) {
+        if (g->nodes[n].flags & DG_MISSING) missing++;
+        else if (!(g->nodes[n].flags & DG_ROOT)) libs++;
+        if (g->nodes[n].flags & DG_UNREADABLE) unreadable++;
+    }
+
+    if (show_edges) {
+        printf("  " YELLOW "Edges (object → library, resolved via):\n" RESET);
+        printf("  ─────────────────────────────────────────────────────────────────\n");
+        for (uint32_t n = 0; n < g->nnodes; n++) {
+            for (uint32_t e = g->edge_off[n]; e < g->edge_off[n + 1]; e++) {
+                const dg_node_t *to = &g->nodes[g->edges[e]];
+                printf("    %s → %s%s" RESET " (%s)\n", g->nodes[n].path,
+                       (to->flags & DG_MISSING) ? RED : GREEN, to->path,
+                       ldso_source_name((ldso_source_t)g->edge_source[e]));
+            }
+        }
+        printf("\n");
+    }
+
+    /* Most-needed libraries by direct dependents */
+    uint32_t *deg = in_degrees(g);
+    if (deg) {
+        printf("  " YELLOW "Most depended-on libraries:\n" RESET);
+        printf("  ─────────────────────────────────────────────────────────────────\n");
+        uint32_t shown[10];
+        int nshown = 0;
+        while (nshown < 10) {
+            uint32_t best = UINT32_MAX;
+            for (uint32_t n = 0; n < g->nnodes; n++) {
+                int taken = 0;
+                for (int i = 0; i < nshown; i++) taken |= shown[i] == n;
+                if (!taken && deg[n] && (best == UINT32_MAX || deg[n] > deg[best])) best = n;
+            }
+            if (best == UINT32_MAX) break;
+            shown[nshown++] = best;
+            printf("    %6u  %s\n", deg[best], g->nodes[best].path);
+        }
+        printf("\n");
+
+        if (missing) {
+            printf("  " RED "Unresolved sonames" RESET " (a library of this name placed in\n");
+            printf("  any searched directory would be loaded):\n");
+            printf("  ─────────────────────────────────────────────────────────────────\n");
+            for (uint32_t n = 0; n < g->nnodes; n++) {
+                if (g->nodes[n].flags & DG_MISSING) {
+                    printf("    " RED "%-32s" RESET " needed by %u object(s)\n",
+                           g->nodes[n].path, deg[n]);
+                    if (g->nodes[n].elsewhere != DG_NONE) {
+                        printf("      (loaded elsewhere: %s)\n", g->nodes[g->nodes[n].elsewhere].path);
+                    }
+                }
+            }
+            printf("\n");
+        }
+        free(deg);
+    }
+
+    printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    printf(CYAN "  GRAPH SUMMARY\n" RESET);
+    printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    printf("  Root objects:           %u\n", g->nroots);
+    printf("  Libraries pulled in:    %u\n", libs);
+    printf("  Unresolved sonames:     %s%u" RESET "\n", missing ? RED : GREEN, missing);
+    printf("  Edges:                  %u\n", g->nedges);
+    printf("  BFS levels:             %u\n", g->levels);
+    printf("  ELF files parsed:       %lu (each once)\n", g->parsed);
+    printf("  Unreadable:             %lu\n", unreadable + g->walk_errors);
+}
+
+/* --format: one "node" record per object and one "edge" record per DT_NEEDED */
+static void emit_graph(out_sink_t *sink, const dep_graph_t *g) {
+    uint32_t *deg = in_degrees(g);
+
+    for (uint32_t n = 0; n < g->nnodes; n++) {
+        const dg_node_t *node = &g->nodes[n];
+        const char *flags[4];
+        size_t nflags = 0;
+        if (node->flags & DG_ROOT)       flags[nflags++] = "root";
+        if (node->flags & DG_MISSING)    flags[nflags++] = "missing";
+        if (node->flags & DG_UNREADABLE) flags[nflags++] = "unreadable";
+        if (node->flags & DG_STATIC)     flags[nflags++] = "static";
+
+        out_begin(sink, "node", node->path);
+        out_str(sink, "path", node->path);
+        out_str(sink, "soname", node->soname);
+        out_strv(sink, "flags", flags, nflags);
+        out_int(sink, "depth", node->depth);
+        out_int(sink, "dependents", deg ? deg[n] : 0);
+        if (node->elsewhere != DG_NONE) out_str(sink, "loaded_elsewhere", g->nodes[node->elsewhere].path);
+        out_end(sink);
+
+        for (uint32_t e = g->edge_off[n]; e < g->edge_off[n + 1]; e++) {
+            char key[PATH_MAX + 16];
+            snprintf(key, sizeof(key), "%s\x1f%06u", node->path, e - g->edge_off[n]);
+            out_begin(sink, "edge", key);
+            out_str(sink, "from", node->path);
+            out_str(sink, "to", g->nodes[g->edges[e]].path);
+            out_str(sink, "via", ldso_source_name((ldso_source_t)g->edge_source[e]));
+            out_end(sink);
+        }
+    }
+    free(deg);
+}
+
+int graph_mode(ldso_ctx_t *ldso, int argc, char *argv[]) {
+    const char *roots[MAX_ROOTS];
+    int nroots = 0;
+    const char *index_file = NULL;
+    out_format_t format = OUT_TEXT;
+    int nthreads = 0;
+    int show_edges = 0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            nthreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--save-index") == 0 && i + 1 < argc) {
+            index_file = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (out_format_parse(argv[++i], &format) < 0) {
+                fprintf(stderr, RED "[!] Unknown format: %s\n" RESET, argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--edges") == 0) {
+            show_edges = 1;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, RED "[!] Unknown option (or missing argument): %s\n" RESET, argv[i]);
+            return 2;
+        } else if (nroots < MAX_ROOTS) {
+            roots[nroots++] = argv[i];
+        } else {
+            fprintf(stderr, RED "[!] --graph takes at most %d files or directories\n" RESET, MAX_ROOTS);
+            return 2;
+        }
+    }
+
+    if (nroots == 0) {
+        fprintf(stderr, RED "[!] --graph needs at least one file or directory\n" RESET);
+        return 1;
+    }
+
+    dep_graph_opts_t opts = {
+        .roots = roots,
+        .nroots = nroots,
+        .nthreads = nthreads,
+        .ldso = ldso,
+    };
+    dep_graph_t g;
+
+    if (format == OUT_TEXT) {
+        printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+        printf(CYAN "  DEPENDENCY GRAPH:");
+        for (int i = 0; i < nroots; i++) printf(" %s", roots[i]);
+        printf("\n" RESET);
+        printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+        printf("\n");
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (dep_graph_build(&g, &opts) < 0) {
+        fprintf(stderr, RED "[!] Out of memory building the graph\n" RESET);
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    int rc = 0;
+    if (format == OUT_TEXT) {
+        print_graph_report(&g, show_edges);
+        printf("  Elapsed:                %.2f s\n",
+               (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+        printf("  Resolutions memoized:   %lu of %lu\n\n", ldso->memo_hits,
+               ldso->memo_hits + ldso->memo_misses);
+    } else {
+        out_sink_t sink;
+        if (out_sink_open(&sink, STDOUT_FILENO, format, 1) < 0) {
+            fprintf(stderr, RED "[!] Cannot write output: %s\n" RESET, strerror(errno));
+            dep_graph_free(&g);
+            return 2;
+        }
+        emit_graph(&sink, &g);
+        if (out_sink_close(&sink) < 0) {
+            fprintf(stderr, RED "[!] Output failed: %s\n" RESET, strerror(errno));
+            rc = 2;
+        }
+    }
+
+    if (index_file) {
+        if (rdep_index_write(&g, index_file) < 0) {
+            fprintf(stderr, RED "[!] Failed to write index %s: %s\n" RESET,
+                    index_file, strerror(errno));
+            rc = 1;
+        } else {
+            fprintf(format == OUT_TEXT ? stdout : stderr,
+                    GREEN "[+] Reverse-dependency index saved to %s\n\n" RESET, index_file);
+        }
+    }
+
+    dep_graph_free(&g);
+    return rc;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BLAST RADIUS QUERY
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int who_uses(const char *index_file, const char *name, int direct) {
+    rdep_index_t idx;
+    struct timespec t0, t1;
+
+    if (rdep_index_open(&idx, index_file) < 0) {
+        fprintf(stderr, RED "[!] Cannot read index %s: %s\n" RESET, index_file, strerror(errno));
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64_t *set = calloc(idx.words ? idx.words : 1, sizeof(*set));
+    uint32_t matches[64];
+    int nmatch = set ? rdep_index_query(&idx, name, set, matches, 64) : 0;
+
+    /* Symlinked names (libfoo.so.1 → libfoo.so.1.2.3) are indexed by target */
+    char real[PATH_MAX];
+    if (set && nmatch == 0 && realpath(name, real) && strcmp(real, name) != 0) {
+        nmatch = rdep_index_query(&idx, real, set, matches, 64);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (nmatch == 0) {
+        printf("  " YELLOW "%s" RESET " is not in the index (nothing loads it)\n\n", name);
+        free(set);
+        rdep_index_close(&idx);
+        return 1;
+    }
+
+    for (int m = 0; m < nmatch && m < 64; m++) {
+        printf("  " CYAN "%s" RESET "%s\n", rdep_index_path(&idx, matches[m]),
+               (idx.nodes[matches[m]].flags & DG_MISSING) ? RED " (unresolved soname)" RESET : "");
+        if (direct) {
+            for (uint32_t e = idx.rev_off[matches[m]]; e < idx.rev_off[matches[m] + 1]; e++) {
+                printf("    ← %s\n", rdep_index_path(&idx, idx.rev[e]));
+            }
+        }
+    }
+    printf("\n");
+
+    uint32_t count = 0;
+    if (!direct) {
+        for (uint32_t w = 0; w < idx.words; w++) {
+            for (uint64_t bits = set[w]; bits; bits &= bits - 1) {
+                uint32_t root = idx.roots[w * 64 + __builtin_ctzll(bits)];
+                printf("    %s\n", rdep_index_path(&idx, root));
+                count++;
+            }
+        }
+        printf("\n  " RED "%u" RESET " of %u indexed binaries load it (directly or transitively)\n",
+               count, idx.nroots);
+    }
+    char built[64];
+    time_t when = (time_t)idx.built;
+    strftime(built, sizeof(built), "%Y-%m-%d %H:%M:%S", localtime(&when));
+    printf("  Query time: %.3f ms (index built %s)\n\n",
+           ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1e6, built);
+
+    free(set);
+    rdep_index_close(&idx);
+    return 0;
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * MAIN
  * ═══════════════════════════════════════════════════════════════════════════ */
 
 int main(int argc, char *argv[]) {
+    ldso_opts_t opts = { .ld_library_path = getenv("LD_LIBRARY_PATH") };
+    int argi = 1;
+
+    if (argc > 2 && strcmp(argv[1], "--ld-library-path") == 0) {
+        opts.ld_library_path = argv[2];
+        argi = 3;
+    }
+
+    if (argc > argi && strcmp(argv[argi], "--graph") == 0) {
+        ldso_ctx_t ldso;
+        if (ldso_init(&ldso, &opts) < 0) {
+            fprintf(stderr, RED "[!] Out of memory\n" RESET);
+            return 1;
+        }
+        int rc = graph_mode(&ldso, argc - argi - 1, argv + argi + 1);
+        ldso_destroy(&ldso);
+        return rc;
+    }
+
+    if (argc > argi + 2 && strcmp(argv[argi], "--who-uses") == 0) {
+        int direct = argc > argi + 3 && strcmp(argv[argi + 3], "--direct") == 0;
+        return who_uses(argv[argi + 1], argv[argi + 2], direct);
+    }
+
     print_explanation();
 
-    if (argc > 1) {
+    if (argc > argi) {
         /* Analyze specified file */
-        analyze_elf(argv[1]);
+        ldso_ctx_t ldso;
+        if (ldso_init(&ldso, &opts) < 0) {
+            fprintf(stderr, RED "[!] Out of memory\n" RESET);
+            return 1;
+        }
+        analyze_elf(&ldso, argv[argi]);
+        ldso_destroy(&ldso);
     } else {
         /* Show currently loaded libraries */
         show_runtime_libraries();
 
-        printf("  " YELLOW "Usage:" RESET " %s <elf-file>\n", argv[0]);
-        printf("         Analyze DT_NEEDED entries in an ELF file\n\n");
+        printf("  " YELLOW "Usage:" RESET " %s [--ld-library-path PATH] <elf-file>\n", argv[0]);
+        printf("         Analyze DT_NEEDED entries in an ELF file\n");
+        printf("         %s [--ld-library-path PATH] --graph [--threads N] [--edges]\n", argv[0]);
+        printf("              [--save-index FILE] [--format text|jsonl|binary] <file|dir> ...\n");
+        printf("         Build the transitive dependency graph of files/trees\n");
+        printf("         %s --who-uses FILE <library path|soname> [--direct]\n", argv[0]);
+        printf("         Binaries that load a library, from a saved index\n");
+        printf("         (LD_LIBRARY_PATH defaults to the environment's)\n\n");
     }
 
     printf(GREEN "[✓] Explorer complete.\n" RESET);
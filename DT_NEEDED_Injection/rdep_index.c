@@ -0,0 +1,423 @@
+/*
+ * rdep_index.c - Persisted reverse-dependency index
+ *
+ * See rdep_index.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "rdep_index.h"
+
+#define RDEP_MAGIC      "RDEPIDX1"
+#define RDEP_VERSION    2
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t nnodes;
+    uint32_t nroots;
+    uint32_t nsoname;
+    uint32_t nedges;
+    uint32_t words;
+    int64_t  built;
+    uint64_t nclosure;          /* (node, root) pairs in the closure rows */
+
+    /* Section offsets from the start of the file, each 8-aligned */
+    uint64_t nodes_off;
+    uint64_t by_soname_off;
+    uint64_t roots_off;
+    uint64_t rev_off_off;
+    uint64_t rev_off;
+    uint64_t closure_off_off;
+    uint64_t closure_off;
+    uint64_t strings_off;
+    uint64_t strings_size;
+} rdep_header_t;
+
+static uint64_t align8(uint64_t n) {
+    return (n + 7) & ~(uint64_t)7;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BUILD
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/*
+ * Closure rows: the root bits of every root that reaches each node,
+ * ascending. Run once with closure NULL to count the rows into off[n + 1],
+ * then, with off made cumulative, again to fill them. Storage follows the
+ * number of (root, node) pairs, not nnodes × nroots: an executable's row
+ * is just its own bit.
+ */
+static int compute_closure(const dep_graph_t *g, const uint32_t *root_bit,
+                           uint64_t *off, uint32_t *closure) {
+    uint32_t *stamp = calloc(g->nnodes ? g->nnodes : 1, sizeof(*stamp));
+    uint32_t *stack = malloc((g->nnodes ? g->nnodes : 1) * sizeof(*stack));
+    if (!stamp || !stack) {
+        free(stamp);
+        free(stack);
+        return -1;
+    }
+
+    for (uint32_t r = 0; r < g->nnodes; r++) {
+        uint32_t bit = root_bit[r];
+        if (bit == RDEP_NONE) continue;
+
+        /* Each node is pushed at most once per root, so nnodes suffices */
+        size_t sp = 0;
+        stack[sp++] = r;
+        stamp[r] = bit + 1;
+        while (sp) {
+            uint32_t n = stack[--sp];
+            if (closure) {
+                closure[off[n]++] = bit;
+            } else {
+                off[n + 1]++;
+            }
+            for (uint32_t e = g->edge_off[n]; e < g->edge_off[n + 1]; e++) {
+                uint32_t to = g->edges[e];
+                if (stamp[to] != bit + 1) {
+                    stamp[to] = bit + 1;
+                    stack[sp++] = to;
+                }
+            }
+        }
+    }
+
+    free(stamp);
+    free(stack);
+    return 0;
+}
+
+static int cmp_soname(const void *a, const void *b, void *arg) {
+    const dep_graph_t *g = arg;
+    const dg_node_t *x = &g->nodes[*(const uint32_t *)a];
+    const dg_node_t *y = &g->nodes[*(const uint32_t *)b];
+    int c = strcmp(x->soname, y->soname);
+    if (c) return c;
+    return (*(const uint32_t *)a > *(const uint32_t *)b) -
+           (*(const uint32_t *)a < *(const uint32_t *)b);
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int rdep_index_write(const dep_graph_t *g, const char *file) {
+    rdep_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, RDEP_MAGIC, sizeof(h.magic));
+    h.version = RDEP_VERSION;
+    h.nnodes = g->nnodes;
+    h.nedges = g->nedges;
+    h.built = time(NULL);
+
+    uint64_t strings_size = 0;
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        strings_size += strlen(g->nodes[i].path) + 1;
+        if (g->nodes[i].soname) strings_size += strlen(g->nodes[i].soname) + 1;
+        if (g->nodes[i].flags & DG_ROOT) h.nroots++;
+        if (g->nodes[i].soname) h.nsoname++;
+    }
+    if (strings_size >= RDEP_NONE) {
+        errno = EFBIG;
+        return -1;
+    }
+    h.words = (h.nroots + 63) / 64;
+
+    size_t n1 = g->nnodes ? g->nnodes : 1;
+    rdep_node_t *nodes = calloc(n1, sizeof(*nodes));
+    uint32_t *by_soname = malloc(n1 * sizeof(*by_soname));
+    uint32_t *roots = malloc(n1 * sizeof(*roots));
+    uint32_t *root_bit = malloc(n1 * sizeof(*root_bit));
+    uint32_t *rev_off = calloc(g->nnodes + 2, sizeof(*rev_off));
+    uint32_t *rev = malloc((g->nedges ? g->nedges : 1) * sizeof(*rev));
+    uint64_t *closure_off = calloc(g->nnodes + 1, sizeof(*closure_off));
+    uint32_t *closure = NULL;
+    char *strings = malloc(strings_size ? strings_size : 1);
+    int ret = -1;
+
+    if (!nodes || !by_soname || !roots || !root_bit || !rev_off || !rev || !closure_off || !strings) {
+        goto out;
+    }
+
+    /* Nodes, strings and root numbering (roots keep graph order: by path) */
+    uint64_t off = 0;
+    uint32_t nroots = 0, nsoname = 0;
+    for (uint32_t i = 0; i < g->nnodes; i++) {
+        const dg_node_t *gn = &g->nodes[i];
+        size_t len = strlen(gn->path) + 1;
+
+        nodes[i].path_off = off;
+        memcpy(strings + off, gn->path, len);
+        off += len;
+
+        nodes[i].soname_off = RDEP_NONE;
+        if (gn->soname) {
+            len = strlen(gn->soname) + 1;
+            nodes[i].soname_off = off;
+            memcpy(strings + off, gn->soname, len);
+            off += len;
+            by_soname[nsoname++] = i;
+        }
+
+        nodes[i].flags = gn->flags;
+        nodes[i].root_bit = root_bit[i] = RDEP_NONE;
+        if (gn->flags & DG_ROOT) {
+            roots[nroots] = i;
+            nodes[i].root_bit = root_bit[i] = nroots++;
+        }
+    }
+    qsort_r(by_soname, nsoname, sizeof(*by_soname), cmp_soname, (void *)g);
+
+    /* Reverse CSR by counting sort on the edge targets */
+    for (uint32_t e = 0; e < g->nedges; e++) rev_off[g->edges[e] + 2]++;
+    for (uint32_t i = 2; i < g->nnodes + 2; i++) rev_off[i] += rev_off[i - 1];
+    for (uint32_t n = 0; n < g->nnodes; n++) {
+        for (uint32_t e = g->edge_off[n]; e < g->edge_off[n + 1]; e++) {
+            rev[rev_off[g->edges[e] + 1]++] = n;
+        }
+    }
+
+    /* Count the closure rows, then fill them with each row's start moving up */
+    if (compute_closure(g, root_bit, closure_off, NULL) < 0) goto out;
+    for (uint32_t i = 0; i < g->nnodes; i++) closure_off[i + 1] += closure_off[i];
+    h.nclosure = closure_off[g->nnodes];
+    closure = malloc((h.nclosure ? h.nclosure : 1) * sizeof(*closure));
+    if (!closure || compute_closure(g, root_bit, closure_off, closure) < 0) goto out;
+    memmove(closure_off + 1, closure_off, (uint64_t)g->nnodes * sizeof(*closure_off));
+    closure_off[0] = 0;
+
+    /* Lay out the sections */
+    uint64_t pos = align8(sizeof(h));
+    h.nodes_off = pos;      pos = align8(pos + (uint64_t)g->nnodes * sizeof(*nodes));
+    h.by_soname_off = pos;  pos = align8(pos + (uint64_t)nsoname * sizeof(*by_soname));
+    h.roots_off = pos;      pos = align8(pos + (uint64_t)nroots * sizeof(*roots));
+    h.rev_off_off = pos;    pos = align8(pos + ((uint64_t)g->nnodes + 1) * sizeof(*rev_off));
+    h.rev_off = pos;        pos = align8(pos + (uint64_t)g->nedges * sizeof(*rev));
+    h.closure_off_off = pos; pos = align8(pos + ((uint64_t)g->nnodes + 1) * sizeof(*closure_off));
+    h.closure_off = pos;    pos = align8(pos + h.nclosure * sizeof(*closure));
+    h.strings_off = pos;
+    h.strings_size = off;
+
+    char tmp[4096];
+    int fd = -1;
+
+    /* A fresh name beside the index, never a file or link someone planted there */
+    if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", file) >= (int)sizeof(tmp)) {
+        errno = ENAMETOOLONG;
+    } else {
+        fd = mkostemp(tmp, O_CLOEXEC);
+    }
+    if (fd >= 0) {
+        static const uint8_t zero[8];
+        struct {
+            uint64_t    at;
+            const void *data;
+            uint64_t    len;
+        } parts[] = {
+            { 0,               &h,        sizeof(h) },
+            { h.nodes_off,     nodes,     (uint64_t)g->nnodes * sizeof(*nodes) },
+            { h.by_soname_off, by_soname, (uint64_t)nsoname * sizeof(*by_soname) },
+            { h.roots_off,     roots,     (uint64_t)nroots * sizeof(*roots) },
+            { h.rev_off_off,   rev_off,   ((uint64_t)g->nnodes + 1) * sizeof(*rev_off) },
+            { h.rev_off,       rev,       (uint64_t)g->nedges * sizeof(*rev) },
+            { h.closure_off_off, closure_off, ((uint64_t)g->nnodes + 1) * sizeof(*closure_off) },
+            { h.closure_off,   closure,   h.nclosure * sizeof(*closure) },
+            { h.strings_off,   strings,   off },
+        };
+
+        int ok = fchmod(fd, 0644) == 0;        /* mkostemp() makes it 0600 */
+        uint64_t at = 0;
+        for (size_t i = 0; ok && i < sizeof(parts) / sizeof(parts[0]); i++) {
+            ok = write_all(fd, zero, parts[i].at - at) == 0 &&
+                 write_all(fd, parts[i].data, parts[i].len) == 0;
+            at = parts[i].at + parts[i].len;
+        }
+        if (ok && fsync(fd) != 0) ok = 0;
+        if (close(fd) != 0) ok = 0;
+        if (ok) ret = rename(tmp, file);
+        if (ret < 0) unlink(tmp);
+    }
+
+out:
+    free(nodes);
+    free(by_soname);
+    free(roots);
+    free(root_bit);
+    free(rev_off);
+    free(rev);
+    free(closure_off);
+    free(closure);
+    free(strings);
+    return ret;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * QUERY
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static int section_ok(const rdep_index_t *idx, uint64_t off, uint64_t count, uint64_t size) {
+    return off <= idx->size && count <= (idx->size - off) / (size ? size : 1);
+}
+
+int rdep_index_open(rdep_index_t *idx, const char *file) {
+    memset(idx, 0, sizeof(*idx));
+
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(rdep_header_t)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    idx->map = map;
+    idx->size = st.st_size;
+
+    const rdep_header_t *h = map;
+    if (memcmp(h->magic, RDEP_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != RDEP_VERSION ||
+        h->words != (h->nroots + 63) / 64 ||
+        !section_ok(idx, h->nodes_off, h->nnodes, sizeof(rdep_node_t)) ||
+        !section_ok(idx, h->by_soname_off, h->nsoname, sizeof(uint32_t)) ||
+        !section_ok(idx, h->roots_off, h->nroots, sizeof(uint32_t)) ||
+        !section_ok(idx, h->rev_off_off, (uint64_t)h->nnodes + 1, sizeof(uint32_t)) ||
+        !section_ok(idx, h->rev_off, h->nedges, sizeof(uint32_t)) ||
+        !section_ok(idx, h->closure_off_off, (uint64_t)h->nnodes + 1, sizeof(uint64_t)) ||
+        !section_ok(idx, h->closure_off, h->nclosure, sizeof(uint32_t)) ||
+        !section_ok(idx, h->strings_off, h->strings_size, 1) ||
+        (h->strings_size && idx->map[h->strings_off + h->strings_size - 1] != '\0')) {
+        rdep_index_close(idx);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* Ids and offsets are trusted by the queries, so check them all once */
+    const uint32_t *ids[] = {
+        (const void *)(idx->map + h->by_soname_off),
+        (const void *)(idx->map + h->roots_off),
+        (const void *)(idx->map + h->rev_off),
+    };
+    const uint64_t counts[] = { h->nsoname, h->nroots, h->nedges };
+    const uint32_t *offs = (const void *)(idx->map + h->rev_off_off);
+    int bad = offs[h->nnodes] != h->nedges;
+    for (size_t s = 0; s < 3; s++) {
+        for (uint64_t i = 0; i < counts[s]; i++) bad |= ids[s][i] >= h->nnodes;
+    }
+    for (uint32_t i = 0; i < h->nnodes; i++) bad |= offs[i] > offs[i + 1];
+
+    const uint64_t *coff = (const void *)(idx->map + h->closure_off_off);
+    const uint32_t *closure = (const void *)(idx->map + h->closure_off);
+    bad |= coff[0] != 0 || coff[h->nnodes] != h->nclosure;
+    for (uint32_t i = 0; !bad && i < h->nnodes; i++) bad |= coff[i] > coff[i + 1];
+    for (uint64_t i = 0; !bad && i < h->nclosure; i++) bad |= closure[i] >= h->nroots;
+    if (bad) {
+        rdep_index_close(idx);
+        errno = EINVAL;
+        return -1;
+    }
+
+    idx->nnodes = h->nnodes;
+    idx->nroots = h->nroots;
+    idx->nsoname = h->nsoname;
+    idx->words = h->words;
+    idx->built = h->built;
+    idx->nodes = (const void *)(idx->map + h->nodes_off);
+    idx->by_soname = (const void *)(idx->map + h->by_soname_off);
+    idx->roots = (const void *)(idx->map + h->roots_off);
+    idx->rev_off = (const void *)(idx->map + h->rev_off_off);
+    idx->rev = (const void *)(idx->map + h->rev_off);
+    idx->closure_off = coff;
+    idx->closure = closure;
+    idx->strings = (const char *)idx->map + h->strings_off;
+    idx->strings_size = h->strings_size;
+    return 0;
+}
+
+void rdep_index_close(rdep_index_t *idx) {
+    if (idx->map) munmap((void *)idx->map, idx->size);
+    memset(idx, 0, sizeof(*idx));
+}
+
+static const char *index_str(const rdep_index_t *idx, uint32_t off) {
+    if (off == RDEP_NONE || off >= idx->strings_size) return NULL;
+    return idx->strings + off;
+}
+
+const char *rdep_index_path(const rdep_index_t *idx, uint32_t node) {
+    const char *s = index_str(idx, idx->nodes[node].path_off);
+    return s ? s : "?";
+}
+
+const char *rdep_index_soname(const rdep_index_t *idx, uint32_t node) {
+    return index_str(idx, idx->nodes[node].soname_off);
+}
+
+static void add_match(const rdep_index_t *idx, uint32_t node, uint64_t *out,
+                      uint32_t *matches, int max, int *n) {
+    for (uint64_t e = idx->closure_off[node]; e < idx->closure_off[node + 1]; e++) {
+        uint32_t bit = idx->closure[e];
+        out[bit / 64] |= 1ULL << (bit % 64);
+    }
+    if (*n < max) matches[*n] = node;
+    (*n)++;
+}
+
+int rdep_index_query(const rdep_index_t *idx, const char *name, uint64_t *out,
+                     uint32_t *matches, int max) {
+    int n = 0;
+
+    /* Exact path: nodes are sorted by path */
+    uint32_t lo = 0, hi = idx->nnodes;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int c = strcmp(rdep_index_path(idx, mid), name);
+        if (c == 0) {
+            add_match(idx, mid, out, matches, max, &n);
+            return n;
+        }
+        if (c < 0) lo = mid + 1; else hi = mid;
+    }
+
+    /* Soname: first match, then every equal neighbour */
+    lo = 0;
+    hi = idx->nsoname;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const char *s = rdep_index_soname(idx, idx->by_soname[mid]);
+        if (s && strcmp(s, name) < 0) lo = mid + 1; else hi = mid;
+    }
+    for (; lo < idx->nsoname; lo++) {
+        const char *s = rdep_index_soname(idx, idx->by_soname[lo]);
+        if (!s || strcmp(s, name) != 0) break;
+        add_match(idx, idx->by_soname[lo], out, matches, max, &n);
+    }
+    return n;
+}
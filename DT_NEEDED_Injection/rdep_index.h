@@ -0,0 +1,89 @@
+/*
+ * rdep_index.h - Persisted reverse-dependency ("blast radius") index
+ *
+ * Answers "which binaries would load this library?" without rescanning.
+ * Built once from a dep_graph (dep_graph.h) and saved to a file that is
+ * mmap'ed read-only for queries:
+ *
+ *   ┌────────────────────┐
+ *   │ header             │  magic, version, counts, section offsets
+ *   ├────────────────────┤
+ *   │ node[nnodes]       │  path/soname offsets, flags, root bit; sorted by path
+ *   │ by_soname[]        │  node ids sorted by soname
+ *   │ roots[nroots]      │  root bit → node id
+ *   │ rev_off[nnodes+1]  │  reverse CSR: direct dependents of each node
+ *   │ rev[nedges]        │
+ *   │ closure_off[n+1]   │  closure rows (CSR): every root that loads the
+ *   │ closure[]          │  node, directly or transitively, as root bits
+ *   ├────────────────────┤
+ *   │ string blob        │
+ *   └────────────────────┘
+ *
+ * The transitive answer is precomputed at build time (one forward DFS
+ * per root), so a query is a binary search plus a scan of one row. Rows
+ * are sparse, so the file grows with the number of (root, library) pairs
+ * rather than nodes × roots. A query expands the rows into a bitset over
+ * the roots; a library may be looked up by resolved path or by soname,
+ * and a soname that several files carry unions their rows.
+ *
+ * The index is a snapshot: rebuild it after packages change.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef RDEP_INDEX_H
+#define RDEP_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "dep_graph.h"
+
+#define RDEP_NONE       0xffffffffu     /* string offset / root bit: not present */
+
+typedef struct {
+    uint32_t path_off;
+    uint32_t soname_off;        /* RDEP_NONE if unknown */
+    uint32_t flags;             /* DG_* */
+    uint32_t root_bit;          /* bit index if DG_ROOT, else RDEP_NONE */
+} rdep_node_t;
+
+typedef struct {
+    const uint8_t     *map;
+    size_t             size;
+
+    uint32_t           nnodes;
+    uint32_t           nroots;
+    uint32_t           nsoname;
+    uint32_t           words;       /* uint64_t words in a query's root bitset */
+    int64_t            built;       /* time() of the build */
+
+    const rdep_node_t *nodes;
+    const uint32_t    *by_soname;
+    const uint32_t    *roots;
+    const uint32_t    *rev_off;
+    const uint32_t    *rev;
+    const uint64_t    *closure_off;
+    const uint32_t    *closure;
+    const char        *strings;
+    uint64_t           strings_size;
+} rdep_index_t;
+
+/* Build the index for g and write it to file (tmp file + rename) */
+int rdep_index_write(const dep_graph_t *g, const char *file);
+
+int rdep_index_open(rdep_index_t *idx, const char *file);
+void rdep_index_close(rdep_index_t *idx);
+
+const char *rdep_index_path(const rdep_index_t *idx, uint32_t node);
+const char *rdep_index_soname(const rdep_index_t *idx, uint32_t node);
+
+/*
+ * OR the closure rows of every node matching name (a path, or else a
+ * soname) into out (idx->words words). Matching node ids are stored in
+ * matches (up to max). Returns the number of matching nodes.
+ */
+int rdep_index_query(const rdep_index_t *idx, const char *name, uint64_t *out,
+                     uint32_t *matches, int max);
+
+#endif /* RDEP_INDEX_H */
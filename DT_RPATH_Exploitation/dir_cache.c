@@ -0,0 +1,277 @@
+/*
+ * dir_cache.c - Memoized directory verdicts for rpath_scanner
+ *
+ * See dir_cache.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "dir_cache.h"
+
+struct dir_entry {
+    dir_entry_t   *next;
+    uint64_t       hash;
+    dir_verdict_t  verdict;
+    char           path[];
+};
+
+#define WRITABLE_BITS   (VULN_WRITABLE | VULN_WORLD_WRITABLE)
+
+static uint64_t path_hash(const char *s, size_t len) {
+    /* FNV-1a */
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (unsigned char)s[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+int dir_cache_init(dir_cache_t *c, uid_t uid) {
+    memset(c, 0, sizeof(*c));
+    c->uid = uid;
+    c->self = uid == getuid();
+    for (int i = 0; i < DIR_CACHE_SHARDS; i++) {
+        pthread_mutex_init(&c->shards[i].lock, NULL);
+    }
+    return 0;
+}
+
+static void shard_clear(dir_shard_t *s) {
+    for (size_t b = 0; b < s->nbuckets; b++) {
+        dir_entry_t *e = s->buckets[b];
+        while (e) {
+            dir_entry_t *next = e->next;
+            free(e);
+            e = next;
+        }
+    }
+    free(s->buckets);
+    s->buckets = NULL;
+    s->nbuckets = 0;
+    s->count = 0;
+}
+
+void dir_cache_destroy(dir_cache_t *c) {
+    for (int i = 0; i < DIR_CACHE_SHARDS; i++) {
+        shard_clear(&c->shards[i]);
+        pthread_mutex_destroy(&c->shards[i].lock);
+    }
+}
+
+void dir_cache_reset(dir_cache_t *c) {
+    for (int i = 0; i < DIR_CACHE_SHARDS; i++) {
+        pthread_mutex_lock(&c->shards[i].lock);
+        shard_clear(&c->shards[i]);
+        pthread_mutex_unlock(&c->shards[i].lock);
+    }
+    __atomic_store_n(&c->hits, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&c->misses, 0, __ATOMIC_RELAXED);
+}
+
+size_t dir_cache_size(dir_cache_t *c) {
+    size_t n = 0;
+    for (int i = 0; i < DIR_CACHE_SHARDS; i++) {
+        pthread_mutex_lock(&c->shards[i].lock);
+        n += c->shards[i].count;
+        pthread_mutex_unlock(&c->shards[i].lock);
+    }
+    return n;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * TABLE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static dir_shard_t *shard_of(dir_cache_t *c, uint64_t hash) {
+    return &c->shards[hash >> 58];      /* top 6 bits pick one of 64 shards */
+}
+
+static dir_entry_t *shard_find(dir_shard_t *s, uint64_t hash, const char *path, size_t len) {
+    if (!s->nbuckets) return NULL;
+    for (dir_entry_t *e = s->buckets[hash & (s->nbuckets - 1)]; e; e = e->next) {
+        if (e->hash == hash && strncmp(e->path, path, len) == 0 && e->path[len] == '\0') {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static int lookup(dir_cache_t *c, uint64_t hash, const char *path, size_t len,
+                  dir_verdict_t *v) {
+    dir_shard_t *s = shard_of(c, hash);
+    pthread_mutex_lock(&s->lock);
+    dir_entry_t *e = shard_find(s, hash, path, len);
+    if (e) *v = e->verdict;
+    pthread_mutex_unlock(&s->lock);
+    return e != NULL;
+}
+
+static void insert(dir_cache_t *c, uint64_t hash, const char *path, size_t len,
+                   const dir_verdict_t *v) {
+    dir_shard_t *s = shard_of(c, hash);
+
+    pthread_mutex_lock(&s->lock);
+
+    /* Another thread may have computed the same directory meanwhile */
+    if (shard_find(s, hash, path, len)) {
+        pthread_mutex_unlock(&s->lock);
+        return;
+    }
+
+    if (s->count >= s->nbuckets) {
+        size_t nb = s->nbuckets ? s->nbuckets * 2 : 64;
+        dir_entry_t **buckets = calloc(nb, sizeof(*buckets));
+        if (buckets) {
+            for (size_t b = 0; b < s->nbuckets; b++) {
+                dir_entry_t *e = s->buckets[b];
+                while (e) {
+                    dir_entry_t *next = e->next;
+                    e->next = buckets[e->hash & (nb - 1)];
+                    buckets[e->hash & (nb - 1)] = e;
+                    e = next;
+                }
+            }
+            free(s->buckets);
+            s->buckets = buckets;
+            s->nbuckets = nb;
+        }
+    }
+
+    dir_entry_t *e = s->nbuckets ? malloc(sizeof(*e) + len + 1) : NULL;
+    if (e) {
+        e->hash = hash;
+        e->verdict = *v;
+        memcpy(e->path, path, len);
+        e->path[len] = '\0';
+        e->next = s->buckets[hash & (s->nbuckets - 1)];
+        s->buckets[hash & (s->nbuckets - 1)] = e;
+        s->count++;
+    }
+
+    pthread_mutex_unlock(&s->lock);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * VERDICTS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Length of the lexical parent of path[0..len), or 0 if there is none */
+static size_t parent_len(const char *path, size_t len) {
+    while (len > 1 && path[len - 1] == '/') len--;      /* trailing slashes */
+    while (len > 0 && path[len - 1] != '/') len--;      /* last component */
+    if (len == 0) return 0;                             /* "lib" has no parent */
+    while (len > 1 && path[len - 1] == '/') len--;      /* "a//b" → "a" */
+    return len;
+}
+
+/*
+ * Verdict for buf[0..len), given its parent's (has_parent) or none.
+ * buf holds the whole path being checked; it is cut at len for the
+ * system calls and restored.
+ */
+static void judge(dir_cache_t *c, char *buf, size_t len, int has_parent,
+                  const dir_verdict_t *parent, dir_verdict_t *v) {
+    char saved = buf[len];
+    buf[len] = '\0';
+
+    memset(v, 0, sizeof(*v));
+    struct stat st;
+    if (stat(buf, &st) < 0) {
+        if (errno == ENOENT) {
+            v->vulns |= VULN_NONEXISTENT;
+
+            /* Creatable if the nearest existing ancestor is writable */
+            if (has_parent && (parent->vulns & WRITABLE_BITS)) {
+                v->vulns |= VULN_WRITABLE;
+            }
+        }
+    } else {
+        v->exists = 1;
+        v->mode = st.st_mode;
+        v->owner = st.st_uid;
+
+        /* Directory exists - check permissions */
+        if (st.st_mode & S_IWOTH) {
+            v->vulns |= VULN_WORLD_WRITABLE;
+        }
+        if (st.st_uid == c->uid && (st.st_mode & S_IWUSR)) {
+            v->vulns |= VULN_WRITABLE;
+        }
+        if (c->self && access(buf, W_OK) == 0) {
+            v->vulns |= VULN_WRITABLE;
+        }
+
+        /*
+         * A writable ancestor lets an attacker swap this directory out,
+         * unless the parent is sticky (/tmp) and the entry isn't theirs.
+         */
+        int sticky_safe = (parent->mode & S_ISVTX) && c->uid != 0 &&
+                          c->uid != parent->owner && c->uid != st.st_uid;
+        if (has_parent &&
+            ((parent->exists && (parent->vulns & WRITABLE_BITS) && !sticky_safe) ||
+             (parent->vulns & VULN_PARENT_WRITABLE))) {
+            v->vulns |= VULN_PARENT_WRITABLE;
+        }
+    }
+
+    buf[len] = saved;
+    insert(c, path_hash(buf, len), buf, len, v);
+}
+
+static int check_len(dir_cache_t *c, const char *path, size_t len, dir_verdict_t *v) {
+    /* The path comes from a file: refuse what no directory can be */
+    if (len >= PATH_MAX) {
+        memset(v, 0, sizeof(*v));
+        return 0;
+    }
+
+    /*
+     * Walk up until an ancestor is cached (or there is none), then judge
+     * the uncached ones shortest first, each from its parent's verdict.
+     * Every step drops at least one byte, so len bounds the depth.
+     */
+    uint16_t lens[PATH_MAX];
+    int n = 0, has_parent = 0;
+    dir_verdict_t parent = {0};
+
+    for (size_t cur = len; ; ) {
+        if (lookup(c, path_hash(path, cur), path, cur, &parent)) {
+            __atomic_fetch_add(&c->hits, 1, __ATOMIC_RELAXED);
+            if (n == 0) {
+                *v = parent;
+                return v->vulns;
+            }
+            has_parent = 1;
+            break;
+        }
+        __atomic_fetch_add(&c->misses, 1, __ATOMIC_RELAXED);
+        lens[n++] = cur;
+
+        size_t plen = parent_len(path, cur);
+        if (plen == 0 || plen >= cur) break;
+        cur = plen;
+    }
+
+    char buf[PATH_MAX];
+    memcpy(buf, path, len);
+    buf[len] = '\0';
+
+    while (n-- > 0) {
+        judge(c, buf, lens[n], has_parent, &parent, v);
+        parent = *v;
+        has_parent = 1;
+    }
+    return v->vulns;
+}
+
+int dir_cache_check(dir_cache_t *c, const char *path, dir_verdict_t *v) {
+    return check_len(c, path, strlen(path), v);
+}
@@ -0,0 +1,78 @@
+/*
+ * dir_cache.h - Memoized directory verdicts for rpath_scanner
+ *
+ * Thousands of binaries share the same few RPATH/RUNPATH directories,
+ * so each distinct directory is stat()ed and access()ed once per scan
+ * and the answer is kept here. A directory's verdict is built from its
+ * parent's cached verdict, so walking the ancestors of a new path stops
+ * at the first directory some earlier binary already caused us to check:
+ *
+ *   /opt/vendor/lib   own: -            ancestors: WRITABLE ←─┐
+ *   /opt/vendor       own: WRITABLE     ancestors: -          │ inherited
+ *   /opt              own: -            ancestors: -  ────────┘
+ *   /                 own: -
+ *
+ * The table is sharded with one mutex per shard, so scan threads only
+ * contend when they hit the same shard at the same moment. Nothing is
+ * held locked across a stat().
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef DIR_CACHE_H
+#define DIR_CACHE_H
+
+#include <pthread.h>
+#include <sys/types.h>
+
+typedef enum {
+    VULN_NONE = 0,
+    VULN_WRITABLE = 1,
+    VULN_RELATIVE = 2,
+    VULN_ORIGIN = 4,
+    VULN_NONEXISTENT = 8,
+    VULN_WORLD_WRITABLE = 16,
+    VULN_PARENT_WRITABLE = 32       /* an ancestor dir can be modified */
+} vuln_type_t;
+
+#define DIR_CACHE_SHARDS    64
+
+typedef struct dir_entry dir_entry_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    dir_entry_t   **buckets;
+    size_t          nbuckets;
+    size_t          count;
+} dir_shard_t;
+
+typedef struct {
+    uid_t         uid;
+    int           self;         /* uid is ours: access() answers for it */
+    dir_shard_t   shards[DIR_CACHE_SHARDS];
+    unsigned long hits;
+    unsigned long misses;
+} dir_cache_t;
+
+/* Cached stat() result and verdict for one directory */
+typedef struct {
+    int    vulns;       /* VULN_WRITABLE/WORLD_WRITABLE/NONEXISTENT/PARENT_WRITABLE */
+    int    exists;
+    mode_t mode;
+    uid_t  owner;
+} dir_verdict_t;
+
+/* Verdicts are for uid; access() is only consulted when that is our own uid */
+int dir_cache_init(dir_cache_t *c, uid_t uid);
+void dir_cache_destroy(dir_cache_t *c);
+
+/* Forget every verdict, so directories are stat()ed afresh; thread-safe */
+void dir_cache_reset(dir_cache_t *c);
+
+/* Filesystem verdict for a directory path; thread-safe. Returns v->vulns. */
+int dir_cache_check(dir_cache_t *c, const char *path, dir_verdict_t *v);
+
+/* Number of distinct directories examined so far */
+size_t dir_cache_size(dir_cache_t *c);
+
+#endif /* DIR_CACHE_H */
@@ -0,0 +1,385 @@
+/*
+ * rpath_cache.c - Persistent scan-result cache for rpath_scanner
+ *
+ * See rpath_cache.h for the file layout.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+
+#include "rpath_cache.h"
+
+#define CACHE_MAGIC     "RPSCACHE"
+#define CACHE_VERSION   1
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t nbuckets;          /* power of two */
+    uint64_t nentries;
+    uint64_t blob_size;
+} cache_header_t;
+
+typedef struct {
+    rpath_cache_key_t key;
+    uint32_t path_off;
+    uint32_t rpath_off;
+    uint32_t runpath_off;
+    uint32_t needed_off;
+    uint32_t needed_count;
+    uint32_t verdict;
+    uint32_t used;
+    uint32_t reserved;
+} cache_record_t;
+
+/* One result recorded during the current scan; strings follow the struct */
+struct rpath_cache_new {
+    rpath_cache_key_t key;
+    uint32_t verdict;
+    uint32_t needed_count;
+    uint32_t path_len;
+    uint32_t rpath_len;         /* RPATH_CACHE_NONE if absent */
+    uint32_t runpath_len;       /* RPATH_CACHE_NONE if absent */
+    uint32_t needed_len;        /* bytes of NUL-separated sonames */
+    char     data[];
+};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * KEYS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+void rpath_cache_key(const struct stat *st, rpath_cache_key_t *key) {
+    key->dev = st->st_dev;
+    key->ino = st->st_ino;
+    key->size = st->st_size;
+    key->mtime_sec = st->st_mtim.tv_sec;
+    key->mtime_nsec = st->st_mtim.tv_nsec;
+    key->ctime_sec = st->st_ctim.tv_sec;
+    key->ctime_nsec = st->st_ctim.tv_nsec;
+}
+
+static uint64_t key_hash(uint64_t dev, uint64_t ino) {
+    /* splitmix64 finalizer over the (dev, ino) pair */
+    uint64_t h = ino ^ (dev * 0x9e3779b97f4a7c15ULL);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * LOAD / LOOKUP
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void unmap_previous(rpath_cache_t *c) {
+    if (c->map) munmap((void *)c->map, c->map_size);
+    c->map = NULL;
+    c->map_size = 0;
+    c->records = NULL;
+    c->nbuckets = 0;
+    c->blob = NULL;
+    c->blob_size = 0;
+}
+
+static int off_valid(const rpath_cache_t *c, uint32_t off) {
+    return off == RPATH_CACHE_NONE || off < c->blob_size;
+}
+
+/*
+ * Every used record's offsets must land in the blob and its needed_count
+ * sonames must all end inside it, so lookups never leave the mapping.
+ * The blob is known to end in a NUL, so each string starting in it ends
+ * in it too.
+ */
+static int records_valid(const rpath_cache_t *c) {
+    const cache_record_t *rec = c->records;
+
+    for (uint32_t i = 0; i < c->nbuckets; i++) {
+        if (!rec[i].used) continue;
+        if (rec[i].path_off >= c->blob_size ||
+            !off_valid(c, rec[i].rpath_off) || !off_valid(c, rec[i].runpath_off) ||
+            !off_valid(c, rec[i].needed_off)) {
+            return 0;
+        }
+        if (rec[i].needed_off == RPATH_CACHE_NONE) continue;
+
+        /* Every soname takes at least its NUL */
+        uint64_t off = rec[i].needed_off;
+        if (rec[i].needed_count > c->blob_size - off) return 0;
+        for (uint32_t n = 0; n < rec[i].needed_count; n++) {
+            if (off >= c->blob_size) return 0;
+            const char *end = memchr(c->blob + off, '\0', c->blob_size - off);
+            off = end - c->blob + 1;
+        }
+    }
+    return 1;
+}
+
+int rpath_cache_load(rpath_cache_t *c, const char *file) {
+    memset(c, 0, sizeof(*c));
+    c->file = file;
+    pthread_mutex_init(&c->lock, NULL);
+
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT ? 0 : -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(cache_header_t)) {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    c->map = map;
+    c->map_size = st.st_size;
+
+    /* Anything inconsistent is treated as "no cache" and rebuilt */
+    const cache_header_t *h = map;
+    uint64_t table = (uint64_t)h->nbuckets * sizeof(cache_record_t);
+    if (memcmp(h->magic, CACHE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != CACHE_VERSION ||
+        h->nbuckets == 0 || (h->nbuckets & (h->nbuckets - 1)) != 0 ||
+        table > c->map_size - sizeof(*h) ||
+        h->blob_size != c->map_size - sizeof(*h) - table) {
+        unmap_previous(c);
+        return 0;
+    }
+
+    c->records = c->map + sizeof(*h);
+    c->nbuckets = h->nbuckets;
+    c->blob = (const char *)c->map + sizeof(*h) + table;
+    c->blob_size = h->blob_size;
+
+    if ((c->blob_size > 0 && c->blob[c->blob_size - 1] != '\0') || !records_valid(c)) {
+        unmap_previous(c);
+    }
+    return 0;
+}
+
+static const char *blob_str(const rpath_cache_t *c, uint32_t off) {
+    if (off == RPATH_CACHE_NONE || off >= c->blob_size) return NULL;
+    return c->blob + off;
+}
+
+int rpath_cache_lookup(rpath_cache_t *c, const rpath_cache_key_t *key,
+                       rpath_cache_hit_t *hit) {
+    if (c->nbuckets) {
+        const cache_record_t *rec = c->records;
+        uint32_t mask = c->nbuckets - 1;
+
+        for (uint32_t i = key_hash(key->dev, key->ino) & mask, n = 0;
+             n < c->nbuckets && rec[i].used; i = (i + 1) & mask, n++) {
+            if (memcmp(&rec[i].key, key, sizeof(*key)) != 0) continue;
+
+            hit->rpath = blob_str(c, rec[i].rpath_off);
+            hit->runpath = blob_str(c, rec[i].runpath_off);
+            hit->needed = blob_str(c, rec[i].needed_off);
+            hit->needed_count = hit->needed ? rec[i].needed_count : 0;
+            hit->verdict = rec[i].verdict;
+            __atomic_fetch_add(&c->hits, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+    }
+
+    __atomic_fetch_add(&c->misses, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * NEXT GENERATION
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int rpath_cache_add(rpath_cache_t *c, const rpath_cache_key_t *key,
+                    const char *path, const char *rpath, const char *runpath,
+                    const char *const *needed, uint32_t needed_count,
+                    uint32_t verdict) {
+    size_t path_len = strlen(path) + 1;
+    size_t rpath_len = rpath ? strlen(rpath) + 1 : 0;
+    size_t runpath_len = runpath ? strlen(runpath) + 1 : 0;
+    size_t needed_len = 0;
+    for (uint32_t i = 0; i < needed_count; i++) {
+        needed_len += strlen(needed[i]) + 1;
+    }
+
+    rpath_cache_new_t *e = malloc(sizeof(*e) + path_len + rpath_len +
+                                  runpath_len + needed_len);
+    if (!e) return -1;
+
+    e->key = *key;
+    e->verdict = verdict;
+    e->needed_count = needed_count;
+    e->path_len = path_len;
+    e->rpath_len = rpath ? rpath_len : RPATH_CACHE_NONE;
+    e->runpath_len = runpath ? runpath_len : RPATH_CACHE_NONE;
+    e->needed_len = needed_len;
+
+    char *p = e->data;
+    memcpy(p, path, path_len);          p += path_len;
+    if (rpath)   { memcpy(p, rpath, rpath_len);     p += rpath_len; }
+    if (runpath) { memcpy(p, runpath, runpath_len); p += runpath_len; }
+    for (uint32_t i = 0; i < needed_count; i++) {
+        size_t n = strlen(needed[i]) + 1;
+        memcpy(p, needed[i], n);
+        p += n;
+    }
+
+    pthread_mutex_lock(&c->lock);
+    if (c->fresh_count == c->fresh_cap) {
+        size_t cap = c->fresh_cap ? c->fresh_cap * 2 : 1024;
+        rpath_cache_new_t **fresh = realloc(c->fresh, cap * sizeof(*fresh));
+        if (!fresh) {
+            pthread_mutex_unlock(&c->lock);
+            free(e);
+            return -1;
+        }
+        c->fresh = fresh;
+        c->fresh_cap = cap;
+    }
+    c->fresh[c->fresh_count++] = e;
+    pthread_mutex_unlock(&c->lock);
+    return 0;
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int rpath_cache_save(rpath_cache_t *c) {
+    uint32_t nbuckets = 16;
+    while (nbuckets < c->fresh_count * 2) nbuckets <<= 1;
+
+    uint64_t blob_size = 0;
+    for (size_t i = 0; i < c->fresh_count; i++) {
+        const rpath_cache_new_t *e = c->fresh[i];
+        blob_size += e->path_len + e->needed_len;
+        if (e->rpath_len != RPATH_CACHE_NONE) blob_size += e->rpath_len;
+        if (e->runpath_len != RPATH_CACHE_NONE) blob_size += e->runpath_len;
+    }
+    if (blob_size >= RPATH_CACHE_NONE) {
+        errno = EFBIG;
+        return -1;
+    }
+
+    cache_record_t *rec = calloc(nbuckets, sizeof(*rec));
+    char *blob = malloc(blob_size ? blob_size : 1);
+    if (!rec || !blob) {
+        free(rec);
+        free(blob);
+        return -1;
+    }
+
+    uint32_t mask = nbuckets - 1;
+    uint64_t off = 0, nentries = 0;
+    for (size_t i = 0; i < c->fresh_count; i++) {
+        const rpath_cache_new_t *e = c->fresh[i];
+
+        /* Hard links reach the same inode twice; keep the first */
+        uint32_t b = key_hash(e->key.dev, e->key.ino) & mask;
+        int dup = 0;
+        for (; rec[b].used; b = (b + 1) & mask) {
+            if (memcmp(&rec[b].key, &e->key, sizeof(e->key)) == 0) {
+                dup = 1;
+                break;
+            }
+        }
+        if (dup) continue;
+
+        cache_record_t *r = &rec[b];
+        const char *p = e->data;
+        r->key = e->key;
+        r->used = 1;
+        r->verdict = e->verdict;
+        r->needed_count = e->needed_count;
+
+        r->path_off = off;
+        memcpy(blob + off, p, e->path_len);
+        off += e->path_len;
+        p += e->path_len;
+
+        r->rpath_off = r->runpath_off = RPATH_CACHE_NONE;
+        if (e->rpath_len != RPATH_CACHE_NONE) {
+            r->rpath_off = off;
+            memcpy(blob + off, p, e->rpath_len);
+            off += e->rpath_len;
+            p += e->rpath_len;
+        }
+        if (e->runpath_len != RPATH_CACHE_NONE) {
+            r->runpath_off = off;
+            memcpy(blob + off, p, e->runpath_len);
+            off += e->runpath_len;
+            p += e->runpath_len;
+        }
+
+        r->needed_off = e->needed_count ? off : RPATH_CACHE_NONE;
+        memcpy(blob + off, p, e->needed_len);
+        off += e->needed_len;
+        nentries++;
+    }
+
+    cache_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CACHE_MAGIC, sizeof(h.magic));
+    h.version = CACHE_VERSION;
+    h.nbuckets = nbuckets;
+    h.nentries = nentries;
+    h.blob_size = off;
+
+    char tmp[4096];
+    int fd = -1;
+
+    /* A fresh name beside the cache, never a file or link someone planted there */
+    if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", c->file) >= (int)sizeof(tmp)) {
+        errno = ENAMETOOLONG;
+    } else {
+        fd = mkostemp(tmp, O_CLOEXEC);
+    }
+
+    int ret = -1;
+    if (fd >= 0) {
+        int ok = write_all(fd, &h, sizeof(h)) == 0 &&
+                 write_all(fd, rec, (size_t)nbuckets * sizeof(*rec)) == 0 &&
+                 write_all(fd, blob, off) == 0 &&
+                 fsync(fd) == 0;
+        if (close(fd) != 0) ok = 0;
+        if (ok) ret = rename(tmp, c->file);
+        if (ret < 0) unlink(tmp);
+    }
+
+    free(rec);
+    free(blob);
+    return ret;
+}
+
+void rpath_cache_close(rpath_cache_t *c) {
+    unmap_previous(c);
+    for (size_t i = 0; i < c->fresh_count; i++) {
+        free(c->fresh[i]);
+    }
+    free(c->fresh);
+    c->fresh = NULL;
+    c->fresh_count = c->fresh_cap = 0;
+    pthread_mutex_destroy(&c->lock);
+}
@@ -0,0 +1,100 @@
+/*
+ * rpath_cache.h - Persistent scan-result cache for rpath_scanner
+ *
+ * Nightly scans see almost exactly the same binaries every time. The
+ * cache remembers, per file identity, what parse_elf() found (RPATH,
+ * RUNPATH, NEEDED) and the verdict of the last scan, so an unchanged
+ * binary costs one fstat() instead of an mmap and a dynamic-section walk.
+ *
+ * A file's identity is (st_dev, st_ino, st_size, st_mtim, st_ctim):
+ * any write, truncate, chmod or replacement changes at least one of them.
+ *
+ * On-disk layout (little-endian, mmap'ed read-only on load):
+ *
+ *   ┌────────────────────┐
+ *   │ header             │  magic, version, bucket count, blob size
+ *   ├────────────────────┤
+ *   │ record[nbuckets]   │  open-addressed on hash(dev, ino)
+ *   ├────────────────────┤
+ *   │ string blob        │  NUL-terminated paths/rpaths/sonames
+ *   └────────────────────┘
+ *
+ * Each scan writes a fresh generation (tmp file + rename) holding only
+ * the files it saw, so deleted binaries drop out on their own.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef RPATH_CACHE_H
+#define RPATH_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#define RPATH_CACHE_NONE    0xffffffffu     /* string offset: not present */
+
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    int64_t  mtime_sec;
+    int64_t  mtime_nsec;
+    int64_t  ctime_sec;
+    int64_t  ctime_nsec;
+} rpath_cache_key_t;
+
+/* A cached result; all strings point into the cache mapping */
+typedef struct {
+    const char *rpath;          /* NULL if not set */
+    const char *runpath;        /* NULL if not set */
+    const char *needed;         /* needed_count NUL-separated sonames */
+    uint32_t    needed_count;
+    uint32_t    verdict;        /* vuln_type_t bits from the last scan */
+} rpath_cache_hit_t;
+
+typedef struct rpath_cache_new rpath_cache_new_t;
+
+typedef struct {
+    const char     *file;
+
+    /* Previous generation (read-only mapping) */
+    const uint8_t  *map;
+    size_t          map_size;
+    const void     *records;
+    uint32_t        nbuckets;
+    const char     *blob;
+    uint64_t        blob_size;
+
+    /* Next generation, filled by the scan threads */
+    pthread_mutex_t     lock;
+    rpath_cache_new_t **fresh;
+    size_t              fresh_count;
+    size_t              fresh_cap;
+
+    unsigned long   hits;
+    unsigned long   misses;
+} rpath_cache_t;
+
+void rpath_cache_key(const struct stat *st, rpath_cache_key_t *key);
+
+/* Load the previous generation; a missing or invalid file is an empty cache */
+int rpath_cache_load(rpath_cache_t *c, const char *file);
+
+/* Thread-safe lookup in the previous generation. Returns 1 on hit. */
+int rpath_cache_lookup(rpath_cache_t *c, const rpath_cache_key_t *key,
+                       rpath_cache_hit_t *hit);
+
+/* Thread-safe: record a file for the next generation */
+int rpath_cache_add(rpath_cache_t *c, const rpath_cache_key_t *key,
+                    const char *path, const char *rpath, const char *runpath,
+                    const char *const *needed, uint32_t needed_count,
+                    uint32_t verdict);
+
+/* Write the next generation atomically (tmp + rename) */
+int rpath_cache_save(rpath_cache_t *c);
+
+void rpath_cache_close(rpath_cache_t *c);
+
+#endif /* RPATH_CACHE_H */
@@ -0,0 +1,289 @@
+/*
+ * rpath_core.c - Reentrant RPATH/RUNPATH analysis core
+ *
+ * See rpath_core.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <elf.h>
+
+#include "elf_view.h"
+#include "rpath_core.h"
+
+static void *default_alloc(void *ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void default_free(void *ctx, void *p) {
+    (void)ctx;
+    free(p);
+}
+
+int rpath_core_init(rpath_core_t *core, const rpath_core_opts_t *opts) {
+    memset(core, 0, sizeof(*core));
+    if (opts->alloc) {
+        core->alloc = *opts->alloc;
+    } else {
+        core->alloc.alloc = default_alloc;
+        core->alloc.free = default_free;
+    }
+    core->resolve = opts->resolve;
+
+    dir_cache_init(&core->dirs, opts->uid);
+    str_arena_init(&core->strs);
+
+    if (core->resolve) {
+        ldso_opts_t lopts = { .ld_library_path = opts->ld_library_path };
+        if (ldso_init(&core->ldso, &lopts) < 0) {
+            dir_cache_destroy(&core->dirs);
+            str_arena_destroy(&core->strs);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void rpath_core_destroy(rpath_core_t *core) {
+    if (core->resolve) ldso_destroy(&core->ldso);
+    dir_cache_destroy(&core->dirs);
+    str_arena_destroy(&core->strs);
+}
+
+int rpath_core_reset(rpath_core_t *core) {
+    /* The only step that can fail goes first */
+    if (core->resolve && ldso_reset(&core->ldso) < 0) return -1;
+    dir_cache_reset(&core->dirs);
+    str_arena_reset(&core->strs);
+    return 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * VULNERABILITY CHECKS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/*
+ * Lexical checks are done here; everything that needs the filesystem
+ * goes through the core's directory cache (see dir_cache.h).
+ */
+int rpath_check_dir(rpath_core_t *core, const char *dir) {
+    int vulns = VULN_NONE;
+
+    /* Check for relative path */
+    if (dir[0] != '/' && strncmp(dir, "$ORIGIN", 7) != 0) {
+        vulns |= VULN_RELATIVE;
+    }
+
+    /* Check for $ORIGIN */
+    if (strstr(dir, "$ORIGIN") || strstr(dir, "${ORIGIN}")) {
+        vulns |= VULN_ORIGIN;
+    }
+
+    /* Skip $ORIGIN paths for direct stat checks */
+    if (dir[0] == '$') {
+        return vulns;
+    }
+
+    dir_verdict_t verdict;
+    return vulns | dir_cache_check(&core->dirs, dir, &verdict);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RESULTS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Non-empty components in a colon-separated list */
+static uint32_t count_dirs(const char *list) {
+    uint32_t n = 0;
+    while (list && *(list += strspn(list, ":"))) {
+        list += strcspn(list, ":");
+        n++;
+    }
+    return n;
+}
+
+/*
+ * The result and its arrays in one block from the caller's allocator:
+ *
+ *   [rpath_result_t][needed[n]][resolved[n]?][dirs[ndirs]]
+ */
+static rpath_result_t *result_alloc(rpath_core_t *core, uint32_t nneeded,
+                                    uint32_t ndirs, int resolve) {
+    size_t size = sizeof(rpath_result_t) +
+                  nneeded * sizeof(const char *) +
+                  (resolve ? nneeded * sizeof(rpath_resolved_t) : 0) +
+                  ndirs * sizeof(rpath_dir_t);
+    rpath_result_t *res = core->alloc.alloc(core->alloc.ctx, size);
+    if (!res) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memset(res, 0, size);
+
+    char *p = (char *)(res + 1);
+    res->needed = (const char **)p;
+    p += nneeded * sizeof(*res->needed);
+    if (resolve) {
+        res->resolved = (rpath_resolved_t *)p;
+        p += nneeded * sizeof(*res->resolved);
+    }
+    res->dirs = (rpath_dir_t *)p;
+    return res;
+}
+
+void rpath_result_free(rpath_core_t *core, rpath_result_t *res) {
+    if (res) core->alloc.free(core->alloc.ctx, res);
+}
+
+static const char *intern(rpath_core_t *core, const char *s, size_t len) {
+    str_handle_t h = str_intern_len(&core->strs, s, len);
+    if (h == STR_NONE) errno = ENOMEM;
+    return str_get(&core->strs, h);
+}
+
+/* Intern and judge every component of one list into res->dirs */
+static int check_list(rpath_core_t *core, rpath_result_t *res, const char *tag,
+                      const char *list) {
+    for (int index = 0; list; index++) {
+        const char *p = list + strspn(list, ":");
+        size_t len = strcspn(p, ":");
+        if (!len) break;
+        list = p + len;
+
+        rpath_dir_t *d = &res->dirs[res->dir_count];
+        if (!(d->dir = intern(core, p, len))) return -1;
+        d->tag = tag;
+        d->index = index;
+        d->vulns = rpath_check_dir(core, d->dir);
+        res->verdict |= d->vulns;
+        res->dir_count++;
+    }
+    return 0;
+}
+
+static int check_lists(rpath_core_t *core, rpath_result_t *res,
+                       const char *rpath, const char *runpath) {
+    if (rpath && !(res->rpath = intern(core, rpath, strlen(rpath)))) return -1;
+    if (runpath && !(res->runpath = intern(core, runpath, strlen(runpath)))) return -1;
+    if (check_list(core, res, "DT_RPATH", res->rpath) < 0) return -1;
+    return check_list(core, res, "DT_RUNPATH", res->runpath);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * ANALYSIS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int rpath_analyze_view(rpath_core_t *core, const elf_view_t *view, rpath_result_t **out) {
+    const char *rpath = NULL, *runpath = NULL;
+    uint32_t nneeded = 0;
+
+    /* A static binary, or one without a string table, has nothing to judge */
+    if (view->dynamic && view->dynstr) {
+        if (elf_view_has(view, DT_RPATH)) {
+            rpath = elf_view_dynstr(view, elf_view_dyn(view, DT_RPATH));
+        }
+        if (elf_view_has(view, DT_RUNPATH)) {
+            runpath = elf_view_dynstr(view, elf_view_dyn(view, DT_RUNPATH));
+        }
+        nneeded = view->needed_count;
+    }
+
+    rpath_result_t *res = result_alloc(core, nneeded, count_dirs(rpath) + count_dirs(runpath),
+                                       core->resolve && nneeded);
+    if (!res) return -1;
+    if (check_lists(core, res, rpath, runpath) < 0) goto fail;
+
+    for (size_t i = 0; nneeded && i < view->dyn_count; i++) {
+        const Elf64_Dyn *d = &view->dynamic[i];
+        const char *s;
+        if (d->d_tag != DT_NEEDED || !(s = elf_view_dynstr(view, d->d_un.d_val))) continue;
+        if (!(res->needed[res->needed_count] = intern(core, s, strlen(s)))) goto fail;
+        if (++res->needed_count == nneeded) break;
+    }
+
+    if (res->resolved) {
+        ldso_object_t obj;
+        ldso_object_from_view(&obj, view, NULL);
+        for (uint32_t i = 0; i < res->needed_count; i++) {
+            ldso_result_t r;
+            if (ldso_resolve(&core->ldso, &obj, res->needed[i], &r) == 0) {
+                res->resolved[i].path = r.path;
+                res->resolved[i].source = r.source;
+            }
+        }
+        ldso_object_release(&obj);
+    }
+
+    *out = res;
+    return 0;
+
+fail:
+    rpath_result_free(core, res);
+    errno = ENOMEM;
+    return -1;
+}
+
+/* A result read partly from the zero pages of a truncated file is dropped */
+static int view_done(rpath_core_t *core, const elf_view_t *view, int rc, rpath_result_t **out) {
+    if (rc == 0 && elf_view_truncated(view)) {
+        rpath_result_free(core, *out);
+        *out = NULL;
+        errno = EIO;
+        return -1;
+    }
+    return rc;
+}
+
+int rpath_analyze(rpath_core_t *core, const char *path, rpath_result_t **out) {
+    elf_view_t view;
+    *out = NULL;
+    if (elf_view_open(&view, path) < 0) return -1;
+
+    int rc = view_done(core, &view, rpath_analyze_view(core, &view, out), out);
+    int saved = errno;
+    elf_view_close(&view);
+    errno = saved;
+    return rc;
+}
+
+int rpath_analyze_fd(rpath_core_t *core, int fd, const char *path, rpath_result_t **out) {
+    elf_view_t view;
+    *out = NULL;
+    if (elf_view_open_fd(&view, fd, path) < 0) return -1;
+
+    int rc = view_done(core, &view, rpath_analyze_view(core, &view, out), out);
+    int saved = errno;
+    elf_view_close(&view);
+    errno = saved;
+    return rc;
+}
+
+int rpath_analyze_dyn(rpath_core_t *core, const char *rpath, const char *runpath,
+                      const char *needed, uint32_t needed_count, rpath_result_t **out) {
+    *out = NULL;
+    rpath_result_t *res = result_alloc(core, needed_count,
+                                       count_dirs(rpath) + count_dirs(runpath), 0);
+    if (!res) return -1;
+    if (check_lists(core, res, rpath, runpath) < 0) goto fail;
+
+    for (uint32_t i = 0; i < needed_count; i++) {
+        size_t len = strlen(needed);
+        if (!(res->needed[i] = intern(core, needed, len))) goto fail;
+        needed += len + 1;
+    }
+    res->needed_count = needed_count;
+
+    *out = res;
+    return 0;
+
+fail:
+    rpath_result_free(core, res);
+    errno = ENOMEM;
+    return -1;
+}
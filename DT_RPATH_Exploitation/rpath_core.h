@@ -0,0 +1,127 @@
+/*
+ * rpath_core.h - Reentrant RPATH/RUNPATH analysis core
+ *
+ * Everything rpath_scanner decides about one binary, without printing
+ * anything and without touching process-wide state, so it can be called
+ * from any number of threads at once or linked into another program:
+ *
+ *   rpath_core_t core;                     one per process or per scan;
+ *   rpath_core_init(&core, &opts);         shared by all threads
+ *
+ *   rpath_result_t *res;                   per binary, any thread
+ *   if (rpath_analyze(&core, path, &res) == 0) {
+ *       ... res->dirs[], res->needed[], res->verdict ...
+ *       rpath_result_free(&core, res);
+ *   }
+ *
+ * A result is one block from the caller's allocator. The strings it
+ * points at (lists, directories, sonames, resolved paths) are owned by
+ * the core: they are interned once (str_arena.h) and stay valid until
+ * rpath_core_reset() or rpath_core_destroy(), so a result may outlive
+ * the call that made it but not the core's epoch. The core's own tables
+ * (directory verdicts, interned strings, ld.so memo) use malloc and are
+ * shared by every call.
+ *
+ * Those tables only grow, and a directory verdict is never re-checked.
+ * A long-running embedder starts a new epoch now and then (say, before
+ * each sweep over the host): rpath_core_reset() empties them all, and
+ * reloads ld.so.cache if ldconfig has rewritten it since.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef RPATH_CORE_H
+#define RPATH_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "elf_view.h"
+#include "dir_cache.h"
+#include "str_arena.h"
+#include "ldso.h"
+
+/* Caller-supplied allocator for results; both hooks must be thread-safe */
+typedef struct {
+    void *(*alloc)(void *ctx, size_t size);
+    void  (*free)(void *ctx, void *p);
+    void   *ctx;
+} rpath_alloc_t;
+
+typedef struct {
+    uid_t                uid;               /* user whose write access is judged */
+    int                  resolve;           /* resolve NEEDED like ld.so would */
+    const char          *ld_library_path;   /* for resolution; NULL: none */
+    const rpath_alloc_t *alloc;             /* NULL: malloc/free */
+} rpath_core_opts_t;
+
+/* One component of DT_RPATH or DT_RUNPATH and its verdict */
+typedef struct {
+    const char *tag;            /* "DT_RPATH" or "DT_RUNPATH" */
+    const char *dir;            /* as written, $ORIGIN unexpanded */
+    int         index;          /* position within its list */
+    int         vulns;          /* vuln_type_t bits; 0 = OK */
+} rpath_dir_t;
+
+typedef struct {
+    const char    *path;        /* NULL if not found */
+    ldso_source_t  source;
+} rpath_resolved_t;
+
+typedef struct {
+    const char        *rpath;           /* raw lists; NULL if not set */
+    const char        *runpath;
+    const char       **needed;          /* DT_NEEDED sonames, in order */
+    uint32_t           needed_count;
+    rpath_resolved_t  *resolved;        /* parallel to needed; NULL unless resolving */
+    rpath_dir_t       *dirs;            /* RPATH components, then RUNPATH's */
+    uint32_t           dir_count;
+    int                verdict;         /* OR of every dirs[].vulns */
+} rpath_result_t;
+
+typedef struct {
+    rpath_alloc_t alloc;
+    int           resolve;
+    dir_cache_t   dirs;
+    str_arena_t   strs;
+    ldso_ctx_t    ldso;                 /* only set up when resolving */
+} rpath_core_t;
+
+/* Returns 0, or -1 with errno set */
+int rpath_core_init(rpath_core_t *core, const rpath_core_opts_t *opts);
+void rpath_core_destroy(rpath_core_t *core);
+
+/*
+ * New epoch: forget every directory verdict, interned string and ld.so
+ * memo, and pick up a rewritten ld.so.cache (ldso_reset()). No other call on the core may be in flight, and every result
+ * from the previous epoch must have been freed, as its strings go too.
+ * Returns 0, or -1 with errno set and the core unchanged.
+ */
+int rpath_core_reset(rpath_core_t *core);
+
+/*
+ * Analyze one binary. Returns 0 and a result in *out, or -1 with errno
+ * set (ENOEXEC: not an ELF64 file, EIO: truncated while being read,
+ * ENOMEM). Thread-safe.
+ */
+int rpath_analyze(rpath_core_t *core, const char *path, rpath_result_t **out);
+/* Same, on a descriptor the caller keeps ownership of */
+int rpath_analyze_fd(rpath_core_t *core, int fd, const char *path, rpath_result_t **out);
+/* Same, on a view the caller opened (e.g. ranged, from elf_view_open_batch()) */
+int rpath_analyze_view(rpath_core_t *core, const elf_view_t *view, rpath_result_t **out);
+
+/*
+ * Judge dynamic-section contents that are already known (e.g. from
+ * rpath_cache) without opening the file. needed holds needed_count
+ * NUL-separated sonames, as in rpath_cache_hit_t. Never resolves.
+ */
+int rpath_analyze_dyn(rpath_core_t *core, const char *rpath, const char *runpath,
+                      const char *needed, uint32_t needed_count, rpath_result_t **out);
+
+void rpath_result_free(rpath_core_t *core, rpath_result_t *res);
+
+/* Verdict for a single directory as written in a list; thread-safe */
+int rpath_check_dir(rpath_core_t *core, const char *dir);
+
+#endif /* RPATH_CORE_H */
@@ -9,25 +9,39 @@
  *   3. $ORIGIN paths (exploitable in certain scenarios)
  *   4. Non-existent directories (can be created by attacker)
  *
- * Compile: gcc -o rpath_scanner rpath_scanner.c
+ * Compile: gcc -I../common -pthread -o rpath_scanner rpath_scanner.c \
+ *              rpath_core.c rpath_cache.c dir_cache.c str_arena.c ../common/elf_view.c \
+ *              ../common/read_batch.c ../common/fs_walk.c ../common/task_pool.c \
+ *              ../common/ldso.c ../common/out_sink.c ../common/proc_pool.c
  * Usage:   ./rpath_scanner <binary>
- *          ./rpath_scanner --scan-system
+ *          ./rpath_scanner --scan-system [--threads N] [--cache FILE]
+ *                          [--format text|jsonl|binary] [--read uring|pread|mmap]
+ *                          [--isolate] [root ...]
  *
  * EDUCATIONAL PURPOSES ONLY
  */
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include <unistd.h>
-#include <fcntl.h>
 #include <elf.h>
-#include <sys/mman.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #include <errno.h>
 #include <pwd.h>
+#include <time.h>
+#include <signal.h>
+
+#include "fs_walk.h"
+#include "read_batch.h"
+#include "proc_pool.h"
+#include "rpath_core.h"
+#include "rpath_cache.h"
+#include "out_sink.h"
 
 /* Color codes */
 #define RED     "\033[1;31m"
@@ -37,274 +51,103 @@
 #define CYAN    "\033[1;36m"
 #define RESET   "\033[0m"
 
-/* ═══════════════════════════════════════════════════════════════════════════
- * ELF PARSING
- * ═══════════════════════════════════════════════════════════════════════════ */
-
-typedef struct {
-    char *rpath;
-    char *runpath;
-    char *needed_libs[64];
-    int needed_count;
-} elf_info_t;
-
-int parse_elf(const char *filename, elf_info_t *info) {
-    int fd = open(filename, O_RDONLY);
-    if (fd < 0) {
-        return -1;
-    }
-
-    struct stat st;
-    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(Elf64_Ehdr)) {
-        close(fd);
-        return -1;
-    }
-
-    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-    if (map == MAP_FAILED) {
-        close(fd);
-        return -1;
-    }
-
-    Elf64_Ehdr *ehdr = (Elf64_Ehdr *)map;
-
-    /* Verify ELF magic */
-    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0) {
-        munmap(map, st.st_size);
-        close(fd);
-        return -1;
-    }
-
-    /* Initialize info */
-    memset(info, 0, sizeof(*info));
-
-    /* Find dynamic section */
-    Elf64_Phdr *phdr = (Elf64_Phdr *)((uint8_t *)map + ehdr->e_phoff);
-    Elf64_Dyn *dynamic = NULL;
-    char *strtab = NULL;
-    size_t strtab_size = 0;
-
-    for (int i = 0; i < ehdr->e_phnum; i++) {
-        if (phdr[i].p_type == PT_DYNAMIC) {
-            dynamic = (Elf64_Dyn *)((uint8_t *)map + phdr[i].p_offset);
-            break;
-        }
-    }
-
-    if (!dynamic) {
-        munmap(map, st.st_size);
-        close(fd);
-        return 0;  /* Static binary, no dynamic section */
-    }
-
-    /* Find string table */
-    for (Elf64_Dyn *d = dynamic; d->d_tag != DT_NULL; d++) {
-        if (d->d_tag == DT_STRTAB) {
-            /* Convert virtual address to file offset */
-            for (int i = 0; i < ehdr->e_phnum; i++) {
-                if (phdr[i].p_type == PT_LOAD &&
-                    d->d_un.d_ptr >= phdr[i].p_vaddr &&
-                    d->d_un.d_ptr < phdr[i].p_vaddr + phdr[i].p_filesz) {
-                    size_t offset = d->d_un.d_ptr - phdr[i].p_vaddr + phdr[i].p_offset;
-                    strtab = (char *)map + offset;
-                    break;
-                }
-            }
-        }
-        if (d->d_tag == DT_STRSZ) {
-            strtab_size = d->d_un.d_val;
-        }
-    }
-
-    if (!strtab) {
-        munmap(map, st.st_size);
-        close(fd);
-        return 0;
-    }
-
-    /* Extract RPATH, RUNPATH, and NEEDED entries */
-    for (Elf64_Dyn *d = dynamic; d->d_tag != DT_NULL; d++) {
-        if (d->d_un.d_val < strtab_size) {
-            if (d->d_tag == DT_RPATH) {
-                info->rpath = strdup(strtab + d->d_un.d_val);
-            } else if (d->d_tag == DT_RUNPATH) {
-                info->runpath = strdup(strtab + d->d_un.d_val);
-            } else if (d->d_tag == DT_NEEDED && info->needed_count < 64) {
-                info->needed_libs[info->needed_count++] = strdup(strtab + d->d_un.d_val);
-            }
-        }
-    }
-
-    munmap(map, st.st_size);
-    close(fd);
-    return 0;
-}
-
-void free_elf_info(elf_info_t *info) {
-    if (info->rpath) free(info->rpath);
-    if (info->runpath) free(info->runpath);
-    for (int i = 0; i < info->needed_count; i++) {
-        if (info->needed_libs[i]) free(info->needed_libs[i]);
-    }
-}
+#define MAX_ROOTS   256         /* files or directories given to --scan-system */
 
 /* ═══════════════════════════════════════════════════════════════════════════
- * VULNERABILITY CHECKS
+ * REPORTING
  * ═══════════════════════════════════════════════════════════════════════════ */
 
-typedef enum {
-    VULN_NONE = 0,
-    VULN_WRITABLE = 1,
-    VULN_RELATIVE = 2,
-    VULN_ORIGIN = 4,
-    VULN_NONEXISTENT = 8,
-    VULN_WORLD_WRITABLE = 16
-} vuln_type_t;
-
-int check_path_vulnerability(const char *path, uid_t uid) {
-    int vulns = VULN_NONE;
-
-    /* Check for relative path */
-    if (path[0] != '/' && strncmp(path, "$ORIGIN", 7) != 0) {
-        vulns |= VULN_RELATIVE;
-    }
-
-    /* Check for $ORIGIN */
-    if (strstr(path, "$ORIGIN") || strstr(path, "${ORIGIN}")) {
-        vulns |= VULN_ORIGIN;
-    }
-
-    /* Skip $ORIGIN paths for direct stat checks */
-    if (path[0] == '$') {
-        return vulns;
-    }
-
-    struct stat st;
-    if (stat(path, &st) < 0) {
-        if (errno == ENOENT) {
-            vulns |= VULN_NONEXISTENT;
-
-            /* Check if parent directory is writable */
-            char parent[PATH_MAX];
-            strncpy(parent, path, sizeof(parent) - 1);
-            char *slash = strrchr(parent, '/');
-            if (slash && slash != parent) {
-                *slash = '\0';
-                if (access(parent, W_OK) == 0) {
-                    vulns |= VULN_WRITABLE;
-                }
-            }
-        }
-    } else {
-        /* Directory exists - check permissions */
-        if (st.st_mode & S_IWOTH) {
-            vulns |= VULN_WORLD_WRITABLE;
-        }
-        if (st.st_uid == uid && (st.st_mode & S_IWUSR)) {
-            vulns |= VULN_WRITABLE;
-        }
-        if (access(path, W_OK) == 0) {
-            vulns |= VULN_WRITABLE;
-        }
-    }
-
-    return vulns;
-}
-
-void print_vulnerability(const char *path, int vulns) {
-    printf("    ");
+void print_vulnerability(FILE *out, const char *path, int vulns) {
+    fprintf(out, "    ");
 
     if (vulns & VULN_WORLD_WRITABLE) {
-        printf(RED "WORLD-WRITABLE" RESET " ");
+        fprintf(out, RED "WORLD-WRITABLE" RESET " ");
     }
     if (vulns & VULN_WRITABLE) {
-        printf(RED "USER-WRITABLE" RESET " ");
+        fprintf(out, RED "USER-WRITABLE" RESET " ");
+    }
+    if (vulns & VULN_PARENT_WRITABLE) {
+        fprintf(out, RED "WRITABLE-PARENT" RESET " ");
     }
     if (vulns & VULN_NONEXISTENT) {
-        printf(YELLOW "NON-EXISTENT" RESET " ");
+        fprintf(out, YELLOW "NON-EXISTENT" RESET " ");
     }
     if (vulns & VULN_RELATIVE) {
-        printf(YELLOW "RELATIVE-PATH" RESET " ");
+        fprintf(out, YELLOW "RELATIVE-PATH" RESET " ");
     }
     if (vulns & VULN_ORIGIN) {
-        printf(CYAN "$ORIGIN" RESET " ");
+        fprintf(out, CYAN "$ORIGIN" RESET " ");
     }
 
-    printf("→ %s\n", path);
+    fprintf(out, "→ %s\n", path);
+}
+
+/* Print the verdict for every component of one list (tag) of a result */
+void print_dirs(FILE *out, const rpath_result_t *res, const char *tag, int show_ok) {
+    for (uint32_t i = 0; i < res->dir_count; i++) {
+        const rpath_dir_t *d = &res->dirs[i];
+        if (strcmp(d->tag, tag) != 0) continue;
+        if (d->vulns) {
+            print_vulnerability(out, d->dir, d->vulns);
+        } else if (show_ok) {
+            fprintf(out, "    " GREEN "OK" RESET " → %s\n", d->dir);
+        }
+    }
 }
 
 /* ═══════════════════════════════════════════════════════════════════════════
  * ANALYSIS
  * ═══════════════════════════════════════════════════════════════════════════ */
 
-void analyze_binary(const char *filename) {
-    elf_info_t info;
+void analyze_binary(rpath_core_t *core, const char *filename) {
+    rpath_result_t *res;
 
-    if (parse_elf(filename, &info) < 0) {
+    if (rpath_analyze(core, filename, &res) < 0) {
         fprintf(stderr, RED "[!]" RESET " Failed to parse: %s\n", filename);
         return;
     }
 
-    uid_t uid = getuid();
-    int has_vulns = 0;
-
     printf("\n");
     printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
     printf(CYAN "  ANALYZING: %s\n" RESET, filename);
     printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
 
     /* Analyze DT_RPATH */
-    if (info.rpath) {
+    if (res->rpath) {
         printf("\n" YELLOW "[DT_RPATH]" RESET " (searched BEFORE LD_LIBRARY_PATH):\n");
-
-        char *path = strtok(strdup(info.rpath), ":");
-        while (path) {
-            int vulns = check_path_vulnerability(path, uid);
-            if (vulns) {
-                has_vulns = 1;
-                print_vulnerability(path, vulns);
-            } else {
-                printf("    " GREEN "OK" RESET " → %s\n", path);
-            }
-            path = strtok(NULL, ":");
-        }
+        print_dirs(stdout, res, "DT_RPATH", 1);
     } else {
         printf("\n" GREEN "[DT_RPATH]" RESET " Not set\n");
     }
 
     /* Analyze DT_RUNPATH */
-    if (info.runpath) {
+    if (res->runpath) {
         printf("\n" YELLOW "[DT_RUNPATH]" RESET " (searched AFTER LD_LIBRARY_PATH):\n");
-
-        char *path = strtok(strdup(info.runpath), ":");
-        while (path) {
-            int vulns = check_path_vulnerability(path, uid);
-            if (vulns) {
-                has_vulns = 1;
-                print_vulnerability(path, vulns);
-            } else {
-                printf("    " GREEN "OK" RESET " → %s\n", path);
-            }
-            path = strtok(NULL, ":");
-        }
+        print_dirs(stdout, res, "DT_RUNPATH", 1);
     } else {
         printf("\n" GREEN "[DT_RUNPATH]" RESET " Not set\n");
     }
 
     /* Show needed libraries */
-    if (info.needed_count > 0) {
-        printf("\n[NEEDED LIBRARIES] (%d total):\n", info.needed_count);
-        for (int i = 0; i < info.needed_count && i < 10; i++) {
-            printf("    • %s\n", info.needed_libs[i]);
+    if (res->needed_count > 0) {
+        printf("\n[NEEDED LIBRARIES] (%u total):\n", res->needed_count);
+        for (uint32_t i = 0; i < res->needed_count && i < 10; i++) {
+            const rpath_resolved_t *r = &res->resolved[i];
+            if (r->path) {
+                printf("    • %-24s → %s " CYAN "(%s)" RESET "\n", res->needed[i],
+                       r->path, ldso_source_name(r->source));
+            } else {
+                printf("    • %-24s → " RED "NOT FOUND" RESET "\n", res->needed[i]);
+            }
         }
-        if (info.needed_count > 10) {
-            printf("    ... and %d more\n", info.needed_count - 10);
+        if (res->needed_count > 10) {
+            printf("    ... and %u more\n", res->needed_count - 10);
         }
     }
 
     /* Summary */
     printf("\n");
-    if (has_vulns) {
+    if (res->verdict) {
         printf(RED "╔════════════════════════════════════════════════════════════════╗\n" RESET);
         printf(RED "║" RESET "  " RED "⚠ POTENTIALLY EXPLOITABLE RPATH/RUNPATH DETECTED!" RESET "          " RED "║\n" RESET);
         printf(RED "║" RESET "                                                               " RED "║\n" RESET);
@@ -315,7 +158,7 @@ void analyze_binary(const char *filename) {
         printf(GREEN "[✓] No obvious RPATH/RUNPATH vulnerabilities found.\n" RESET);
     }
 
-    free_elf_info(&info);
+    rpath_result_free(core, res);
 }
 
 /* ═══════════════════════════════════════════════════════════════════════════
@@ -351,22 +194,737 @@ void print_search_order(void) {
     printf("\n");
 }
 
+/* ═══════════════════════════════════════════════════════════════════════════
+ * SYSTEM SCAN (parallel)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* How binaries are read (--read) */
+typedef enum {
+    READ_URING,                 /* ranged views, batched through io_uring */
+    READ_PREAD,                 /* ranged views, one pread() per piece */
+    READ_MMAP,                  /* map every file whole */
+} read_mode_t;
+
+#define READ_DEPTH  128         /* reads in flight per worker */
+
+#define ISOLATE_TIMEOUT_MS  10000   /* a parse taking longer is a hang */
+#define ISOLATE_REPLY_MAX   65536   /* dynamic strings of one binary */
+#define ISOLATE_DIRS_MAX    1024    /* directories its RPATH and RUNPATH may name */
+
+/* --isolate: this walker thread's parser process and its reply buffers */
+typedef struct {
+    proc_worker_t proc;
+    char          replies[FS_WALK_BATCH][ISOLATE_REPLY_MAX];
+} isolated_t;
+
+typedef struct {
+    rpath_core_t core;          /* directory verdicts and strings, shared by all threads */
+    rpath_cache_t *cache;       /* NULL unless --cache was given */
+    out_sink_t *sink;           /* NULL for the text report */
+    read_mode_t read_mode;
+    read_batch_t *readers[FS_WALK_MAX_THREADS];     /* one per worker, made on first use */
+    int isolate;                /* parse in forked workers (--isolate) */
+    isolated_t *isolated[FS_WALK_MAX_THREADS];      /* likewise */
+    unsigned long io_reads;     /* pieces read into ranged views */
+    uint64_t io_bytes;
+    unsigned long elf_files;
+    unsigned long with_paths;
+    unsigned long flagged;
+    unsigned long failed;
+    unsigned long crashed;      /* files a worker died or hung on */
+} scan_ctx_t;
+
+/* Directories scanned when --scan-system is given no roots */
+static const char *default_roots[] = {
+    "/usr", "/opt", "/bin", "/sbin", "/lib", "/lib64", NULL
+};
+
+#define COUNT(field) __atomic_fetch_add(&ctx->field, 1, __ATOMIC_RELAXED)
+
+/* Names of the bits in a verdict, for machine-readable records */
+static size_t vuln_names(int vulns, const char *names[6]) {
+    size_t n = 0;
+    if (vulns & VULN_WORLD_WRITABLE)  names[n++] = "world-writable";
+    if (vulns & VULN_WRITABLE)        names[n++] = "user-writable";
+    if (vulns & VULN_PARENT_WRITABLE) names[n++] = "writable-parent";
+    if (vulns & VULN_NONEXISTENT)     names[n++] = "non-existent";
+    if (vulns & VULN_RELATIVE)        names[n++] = "relative";
+    if (vulns & VULN_ORIGIN)          names[n++] = "origin";
+    return n;
+}
+
+/* print_dirs() for --format: one "finding" record per flagged directory */
+static void emit_findings(scan_ctx_t *ctx, const char *binary, const rpath_result_t *res) {
+    for (uint32_t i = 0; i < res->dir_count; i++) {
+        const rpath_dir_t *d = &res->dirs[i];
+        if (!d->vulns) continue;
+
+        char key[PATH_MAX + 32];
+        const char *names[6];
+        snprintf(key, sizeof(key), "%s\x1f%s\x1f%03d", binary, d->tag, d->index);
+        out_begin(ctx->sink, "finding", key);
+        out_str(ctx->sink, "path", binary);
+        out_str(ctx->sink, "tag", d->tag);
+        out_str(ctx->sink, "dir", d->dir);
+        out_int(ctx->sink, "vulns", d->vulns);
+        out_strv(ctx->sink, "flags", names, vuln_names(d->vulns, names));
+        out_end(ctx->sink);
+    }
+}
+
+/*
+ * A cached verdict for fd's file: 1 and *res if the cache has one, 0 if
+ * not (key filled in when the file could be identified), -1 on failure.
+ */
+static int cache_lookup(scan_ctx_t *ctx, int fd, rpath_cache_key_t *key, int *have_key,
+                        rpath_result_t **res) {
+    struct stat st;
+    rpath_cache_hit_t hit;
+
+    *have_key = 0;
+    if (fstat(fd, &st) < 0) return 0;
+    rpath_cache_key(&st, key);
+    *have_key = 1;
+    if (!rpath_cache_lookup(ctx->cache, key, &hit)) return 0;
+    return rpath_analyze_dyn(&ctx->core, hit.rpath, hit.runpath, hit.needed,
+                             hit.needed_count, res) < 0 ? -1 : 1;
+}
+
+/* Count, print or emit one analyzed binary, remember it, and free res */
+static void report_binary(scan_ctx_t *ctx, const char *path, rpath_result_t *res,
+                          int cached, const rpath_cache_key_t *key) {
+    COUNT(elf_files);
+
+    if (ctx->sink) {
+        if (res->rpath || res->runpath) COUNT(with_paths);
+        emit_findings(ctx, path, res);
+        if (res->verdict) COUNT(flagged);
+
+        const char *names[6];
+        out_begin(ctx->sink, "binary", path);
+        out_str(ctx->sink, "path", path);
+        out_str(ctx->sink, "rpath", res->rpath);
+        out_str(ctx->sink, "runpath", res->runpath);
+        out_strv(ctx->sink, "needed", res->needed, res->needed_count);
+        out_int(ctx->sink, "vulns", res->verdict);
+        out_strv(ctx->sink, "flags", names, vuln_names(res->verdict, names));
+        out_bool(ctx->sink, "cached", cached);
+        out_end(ctx->sink);
+    } else if (res->rpath || res->runpath) {
+        COUNT(with_paths);
+
+        if (res->verdict) {
+            char *report = NULL;
+            size_t report_len = 0;
+            FILE *out = open_memstream(&report, &report_len);
+
+            if (out) {
+                if (res->rpath) {
+                    fprintf(out, "  " YELLOW "DT_RPATH:" RESET "\n");
+                    print_dirs(out, res, "DT_RPATH", 0);
+                }
+                if (res->runpath) {
+                    fprintf(out, "  " YELLOW "DT_RUNPATH:" RESET "\n");
+                    print_dirs(out, res, "DT_RUNPATH", 0);
+                }
+                fclose(out);
+            }
+
+            COUNT(flagged);
+            flockfile(stdout);
+            printf(RED "[!]" RESET " %s\n%s", path, report ? report : "");
+            funlockfile(stdout);
+            free(report);
+        }
+    }
+
+    if (ctx->cache && key) {
+        rpath_cache_add(ctx->cache, key, path, res->rpath, res->runpath, res->needed,
+                        res->needed_count, res->verdict);
+    }
+
+    rpath_result_free(&ctx->core, res);
+}
+
+/*
+ * fs_walk callback for --read mmap, runs on the worker threads. Only
+ * binaries that actually carry an RPATH/RUNPATH are checked, and only
+ * flagged ones are printed: the report is built privately and written
+ * in one go so output from different threads never interleaves.
+ *
+ * With a cache, an unchanged file (same dev/ino/size/mtime/ctime) is
+ * not mapped or parsed at all. Its directories are still re-checked,
+ * since their permissions are not part of the binary's identity.
+ */
+void scan_binary(const char *path, int fd, void *arg) {
+    scan_ctx_t *ctx = arg;
+    rpath_result_t *res = NULL;
+    rpath_cache_key_t key;
+    int have_key = 0, cached = 0;
+
+    if (ctx->cache) {
+        cached = cache_lookup(ctx, fd, &key, &have_key, &res);
+        if (cached < 0) {
+            COUNT(failed);
+            return;
+        }
+    }
+
+    if (!cached && rpath_analyze_fd(&ctx->core, fd, path, &res) < 0) {
+        COUNT(failed);
+        return;
+    }
+    report_binary(ctx, path, res, cached, have_key ? &key : NULL);
+}
+
+/* This worker's reader, set up on its first batch */
+static read_batch_t *reader_of(scan_ctx_t *ctx, int worker) {
+    read_batch_t *rb = ctx->readers[worker];
+    if (!rb && (rb = malloc(sizeof(*rb))) != NULL) {
+        read_batch_init(rb, READ_DEPTH, ctx->read_mode == READ_URING);
+        ctx->readers[worker] = rb;
+    }
+    return rb;
+}
+
+/*
+ * fs_walk batch callback for --read uring/pread: the same work as
+ * scan_binary(), but the headers of every uncached file in the batch
+ * are read together (elf_view_open_batch) and nothing is mapped.
+ */
+static void scan_batch(int worker, const fs_walk_file_t *files, int n, void *arg) {
+    scan_ctx_t *ctx = arg;
+    read_batch_t *rb = reader_of(ctx, worker);
+    elf_view_batch_t todo[FS_WALK_BATCH];
+    rpath_cache_key_t keys[FS_WALK_BATCH];
+    int have_key[FS_WALK_BATCH];
+    int k = 0;
+
+    if (!rb) {
+        for (int i = 0; i < n; i++) scan_binary(files[i].path, files[i].fd, ctx);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        rpath_result_t *res;
+        int hit = 0;
+
+        have_key[k] = 0;
+        if (ctx->cache) {
+            hit = cache_lookup(ctx, files[i].fd, &keys[k], &have_key[k], &res);
+        }
+        if (hit < 0) {
+            COUNT(failed);
+        } else if (hit) {
+            report_binary(ctx, files[i].path, res, 1, have_key[k] ? &keys[k] : NULL);
+        } else {
+            todo[k].fd = files[i].fd;
+            todo[k++].path = files[i].path;
+        }
+    }
+
+    elf_view_open_batch(todo, k, rb);
+
+    for (int j = 0; j < k; j++) {
+        rpath_result_t *res;
+
+        /* Files without the magic are what elf_only skips on the mmap path */
+        if (todo[j].err) {
+            if (todo[j].is_elf) {
+                COUNT(failed);
+            } else if (have_key[j]) {
+                /* ...so their cache lookup is not a miss either */
+                __atomic_fetch_sub(&ctx->cache->misses, 1, __ATOMIC_RELAXED);
+            }
+            continue;
+        }
+
+        unsigned long reads;
+        uint64_t bytes;
+        int rc = rpath_analyze_view(&ctx->core, &todo[j].view, &res);
+        elf_view_io_stats(&todo[j].view, &reads, &bytes);
+        __atomic_fetch_add(&ctx->io_reads, reads, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ctx->io_bytes, bytes, __ATOMIC_RELAXED);
+        elf_view_close(&todo[j].view);
+
+        if (rc < 0) {
+            COUNT(failed);
+            continue;
+        }
+        report_binary(ctx, todo[j].path, res, 0, have_key[j] ? &keys[j] : NULL);
+    }
+}
+
+/*
+ * What a --isolate worker sends back for one file: the dynamic strings
+ * rpath_analyze_view() would judge, judged by the parent instead with
+ * rpath_analyze_dyn(), the way a cache hit is.
+ */
+typedef struct {
+    int32_t  err;               /* 0, or the errno opening or reading it failed with */
+    uint32_t has_rpath;
+    uint32_t has_runpath;
+    uint32_t needed_count;
+    uint32_t reads;             /* pieces read into a ranged view */
+    uint64_t bytes;
+    char     strings[];         /* rpath, runpath (if present), then the sonames, NUL-terminated */
+} dyn_reply_t;
+
+/* Append s and its NUL; 0, or -1 when it does not fit */
+static int reply_put(char *reply, size_t cap, size_t *len, const char *s) {
+    size_t n = strlen(s) + 1;
+    if (n > cap - *len) return -1;
+    memcpy(reply + *len, s, n);
+    *len += n;
+    return 0;
+}
+
+/* The dynamic strings of an opened view, as rpath_analyze_view() picks them */
+static ssize_t reply_strings(const elf_view_t *v, char *reply, size_t cap) {
+    dyn_reply_t *r = (dyn_reply_t *)reply;
+    const char *rpath = NULL, *runpath = NULL;
+    size_t len = sizeof(*r);
+
+    if (!v->dynamic || !v->dynstr) return len;
+    if (elf_view_has(v, DT_RPATH)) rpath = elf_view_dynstr(v, elf_view_dyn(v, DT_RPATH));
+    if (elf_view_has(v, DT_RUNPATH)) runpath = elf_view_dynstr(v, elf_view_dyn(v, DT_RUNPATH));
+    if ((rpath && reply_put(reply, cap, &len, rpath) < 0) ||
+        (runpath && reply_put(reply, cap, &len, runpath) < 0)) {
+        goto full;
+    }
+    r->has_rpath = rpath != NULL;
+    r->has_runpath = runpath != NULL;
+
+    for (size_t i = 0; i < v->dyn_count && r->needed_count < (uint32_t)v->needed_count; i++) {
+        const char *s;
+        if (v->dynamic[i].d_tag != DT_NEEDED ||
+            !(s = elf_view_dynstr(v, v->dynamic[i].d_un.d_val))) {
+            continue;
+        }
+        if (reply_put(reply, cap, &len, s) < 0) goto full;
+        r->needed_count++;
+    }
+    return len;
+
+full:
+    errno = E2BIG;
+    return -1;
+}
+
+/* The string at *p, which must end before end; steps *p past it */
+static const char *reply_next(const char **p, const char *end) {
+    const char *s = *p, *nul = memchr(s, '\0', end - s);
+    if (!nul) return NULL;
+    *p = nul + 1;
+    return s;
+}
+
+/* Adds the directories of list to *ndirs; -1 if one is PATH_MAX or longer */
+static int reply_dirs(const char *list, uint32_t *ndirs) {
+    while (list && *(list += strspn(list, ":"))) {
+        size_t n = strcspn(list, ":");
+        if (n >= PATH_MAX) return -1;
+        list += n;
+        (*ndirs)++;
+    }
+    return 0;
+}
+
+/*
+ * The parent's reading of a reply of len bytes. The worker is the
+ * parser that may have gone wrong, so nothing it says is believed:
+ * every string must end inside the reply, needed_count strings must be
+ * there, and the search lists may name at most ISOLATE_DIRS_MAX
+ * directories, each shorter than PATH_MAX, before the parent's
+ * dir_cache judges them. 0, or -1 with errno EPROTO.
+ */
+static int reply_parse(const dyn_reply_t *r, size_t len, const char **rpath,
+                       const char **runpath, const char **needed) {
+    const char *p = r->strings, *end = (const char *)r + len;
+    uint32_t ndirs = 0;
+
+    *rpath = *runpath = NULL;
+    if ((r->has_rpath && !(*rpath = reply_next(&p, end))) ||
+        (r->has_runpath && !(*runpath = reply_next(&p, end))) ||
+        reply_dirs(*rpath, &ndirs) < 0 || reply_dirs(*runpath, &ndirs) < 0 ||
+        ndirs > ISOLATE_DIRS_MAX) {
+        goto bad;
+    }
+    *needed = p;
+    for (uint32_t i = 0; i < r->needed_count; i++) {
+        if (!reply_next(&p, end)) goto bad;
+    }
+    return 0;
+
+bad:
+    errno = EPROTO;
+    return -1;
+}
+
+/*
+ * proc_pool_fn for --isolate: runs in the worker process, on a file
+ * the parent has seen the ELF magic of. It is opened the way --read
+ * says (a one-file batch for the ranged modes), so it parses or fails
+ * exactly as it would in the parent.
+ */
+static ssize_t parse_isolated(int fd, const char *path, void *reply, size_t cap, void *arg) {
+    const scan_ctx_t *ctx = arg;
+    static read_batch_t rb;             /* per worker process; the parent never calls this */
+    static int rb_ready;
+    dyn_reply_t *r = reply;
+    elf_view_batch_t b = { .fd = fd, .path = path };
+
+    memset(r, 0, sizeof(*r));
+    if (ctx->read_mode == READ_MMAP) {
+        if (elf_view_open_fd(&b.view, fd, path) < 0) b.err = errno;
+    } else {
+        if (!rb_ready) rb_ready = read_batch_init(&rb, READ_DEPTH, 0) == 0;
+        elf_view_open_batch(&b, 1, &rb);
+    }
+
+    r->err = b.err;
+    if (b.err) return sizeof(*r);
+
+    unsigned long reads;
+    ssize_t len = reply_strings(&b.view, reply, cap);
+    elf_view_io_stats(&b.view, &reads, &r->bytes);
+    r->reads = reads;
+    if (len >= 0 && elf_view_truncated(&b.view)) {
+        r->err = EIO;
+        len = sizeof(*r);
+    }
+    elf_view_close(&b.view);
+    return len;
+}
+
+/* This worker's parser process, set up on its first batch */
+static isolated_t *isolated_of(scan_ctx_t *ctx, int worker) {
+    isolated_t *iso = ctx->isolated[worker];
+    if (!iso && (iso = malloc(sizeof(*iso))) != NULL) {
+        proc_worker_init(&iso->proc, parse_isolated, ctx, ISOLATE_REPLY_MAX, ISOLATE_TIMEOUT_MS);
+        ctx->isolated[worker] = iso;
+    }
+    return iso;
+}
+
+/* The file a worker died or hung on: counted, and recorded by name */
+static void report_crash(scan_ctx_t *ctx, const proc_job_t *job) {
+    char why[32];
+
+    COUNT(crashed);
+    if (job->err == ETIMEDOUT) {
+        snprintf(why, sizeof(why), "timeout");
+    } else if (job->sig) {
+        snprintf(why, sizeof(why), "SIG%s", sigabbrev_np(job->sig) ? sigabbrev_np(job->sig) : "?");
+    } else {
+        snprintf(why, sizeof(why), "exit");
+    }
+
+    if (ctx->sink) {
+        out_begin(ctx->sink, "crash", job->path);
+        out_str(ctx->sink, "path", job->path);
+        out_str(ctx->sink, "reason", why);
+        out_end(ctx->sink);
+    } else {
+        flockfile(stderr);
+        fprintf(stderr, RED "[!]" RESET " Parser %s on %s, worker restarted\n",
+                job->err == ETIMEDOUT ? "hung" : "crashed", job->path);
+        funlockfile(stderr);
+    }
+}
+
+/*
+ * fs_walk batch callback for --isolate: scan_batch() with the parsing
+ * moved into this worker's own process (proc_pool.h). A file that
+ * crashes or hangs the parser costs a restart of that process and is
+ * reported; the scan carries on with the next file.
+ */
+static void scan_isolated(int worker, const fs_walk_file_t *files, int n, void *arg) {
+    scan_ctx_t *ctx = arg;
+    isolated_t *iso = isolated_of(ctx, worker);
+    proc_job_t jobs[FS_WALK_BATCH];
+    rpath_cache_key_t keys[FS_WALK_BATCH];
+    int have_key[FS_WALK_BATCH];
+    int k = 0;
+
+    if (!iso) {
+        scan_batch(worker, files, n, ctx);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        rpath_result_t *res;
+        unsigned char magic[SELFMAG];
+        int hit = 0;
+
+        /* The magic is read here: a round trip per non-ELF file would cost more */
+        if (pread(files[i].fd, magic, SELFMAG, 0) != SELFMAG ||
+            memcmp(magic, ELFMAG, SELFMAG) != 0) {
+            continue;
+        }
+
+        have_key[k] = 0;
+        if (ctx->cache) {
+            hit = cache_lookup(ctx, files[i].fd, &keys[k], &have_key[k], &res);
+        }
+        if (hit < 0) {
+            COUNT(failed);
+        } else if (hit) {
+            report_binary(ctx, files[i].path, res, 1, have_key[k] ? &keys[k] : NULL);
+        } else {
+            jobs[k] = (proc_job_t){ .fd = files[i].fd, .path = files[i].path,
+                                    .reply = iso->replies[k] };
+            k++;
+        }
+    }
+
+    proc_worker_run(&iso->proc, jobs, k);
+
+    for (int j = 0; j < k; j++) {
+        const dyn_reply_t *r = jobs[j].reply;
+        rpath_result_t *res;
+
+        if (jobs[j].err == ECHILD || jobs[j].err == ETIMEDOUT) {
+            report_crash(ctx, &jobs[j]);
+            COUNT(failed);
+            continue;
+        }
+        if (jobs[j].err || jobs[j].len < sizeof(*r)) {
+            COUNT(failed);
+            continue;
+        }
+        __atomic_fetch_add(&ctx->io_reads, r->reads, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ctx->io_bytes, r->bytes, __ATOMIC_RELAXED);
+
+        const char *rpath, *runpath, *needed;
+        if (r->err || reply_parse(r, jobs[j].len, &rpath, &runpath, &needed) < 0) {
+            COUNT(failed);
+            continue;
+        }
+
+        if (rpath_analyze_dyn(&ctx->core, rpath, runpath, needed, r->needed_count, &res) < 0) {
+            COUNT(failed);
+            continue;
+        }
+        report_binary(ctx, jobs[j].path, res, 0, have_key[j] ? &keys[j] : NULL);
+    }
+}
+
+int scan_system(int argc, char *argv[]) {
+    const char *roots[MAX_ROOTS];
+    const char *cache_file = NULL;
+    int nroots = 0;
+    int nthreads = 0;
+    out_format_t format = OUT_TEXT;
+    read_mode_t read_mode = READ_URING;
+    int isolate = 0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            nthreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache_file = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (out_format_parse(argv[++i], &format) < 0) {
+                fprintf(stderr, RED "[!]" RESET " Unknown format: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--read") == 0 && i + 1 < argc) {
+            const char *m = argv[++i];
+            if (strcmp(m, "uring") == 0) read_mode = READ_URING;
+            else if (strcmp(m, "pread") == 0) read_mode = READ_PREAD;
+            else if (strcmp(m, "mmap") == 0) read_mode = READ_MMAP;
+            else {
+                fprintf(stderr, RED "[!]" RESET " Unknown read mode: %s\n", m);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--isolate") == 0) {
+            isolate = 1;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, RED "[!]" RESET " Unknown option (or missing argument): %s\n", argv[i]);
+            return 2;
+        } else if (nroots < MAX_ROOTS) {
+            roots[nroots++] = argv[i];
+        } else {
+            fprintf(stderr, RED "[!]" RESET " --scan-system takes at most %d files or directories\n", MAX_ROOTS);
+            return 2;
+        }
+    }
+
+    /* Default roots; skip the legacy top-level dirs when they are just
+     * symlinks into /usr (merged-/usr systems) to avoid scanning twice */
+    if (nroots == 0) {
+        for (int i = 0; default_roots[i]; i++) {
+            struct stat st;
+            if (lstat(default_roots[i], &st) == 0 && S_ISDIR(st.st_mode)) {
+                roots[nroots++] = default_roots[i];
+            }
+        }
+    }
+
+    scan_ctx_t ctx = { .read_mode = read_mode, .isolate = isolate };
+    rpath_cache_t cache;
+    out_sink_t sink;
+
+    rpath_core_opts_t core_opts = { .uid = getuid() };
+    if (rpath_core_init(&ctx.core, &core_opts) < 0) {
+        fprintf(stderr, RED "[!]" RESET " Out of memory\n");
+        return 2;
+    }
+
+    /* Records go to stdout in path order; the human summary moves to stderr */
+    FILE *report = stdout;
+    if (format != OUT_TEXT) {
+        fflush(stdout);
+        if (out_sink_open(&sink, STDOUT_FILENO, format, 1) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Cannot write output: %s\n", strerror(errno));
+            rpath_core_destroy(&ctx.core);
+            return 2;
+        }
+        ctx.sink = &sink;
+        report = stderr;
+    }
+
+    if (cache_file) {
+        if (rpath_cache_load(&cache, cache_file) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Cannot read cache %s, rebuilding\n", cache_file);
+        }
+        ctx.cache = &cache;
+    }
+    fs_walk_opts_t opts = {
+        .roots = roots,
+        .nroots = nroots,
+        .nthreads = nthreads > 0 ? nthreads : fs_walk_default_threads(),
+        .elf_only = 1,
+        .fn = scan_binary,
+        .batch_fn = isolate ? scan_isolated : read_mode == READ_MMAP ? NULL : scan_batch,
+        .arg = &ctx,
+    };
+    fs_walk_stats_t stats;
+
+    fprintf(report, "\n" CYAN "[*]" RESET " Scanning");
+    for (int i = 0; i < nroots; i++) fprintf(report, " %s", roots[i]);
+    fprintf(report, " with %d threads...\n\n", opts.nthreads);
+    fflush(report);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    fs_walk(&opts, &stats);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    fprintf(report, "\n");
+    fprintf(report, CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    fprintf(report, CYAN "  SCAN SUMMARY\n" RESET);
+    fprintf(report, CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    fprintf(report, "  Directories walked:     %lu\n", stats.dirs);
+    fprintf(report, "  Regular files seen:     %lu\n", stats.files);
+    fprintf(report, "  ELF files parsed:       %lu\n", ctx.elf_files);
+    fprintf(report, "  With RPATH/RUNPATH:     %lu\n", ctx.with_paths);
+    fprintf(report, "  Flagged:                %s%lu" RESET "\n",
+           ctx.flagged ? RED : GREEN, ctx.flagged);
+    fprintf(report, "  Unreadable / malformed: %lu\n", stats.errors + ctx.failed);
+    fprintf(report, "  Elapsed:                %.2f s (%.0f files/s)\n",
+           secs, secs > 0 ? stats.files / secs : 0.0);
+    fprintf(report, "  Directories checked:    %zu (%lu cached lookups)\n",
+           dir_cache_size(&ctx.core.dirs), ctx.core.dirs.hits);
+    fprintf(report, "  Strings interned:       %lu unique, %.1f KiB (of %lu occurrences)\n",
+           ctx.core.strs.unique, ctx.core.strs.bytes / 1024.0, ctx.core.strs.lookups);
+
+    if (read_mode != READ_MMAP) {
+        const char *backend = NULL;
+        unsigned long enters = 0;
+        for (int i = 0; i < FS_WALK_MAX_THREADS; i++) {
+            read_batch_t *rb = ctx.readers[i];
+            if (!rb) continue;
+            if (!backend || rb->ring_fd < 0) backend = read_batch_backend(rb);
+            enters += rb->enters;
+            read_batch_destroy(rb);
+            free(rb);
+        }
+        if (isolate) {
+            fprintf(report, "  Header reads:           %lu, %.1f MiB (pread, in the parser processes)\n",
+                    ctx.io_reads, ctx.io_bytes / 1048576.0);
+        } else {
+            fprintf(report, "  Header reads:           %lu, %.1f MiB (%s, %lu submissions)\n",
+                    ctx.io_reads, ctx.io_bytes / 1048576.0, backend ? backend : "none", enters);
+        }
+    }
+
+    if (isolate) {
+        unsigned long forks = 0, crashes = 0, timeouts = 0;
+        for (int i = 0; i < FS_WALK_MAX_THREADS; i++) {
+            isolated_t *iso = ctx.isolated[i];
+            if (!iso) continue;
+            forks += iso->proc.forks;
+            crashes += iso->proc.crashes;
+            timeouts += iso->proc.timeouts;
+            proc_worker_destroy(&iso->proc);
+            free(iso);
+        }
+        fprintf(report, "  Parser processes:       %lu started (%lu crashed, %lu hung)\n",
+                forks, crashes, timeouts);
+    }
+
+    if (ctx.cache) {
+        fprintf(report, "  Cache hits / misses:    %lu / %lu\n", cache.hits, cache.misses);
+        if (rpath_cache_save(&cache) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Failed to write cache %s: %s\n",
+                    cache_file, strerror(errno));
+        }
+        rpath_cache_close(&cache);
+    }
+
+    if (ctx.sink) {
+        fprintf(report, "  Records written:        %lu\n", sink.records + 1);
+
+        out_begin(&sink, "summary", "\x7f");
+        out_int(&sink, "dirs", stats.dirs);
+        out_int(&sink, "files", stats.files);
+        out_int(&sink, "elf_files", ctx.elf_files);
+        out_int(&sink, "with_paths", ctx.with_paths);
+        out_int(&sink, "flagged", ctx.flagged);
+        out_int(&sink, "unreadable", stats.errors + ctx.failed);
+        if (isolate) out_int(&sink, "crashed", ctx.crashed);
+        out_end(&sink);
+
+        if (out_sink_close(&sink) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Output failed: %s\n", strerror(errno));
+        }
+    }
+
+    rpath_core_destroy(&ctx.core);
+    return ctx.flagged ? 1 : 0;
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * MAIN
  * ═══════════════════════════════════════════════════════════════════════════ */
 
 int main(int argc, char *argv[]) {
-    printf("\n");
-    printf(CYAN "╔════════════════════════════════════════════════════════════════════╗\n" RESET);
-    printf(CYAN "║" RESET "           DT_RPATH/DT_RUNPATH VULNERABILITY SCANNER               " CYAN "║\n" RESET);
-    printf(CYAN "╚════════════════════════════════════════════════════════════════════╝\n" RESET);
+    /* Keep stdout clean for machine-readable scans */
+    FILE *banner = stdout;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && strcmp(argv[i + 1], "text") != 0) banner = stderr;
+    }
+
+    fprintf(banner, "\n");
+    fprintf(banner, CYAN "╔════════════════════════════════════════════════════════════════════╗\n" RESET);
+    fprintf(banner, CYAN "║" RESET "           DT_RPATH/DT_RUNPATH VULNERABILITY SCANNER               " CYAN "║\n" RESET);
+    fprintf(banner, CYAN "╚════════════════════════════════════════════════════════════════════╝\n" RESET);
 
     if (argc < 2) {
         printf("\nUsage: %s <binary> [binary2] ...\n", argv[0]);
         printf("       %s --search-order    Show library search order\n", argv[0]);
+        printf("       %s --scan-system [--threads N] [--cache FILE]\n", argv[0]);
+        printf("                            [--format text|jsonl|binary]\n");
+        printf("                            [--read uring|pread|mmap] [--isolate] [root ...]\n");
+        printf("                            Recursively scan directory trees\n");
         printf("\nExamples:\n");
         printf("  %s ./vulnerable_app\n", argv[0]);
         printf("  %s /usr/bin/*\n", argv[0]);
+        printf("  %s --scan-system /usr /opt\n", argv[0]);
         print_search_order();
         return 0;
     }
@@ -376,10 +934,27 @@ int main(int argc, char *argv[]) {
         return 0;
     }
 
+    if (strcmp(argv[1], "--scan-system") == 0) {
+        return scan_system(argc - 2, argv + 2);
+    }
+
+    rpath_core_t core;
+    rpath_core_opts_t opts = {
+        .uid = getuid(),
+        .resolve = 1,
+        .ld_library_path = getenv("LD_LIBRARY_PATH"),
+    };
+    if (rpath_core_init(&core, &opts) < 0) {
+        fprintf(stderr, RED "[!]" RESET " Out of memory\n");
+        return 1;
+    }
+
     for (int i = 1; i < argc; i++) {
-        analyze_binary(argv[i]);
+        analyze_binary(&core, argv[i]);
     }
 
+    rpath_core_destroy(&core);
+
     printf("\n");
     return 0;
 }
@@ -0,0 +1,132 @@
+/*
+ * str_arena.c - Interned string arena for rpath_scanner
+ *
+ * See str_arena.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "str_arena.h"
+
+static uint32_t str_hash(const char *s, size_t len) {
+    /* FNV-1a */
+    uint32_t h = 0x811c9dc5u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (unsigned char)s[i]) * 0x01000193u;
+    }
+    return h;
+}
+
+void str_arena_init(str_arena_t *a) {
+    memset(a, 0, sizeof(*a));
+    for (int i = 0; i < STR_ARENA_SHARDS; i++) {
+        pthread_mutex_init(&a->shards[i].lock, NULL);
+        a->shards[i].used = STR_CHUNK_SIZE;     /* no chunk yet */
+    }
+}
+
+void str_arena_destroy(str_arena_t *a) {
+    for (int i = 0; i < STR_ARENA_SHARDS; i++) {
+        free(a->shards[i].slots);
+        free(a->shards[i].hashes);
+        pthread_mutex_destroy(&a->shards[i].lock);
+    }
+    for (uint32_t c = 0; c < a->nchunks && c < STR_MAX_CHUNKS; c++) {
+        free(a->chunks[c]);
+    }
+    memset(a, 0, sizeof(*a));
+}
+
+void str_arena_reset(str_arena_t *a) {
+    str_arena_destroy(a);
+    str_arena_init(a);
+}
+
+/* Double a shard's table (caller holds the shard lock) */
+static int shard_grow(str_shard_t *sh) {
+    uint32_t n = sh->mask ? (sh->mask + 1) * 2 : 256;
+    uint32_t *slots = calloc(n, sizeof(*slots));
+    uint32_t *hashes = malloc(n * sizeof(*hashes));
+    if (!slots || !hashes) {
+        free(slots);
+        free(hashes);
+        return -1;
+    }
+    for (uint32_t i = 0; sh->slots && i <= sh->mask; i++) {
+        if (sh->slots[i] == STR_NONE) continue;
+        uint32_t j = sh->hashes[i] & (n - 1);
+        while (slots[j] != STR_NONE) j = (j + 1) & (n - 1);
+        slots[j] = sh->slots[i];
+        hashes[j] = sh->hashes[i];
+    }
+    free(sh->slots);
+    free(sh->hashes);
+    sh->slots = slots;
+    sh->hashes = hashes;
+    sh->mask = n - 1;
+    return 0;
+}
+
+/* Copy s into the shard's current chunk, opening a new one if it is full */
+static str_handle_t shard_store(str_arena_t *a, str_shard_t *sh, const char *s, size_t len) {
+    if (sh->used + len + 1 > STR_CHUNK_SIZE) {
+        uint32_t c = __atomic_fetch_add(&a->nchunks, 1, __ATOMIC_RELAXED);
+        if (c >= STR_MAX_CHUNKS) return STR_NONE;
+        char *chunk = malloc(STR_CHUNK_SIZE);
+        if (!chunk) return STR_NONE;
+        a->chunks[c] = chunk;
+        sh->chunk = c;
+        sh->used = c == 0 ? 1 : 0;      /* offset 0 of chunk 0 would be STR_NONE */
+    }
+
+    str_handle_t h = sh->chunk << STR_CHUNK_BITS | sh->used;
+    char *dst = a->chunks[sh->chunk] + sh->used;
+    memcpy(dst, s, len);
+    dst[len] = '\0';
+    sh->used += len + 1;
+    __atomic_fetch_add(&a->unique, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&a->bytes, len + 1, __ATOMIC_RELAXED);
+    return h;
+}
+
+str_handle_t str_intern_len(str_arena_t *a, const char *s, size_t len) {
+    if (len + 1 > STR_CHUNK_SIZE) return STR_NONE;
+    __atomic_fetch_add(&a->lookups, 1, __ATOMIC_RELAXED);
+
+    uint32_t hash = str_hash(s, len);
+    str_shard_t *sh = &a->shards[hash >> 28 & (STR_ARENA_SHARDS - 1)];
+    str_handle_t h = STR_NONE;
+
+    pthread_mutex_lock(&sh->lock);
+    if (sh->count * 2 >= (sh->slots ? sh->mask + 1 : 0) && shard_grow(sh) < 0) {
+        pthread_mutex_unlock(&sh->lock);
+        return STR_NONE;
+    }
+
+    uint32_t i = hash & sh->mask;
+    for (; sh->slots[i] != STR_NONE; i = (i + 1) & sh->mask) {
+        if (sh->hashes[i] != hash) continue;
+        const char *t = str_get(a, sh->slots[i]);
+        if (memcmp(t, s, len) == 0 && t[len] == '\0') {
+            h = sh->slots[i];
+            break;
+        }
+    }
+    if (h == STR_NONE) {
+        h = shard_store(a, sh, s, len);
+        if (h != STR_NONE) {
+            sh->slots[i] = h;
+            sh->hashes[i] = hash;
+            sh->count++;
+        }
+    }
+    pthread_mutex_unlock(&sh->lock);
+    return h;
+}
+
+str_handle_t str_intern(str_arena_t *a, const char *s) {
+    return str_intern_len(a, s, strlen(s));
+}
@@ -0,0 +1,81 @@
+/*
+ * str_arena.h - Interned string arena for rpath_scanner
+ *
+ * A system scan sees the same few hundred sonames and RPATH lists in
+ * hundreds of thousands of binaries. Every string is interned here once
+ * per scan and referred to by a 32-bit handle; memory grows with the
+ * number of distinct strings, not with the number of times they occur,
+ * and no string gets a malloc of its own.
+ *
+ *   handle = chunk << STR_CHUNK_BITS | offset
+ *
+ *   chunks[0] ┌──────────────────────────────┐
+ *             │ "libc.so.6\0$ORIGIN/../lib\0"│  bump-allocated, 1 MiB each,
+ *   chunks[1] ├──────────────────────────────┤  never moved or freed
+ *             │ ...                          │  until the arena is
+ *             └──────────────────────────────┘
+ *
+ * The dedup table is sharded like dir_cache.h (one mutex per shard),
+ * and each shard bump-allocates from its own chunk, so scan threads
+ * only contend on the same shard. Resolving a handle takes no lock:
+ * chunks never move, and a handle is only ever handed out after its
+ * bytes are written.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef STR_ARENA_H
+#define STR_ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+typedef uint32_t str_handle_t;
+
+#define STR_NONE            0u          /* no string; never a valid handle */
+#define STR_CHUNK_BITS      20
+#define STR_CHUNK_SIZE      (1u << STR_CHUNK_BITS)
+#define STR_MAX_CHUNKS      (1u << (32 - STR_CHUNK_BITS))
+#define STR_ARENA_SHARDS    16
+
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t       *slots;      /* handle, or STR_NONE */
+    uint32_t       *hashes;
+    uint32_t        mask;
+    uint32_t        count;
+    uint32_t        chunk;      /* chunk this shard allocates from */
+    uint32_t        used;       /* bytes used in it */
+} str_shard_t;
+
+typedef struct {
+    char         *chunks[STR_MAX_CHUNKS];
+    uint32_t      nchunks;
+    str_shard_t   shards[STR_ARENA_SHARDS];
+
+    unsigned long lookups;      /* str_intern calls */
+    unsigned long unique;       /* distinct strings stored */
+    unsigned long bytes;        /* bytes stored, including the NULs */
+} str_arena_t;
+
+void str_arena_init(str_arena_t *a);
+void str_arena_destroy(str_arena_t *a);
+
+/* Free every string; all handles become invalid. Not thread-safe. */
+void str_arena_reset(str_arena_t *a);
+
+/*
+ * Handle for s, storing it on first sight. Thread-safe. Returns STR_NONE
+ * when out of memory or when s does not fit in one chunk.
+ */
+str_handle_t str_intern(str_arena_t *a, const char *s);
+str_handle_t str_intern_len(str_arena_t *a, const char *s, size_t len);
+
+/* The NUL-terminated string behind h; NULL for STR_NONE */
+static inline const char *str_get(const str_arena_t *a, str_handle_t h) {
+    if (h == STR_NONE) return NULL;
+    return a->chunks[h >> STR_CHUNK_BITS] + (h & (STR_CHUNK_SIZE - 1));
+}
+
+#endif /* STR_ARENA_H */
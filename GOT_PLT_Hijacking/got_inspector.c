@@ -4,10 +4,22 @@
  * This utility inspects the GOT of a running process or binary.
  * It demonstrates:
  *   1. How to read ELF headers to find GOT section
- *   2. How to dump GOT entries and their resolved values
+ *   2. How to dump GOT entries and the symbol each one is bound to
+ *      (every .rela.plt entry joined to .dynsym and .gnu.version)
  *   3. How to detect GOT hijacking
+ *   4. Which binaries of a whole tree import watch-listed functions
+ *      (--imports: every undefined .dynsym entry against a perfect hash)
+ *   5. checksec-style hardening flags of a whole tree (--hardening:
+ *      RELRO, BIND_NOW, NX stack, PIE, TEXTREL, DT_DEBUG from the headers)
  *
- * Compile: gcc -o got_inspector got_inspector.c -ldl
+ * Compile: gcc -I../common -pthread -o got_inspector got_inspector.c sym_watch.c \
+ *              plt_map.c hardening.c ../common/elf_view.c ../common/read_batch.c \
+ *              ../common/elf_version.c ../common/out_sink.c ../common/fs_walk.c \
+ *              ../common/task_pool.c -ldl
+ * Usage:   ./got_inspector [--format text|jsonl|binary] [--summary] <binary> ...
+ *          ./got_inspector [--format ...] --imports [--watch SYM,...|@FILE]
+ *                          [--threads N] <file|dir> ...
+ *          ./got_inspector [--format ...] --hardening [--threads N] <file|dir> ...
  *
  * EDUCATIONAL PURPOSES ONLY
  */
@@ -18,11 +30,20 @@
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
-#include <fcntl.h>
 #include <elf.h>
-#include <sys/mman.h>
 #include <sys/stat.h>
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+
+#include "elf_view.h"
+#include "out_sink.h"
+#include "fs_walk.h"
+#include "elf_version.h"
+#include "sym_watch.h"
+#include "plt_map.h"
+#include "hardening.h"
 
 /* Color codes */
 #define RED     "\033[1;31m"
@@ -32,6 +53,8 @@
 #define CYAN    "\033[1;36m"
 #define RESET   "\033[0m"
 
+#define MAX_ROOTS   256         /* files or directories given to a census */
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * ELF PARSING HELPERS
  * ═══════════════════════════════════════════════════════════════════════════ */
@@ -43,64 +66,129 @@ typedef struct {
     int found;
 } section_info_t;
 
-/* Find a section by name in ELF file */
-int find_section(const char *filename, const char *section_name, section_info_t *info) {
-    int fd = open(filename, O_RDONLY);
-    if (fd < 0) {
-        perror("open");
-        return -1;
+/* Find a section by name in an already-mapped ELF file */
+int find_section(const elf_view_t *view, const char *section_name, section_info_t *info) {
+    const Elf64_Shdr *shdr = elf_view_section(view, section_name);
+
+    info->found = 0;
+    if (shdr) {
+        info->offset = shdr->sh_offset;
+        info->vaddr = shdr->sh_addr;
+        info->size = shdr->sh_size;
+        info->found = 1;
     }
 
-    struct stat st;
-    fstat(fd, &st);
+    return info->found ? 0 : -1;
+}
 
-    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-    if (map == MAP_FAILED) {
-        perror("mmap");
-        close(fd);
-        return -1;
-    }
+/* ═══════════════════════════════════════════════════════════════════════════
+ * GOT ANALYSIS
+ * ═══════════════════════════════════════════════════════════════════════════ */
 
-    Elf64_Ehdr *ehdr = (Elf64_Ehdr *)map;
+/*
+ * Slots and relocations come from the dynamic segment (see plt_map.h),
+ * never from section headers, so stripped binaries work the same. A
+ * file without PLT relocations gets an empty map.
+ */
+static int load_plt_map(const elf_view_t *view, elf_versions_t *vs, plt_map_t *map) {
+    plt_tables_t t;
+    plt_tables_from_dynamic(&t, view);
 
-    /* Verify ELF magic */
-    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0) {
-        fprintf(stderr, "Not an ELF file\n");
-        munmap(map, st.st_size);
-        close(fd);
+    if (elf_versions_load(vs, view) < 0) return -1;
+    if (plt_map_build(map, view, vs, &t) < 0) {
+        elf_versions_free(vs);
         return -1;
     }
+    return 0;
+}
 
-    /* Get section header string table */
-    Elf64_Shdr *shdr = (Elf64_Shdr *)((uint8_t *)map + ehdr->e_shoff);
-    Elf64_Shdr *shstrtab = &shdr[ehdr->e_shstrndx];
-    char *strtab = (char *)map + shstrtab->sh_offset;
+/* Whether PT_GNU_RELRO covers every slot, i.e. ld.so makes them read-only */
+static int slots_in_relro(const elf_view_t *view, const plt_map_t *map) {
+    const Elf64_Phdr *relro = view->pt_gnu_relro;
+    if (!relro || !map->nslots) return 0;
+    return map->vaddr >= relro->p_vaddr &&
+           map->vaddr + map->nslots * 8 <= relro->p_vaddr + relro->p_memsz;
+}
 
-    info->found = 0;
+static void free_plt_map(elf_versions_t *vs, plt_map_t *map) {
+    plt_map_free(map);
+    elf_versions_free(vs);
+}
 
-    /* Find the requested section */
-    for (int i = 0; i < ehdr->e_shnum; i++) {
-        char *name = strtab + shdr[i].sh_name;
-        if (strcmp(name, section_name) == 0) {
-            info->offset = shdr[i].sh_offset;
-            info->vaddr = shdr[i].sh_addr;
-            info->size = shdr[i].sh_size;
-            info->found = 1;
-            break;
+/* As readelf writes it: "@@" for this object's own default version, else "@" */
+static const char *version_sep(const elf_versions_t *vs, uint16_t versym) {
+    for (size_t i = 0; i < vs->ndefs; i++) {
+        if (vs->defs[i].ndx == (versym & VERSYM_VERSION)) {
+            return versym & VERSYM_HIDDEN ? "@" : "@@";
         }
     }
+    return "@";
+}
 
-    munmap(map, st.st_size);
-    close(fd);
-
-    return info->found ? 0 : -1;
+/* "puts@GLIBC_2.2.5", or what the loader keeps in a slot nothing relocates */
+static const char *describe_slot(const plt_map_t *map, const elf_versions_t *vs,
+                                 size_t i, char *buf, size_t len) {
+    if (map->name[i]) {
+        const char *ver = elf_versions_name(vs, map->versym[i]);
+        snprintf(buf, len, "%s%s%s", map->name[i],
+                 ver ? version_sep(vs, map->versym[i]) : "", ver ? ver : "");
+    } else if (map->type[i] == R_X86_64_IRELATIVE) {
+        snprintf(buf, len, "IRELATIVE → resolver 0x%lx", (uint64_t)map->addend[i]);
+    } else if (i == 0) {
+        return "→ .dynamic";
+    } else if (i == 1) {
+        return "→ link_map (filled by ld.so)";
+    } else if (i == 2) {
+        return "→ _dl_runtime_resolve";
+    } else {
+        return map->type[i] ? "(no symbol)" : "(no PLT relocation)";
+    }
+    return buf;
 }
 
-/* ═══════════════════════════════════════════════════════════════════════════
- * GOT ANALYSIS
- * ═══════════════════════════════════════════════════════════════════════════ */
+/* Counts only; nothing here is per slot */
+static void print_plt_summary(const elf_view_t *view, const plt_map_t *map,
+                              const elf_versions_t *vs) {
+    size_t named = 0, unversioned = 0;
+    unsigned *by_ndx = calloc(vs->max_ndx + 1, sizeof(*by_ndx));
+
+    for (size_t i = 0; i < map->nslots; i++) {
+        if (!map->name[i]) continue;
+        named++;
+        uint16_t ndx = map->versym[i] & VERSYM_VERSION;
+        if (by_ndx && vs->by_ndx && ndx <= vs->max_ndx && vs->by_ndx[ndx]) by_ndx[ndx]++;
+        else unversioned++;
+    }
 
-void analyze_got(const char *filename) {
+    if (map->nslots) {
+        printf("  Slots:              %zu (DT_PLTGOT 0x%lx)\n", map->nslots, map->vaddr);
+    } else {
+        printf("  Slots:              0 (no DT_JMPREL / DT_PLTGOT)\n");
+    }
+    if (view->pt_gnu_relro) {
+        int ro = slots_in_relro(view, map);
+        printf("  In PT_GNU_RELRO:    %s" RESET " (0x%lx-0x%lx)\n",
+               ro ? GREEN "yes, read-only after relocation" : RED "no, writable at run time",
+               view->pt_gnu_relro->p_vaddr,
+               view->pt_gnu_relro->p_vaddr + view->pt_gnu_relro->p_memsz);
+    } else {
+        printf("  In PT_GNU_RELRO:    " RED "no PT_GNU_RELRO" RESET "\n");
+    }
+    printf("  PLT relocations:    %zu\n", map->nrela);
+    printf("  ├─ JUMP_SLOT:       %zu\n", map->njump);
+    printf("  ├─ IRELATIVE:       %zu\n", map->nirelative);
+    printf("  ├─ other:           %zu\n", map->nother);
+    printf("  └─ unmatched:       %s%zu" RESET "\n",
+           map->noutside + map->nbadsym ? RED : GREEN, map->noutside + map->nbadsym);
+    printf("  Named slots:        %zu (%zu unversioned)\n", named, unversioned);
+    for (uint16_t ndx = 0; by_ndx && ndx <= vs->max_ndx; ndx++) {
+        if (by_ndx[ndx]) printf("    %-24s %6u\n", vs->by_ndx[ndx], by_ndx[ndx]);
+    }
+    free(by_ndx);
+}
+
+void analyze_got(const elf_view_t *view, int summary) {
+    const char *filename = view->path;
     section_info_t got_info, gotplt_info, rela_plt_info;
 
     printf(YELLOW "\n═══════════════════════════════════════════════════════════════════\n" RESET);
@@ -108,7 +196,7 @@ void analyze_got(const char *filename) {
     printf(YELLOW "═══════════════════════════════════════════════════════════════════\n\n" RESET);
 
     /* Find .got section */
-    if (find_section(filename, ".got", &got_info) == 0) {
+    if (find_section(view, ".got", &got_info) == 0) {
         printf(GREEN "[✓]" RESET " .got section found:\n");
         printf("    Address: " CYAN "0x%lx" RESET "\n", got_info.vaddr);
         printf("    Size:    %lu bytes (%lu entries)\n",
@@ -118,7 +206,7 @@ void analyze_got(const char *filename) {
     }
 
     /* Find .got.plt section */
-    if (find_section(filename, ".got.plt", &gotplt_info) == 0) {
+    if (find_section(view, ".got.plt", &gotplt_info) == 0) {
         printf("\n" GREEN "[✓]" RESET " .got.plt section found:\n");
         printf("    Address: " CYAN "0x%lx" RESET "\n", gotplt_info.vaddr);
         printf("    Size:    %lu bytes (%lu entries)\n",
@@ -128,113 +216,64 @@ void analyze_got(const char *filename) {
     }
 
     /* Find .rela.plt section (contains relocation info) */
-    if (find_section(filename, ".rela.plt", &rela_plt_info) == 0) {
+    if (find_section(view, ".rela.plt", &rela_plt_info) == 0) {
         printf("\n" GREEN "[✓]" RESET " .rela.plt section found:\n");
-        printf("    Contains PLT relocation entries\n");
+        printf("    %lu PLT relocation entries\n", rela_plt_info.size / sizeof(Elf64_Rela));
     }
 
-    /* Parse and display GOT entries from the file */
-    printf(YELLOW "\n───────────────────────────────────────────────────────────────────\n" RESET);
-    printf(YELLOW "  .got.plt ENTRIES (PLT function pointers)\n" RESET);
-    printf(YELLOW "───────────────────────────────────────────────────────────────────\n\n" RESET);
+    /* The sections above are for display; the slots come from PT_DYNAMIC */
+    if (!view->shnum) {
+        printf("\n" YELLOW "[*]" RESET " No section headers: using DT_PLTGOT / DT_JMPREL\n");
+    }
 
-    int fd = open(filename, O_RDONLY);
-    if (fd < 0) return;
+    elf_versions_t vs;
+    plt_map_t map;
+    if (load_plt_map(view, &vs, &map) < 0) {
+        printf(RED "[✗]" RESET " Cannot decode PLT relocations: %s\n", strerror(errno));
+        return;
+    }
 
-    struct stat st;
-    fstat(fd, &st);
-    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    printf(YELLOW "\n───────────────────────────────────────────────────────────────────\n" RESET);
+    printf(YELLOW "  PLT GOT ENTRIES (DT_PLTGOT, PLT function pointers)\n" RESET);
+    printf(YELLOW "───────────────────────────────────────────────────────────────────\n\n" RESET);
 
-    if (map != MAP_FAILED && gotplt_info.found) {
-        uint64_t *got = (uint64_t *)((uint8_t *)map + gotplt_info.offset);
-        size_t num_entries = gotplt_info.size / sizeof(uint64_t);
+    if (!summary && map.values) {
+        char buf[512];
 
-        printf("  Index │ Address          │ Initial Value    │ Description\n");
+        printf("  Index │ Address          │ Initial Value    │ Symbol\n");
         printf("  ──────┼──────────────────┼──────────────────┼─────────────────\n");
 
-        for (size_t i = 0; i < num_entries && i < 20; i++) {
-            uint64_t addr = gotplt_info.vaddr + i * 8;
-            uint64_t value = got[i];
-
-            const char *desc = "";
-            if (i == 0) desc = "→ .dynamic";
-            else if (i == 1) desc = "→ link_map (filled by ld.so)";
-            else if (i == 2) desc = "→ _dl_runtime_resolve";
-            else desc = "→ PLT stub (lazy) / libc func";
-
-            printf("  [%2zu]  │ " CYAN "0x%012lx" RESET " │ 0x%012lx   │ %s\n",
-                   i, addr, value, desc);
-        }
-
-        if (num_entries > 20) {
-            printf("  ...   │ (%zu more entries)\n", num_entries - 20);
+        for (size_t i = 0; i < map.nslots; i++) {
+            printf("  [%4zu]│ " CYAN "0x%012lx" RESET " │ 0x%012lx   │ %s\n",
+                   i, map.vaddr + i * 8, map.values[i],
+                   describe_slot(&map, &vs, i, buf, sizeof(buf)));
         }
-
-        munmap(map, st.st_size);
+        printf("\n");
     }
-
-    close(fd);
+    print_plt_summary(view, &map, &vs);
+    free_plt_map(&vs, &map);
 }
 
 /* ═══════════════════════════════════════════════════════════════════════════
  * RELRO CHECK
  * ═══════════════════════════════════════════════════════════════════════════ */
 
-void check_relro(const char *filename) {
+void check_relro(const elf_view_t *view) {
     printf(YELLOW "\n───────────────────────────────────────────────────────────────────\n" RESET);
     printf(YELLOW "  RELRO PROTECTION STATUS\n" RESET);
     printf(YELLOW "───────────────────────────────────────────────────────────────────\n\n" RESET);
 
-    int fd = open(filename, O_RDONLY);
-    if (fd < 0) {
-        perror("open");
+    if (!hardening_loadable(view->ehdr)) {
+        printf("  Not an executable or shared object: nothing is loaded, nothing to protect.\n");
         return;
     }
 
-    struct stat st;
-    fstat(fd, &st);
-    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    /* The same flags --hardening computes, from the view already mapped */
+    unsigned flags = hardening_from_view(view);
+    int has_relro = flags & HARD_RELRO;
+    int bind_now = flags & HARD_BIND_NOW;
 
-    if (map == MAP_FAILED) {
-        close(fd);
-        return;
-    }
-
-    Elf64_Ehdr *ehdr = (Elf64_Ehdr *)map;
-    Elf64_Phdr *phdr = (Elf64_Phdr *)((uint8_t *)map + ehdr->e_phoff);
-
-    int has_relro = 0;
-    int has_bind_now = 0;
-
-    /* Check program headers for GNU_RELRO */
-    for (int i = 0; i < ehdr->e_phnum; i++) {
-        if (phdr[i].p_type == PT_GNU_RELRO) {
-            has_relro = 1;
-        }
-    }
-
-    /* Check dynamic section for BIND_NOW flag */
-    for (int i = 0; i < ehdr->e_phnum; i++) {
-        if (phdr[i].p_type == PT_DYNAMIC) {
-            Elf64_Dyn *dyn = (Elf64_Dyn *)((uint8_t *)map + phdr[i].p_offset);
-            while (dyn->d_tag != DT_NULL) {
-                if (dyn->d_tag == DT_FLAGS) {
-                    if (dyn->d_un.d_val & DF_BIND_NOW) {
-                        has_bind_now = 1;
-                    }
-                }
-                if (dyn->d_tag == DT_FLAGS_1) {
-                    if (dyn->d_un.d_val & DF_1_NOW) {
-                        has_bind_now = 1;
-                    }
-                }
-                dyn++;
-            }
-            break;
-        }
-    }
-
-    if (has_relro && has_bind_now) {
+    if (has_relro && bind_now) {
         printf("  Protection: " GREEN "FULL RELRO" RESET "\n");
         printf("  ├─ GNU_RELRO segment: " GREEN "Present" RESET "\n");
         printf("  └─ BIND_NOW flag:     " GREEN "Enabled" RESET "\n");
@@ -256,8 +295,12 @@ void check_relro(const char *filename) {
         printf("  " RED "■" RESET " GOT is " RED "FULLY WRITABLE" RESET " - trivially hijackable!\n");
     }
 
-    munmap(map, st.st_size);
-    close(fd);
+    printf("\n");
+    printf("  Stack:    %s\n", (flags & HARD_EXEC_STACK) ? RED "EXECUTABLE" RESET : GREEN "NX" RESET);
+    printf("  PIE:      %s\n", (flags & HARD_PIE) ? GREEN "Yes" RESET :
+                              (flags & HARD_ET_DYN) ? "DSO" : YELLOW "No" RESET);
+    printf("  TEXTREL:  %s\n", (flags & HARD_TEXTREL) ? RED "Present" RESET : GREEN "None" RESET);
+    printf("  DT_DEBUG: %s\n", (flags & HARD_DEBUG) ? "Present" : "None");
 }
 
 /* ═══════════════════════════════════════════════════════════════════════════
@@ -313,21 +356,602 @@ void print_plt_explanation(void) {
     printf("                                            └─────────────────┘\n");
 }
 
+/* ═══════════════════════════════════════════════════════════════════════════
+ * IMPORT CENSUS (--imports)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Default watch list: process execution, runtime loading, credentials, self-patching */
+static const char *const default_watch[] = {
+    "system", "popen", "execl", "execle", "execlp", "execv", "execve", "execvp",
+    "execvpe", "fexecve", "posix_spawn", "posix_spawnp", "dlopen", "dlmopen",
+    "getpass", "gets", "ptrace", "mprotect", "memfd_create", "process_vm_writev",
+    "setuid", "setgid", "setreuid", "setresuid",
+};
+
+typedef struct {
+    const sym_watch_t *watch;
+    out_sink_t        *sink;        /* NULL for the text report */
+    unsigned long     *counts;      /* binaries importing each watched name */
+    unsigned long      elf_files;
+    unsigned long      with_dynsym;
+    unsigned long      flagged;
+    unsigned long      failed;
+} census_ctx_t;
+
+#define CENSUS_COUNT(p) __atomic_fetch_add(p, 1, __ATOMIC_RELAXED)
+
+/*
+ * fs_walk callback, runs on the worker threads. Only the undefined
+ * entries of .dynsym are imports; each name costs one perfect-hash
+ * probe. A binary's hit line is written in one go so lines from
+ * different threads never interleave.
+ */
+static void census_binary(const char *path, int fd, void *arg) {
+    census_ctx_t *ctx = arg;
+    elf_view_t view;
+
+    if (elf_view_open_fd(&view, fd, path) < 0) {
+        if (errno != ENOEXEC) CENSUS_COUNT(&ctx->failed);
+        return;
+    }
+    CENSUS_COUNT(&ctx->elf_files);
+
+    size_t nsyms = 0;
+    const Elf64_Sym *syms = elf_view_dynsym(&view, &nsyms);
+    if (!syms) {
+        elf_view_close(&view);
+        return;
+    }
+    CENSUS_COUNT(&ctx->with_dynsym);
+
+    uint64_t seen[(SYM_WATCH_MAX + 63) / 64] = {0};
+    uint32_t hits[SYM_WATCH_MAX];
+    size_t nhits = 0;
+    for (size_t i = 1; i < nsyms; i++) {
+        if (syms[i].st_shndx != SHN_UNDEF || syms[i].st_name == 0) continue;
+        const char *name = elf_view_dynstr(&view, syms[i].st_name);
+        uint32_t k = name ? sym_watch_find(ctx->watch, name) : SYM_WATCH_NONE;
+        if (k == SYM_WATCH_NONE || (seen[k / 64] & (1ULL << (k % 64)))) continue;
+        seen[k / 64] |= 1ULL << (k % 64);
+        hits[nhits++] = k;
+    }
+
+    /* Names read from the zero pages of a truncated file are not its imports */
+    if (elf_view_truncated(&view)) {
+        CENSUS_COUNT(&ctx->failed);
+        elf_view_close(&view);
+        return;
+    }
+
+    const char *names[SYM_WATCH_MAX];
+    for (size_t h = 0; h < nhits; h++) {
+        names[h] = ctx->watch->names[hits[h]];
+        CENSUS_COUNT(&ctx->counts[hits[h]]);
+    }
+
+    if (nhits) {
+        CENSUS_COUNT(&ctx->flagged);
+        if (ctx->sink) {
+            out_begin(ctx->sink, "imports", path);
+            out_str(ctx->sink, "path", path);
+            out_strv(ctx->sink, "symbols", names, nhits);
+            out_end(ctx->sink);
+        } else {
+            flockfile(stdout);
+            printf(YELLOW "[!]" RESET " %s:", path);
+            for (size_t h = 0; h < nhits; h++) printf(" %s", names[h]);
+            printf("\n");
+            funlockfile(stdout);
+        }
+    }
+    elf_view_close(&view);
+}
+
+/* --watch: "a,b,c" or "@file" with one name per line ('#' starts a comment).
+ * The names point into *text, which the caller frees along with *names. */
+static int load_watch_list(const char *spec, char **text, char ***names, size_t *n) {
+    *text = NULL;
+    *names = NULL;
+    *n = 0;
+
+    if (spec[0] == '@') {
+        FILE *f = fopen(spec + 1, "r");
+        if (!f) return -1;
+        size_t cap = 0;
+        if (getdelim(text, &cap, '\0', f) < 0) {
+            free(*text);
+            *text = strdup("");
+        }
+        fclose(f);
+    } else {
+        *text = strdup(spec);
+    }
+    if (!*text) return -1;
+
+    /* Never more names than separators + 1 */
+    size_t max = 1;
+    for (const char *p = *text; *p; p++) max += *p == ',' || *p == '\n';
+    *names = malloc(max * sizeof(**names));
+    if (!*names) {
+        free(*text);
+        return -1;
+    }
+
+    /* Comments end at the line, so strip them before splitting on commas */
+    char *lsave = NULL;
+    for (char *line = strtok_r(*text, "\n", &lsave); line; line = strtok_r(NULL, "\n", &lsave)) {
+        line[strcspn(line, "#")] = '\0';
+
+        char *save = NULL;
+        for (char *tok = strtok_r(line, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+            tok += strspn(tok, " \t\r");
+            tok[strcspn(tok, " \t\r")] = '\0';
+            if (*tok) (*names)[(*n)++] = tok;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Shared by the census modes: plain files are checked as given,
+ * directories are walked for them. Returns the elapsed seconds.
+ */
+static double walk_roots(const char **roots, int nroots, int nthreads, int elf_only,
+                         fs_walk_fn fn, void *arg, fs_walk_stats_t *stats) {
+    const char *dirs[MAX_ROOTS];
+    int ndirs = 0;
+    struct timespec t0, t1;
+
+    memset(stats, 0, sizeof(*stats));
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < nroots; i++) {
+        struct stat st;
+        if (stat(roots[i], &st) < 0) {
+            stats->errors++;
+        } else if (S_ISDIR(st.st_mode)) {
+            dirs[ndirs++] = roots[i];
+        } else {
+            int fd = open(roots[i], O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                stats->errors++;
+                continue;
+            }
+            stats->files++;
+            fn(roots[i], fd, arg);
+            close(fd);
+        }
+    }
+    if (ndirs) {
+        fs_walk_opts_t opts = {
+            .roots = dirs,
+            .nroots = ndirs,
+            .nthreads = nthreads,
+            .elf_only = elf_only,
+            .fn = fn,
+            .arg = arg,
+        };
+        fs_walk_stats_t ws;
+        fs_walk(&opts, &ws);
+        stats->files += ws.files;
+        stats->errors += ws.errors;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+}
+
+int census_mode(int argc, char *argv[], out_format_t format) {
+    const char *roots[MAX_ROOTS];
+    int nroots = 0;
+    int nthreads = 0;
+    const char *watch_spec = NULL;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            nthreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            watch_spec = argv[++i];
+        } else if (nroots < MAX_ROOTS) {
+            roots[nroots++] = argv[i];
+        } else {
+            fprintf(stderr, RED "[!]" RESET " --imports takes at most %d files or directories\n", MAX_ROOTS);
+            return 2;
+        }
+    }
+    if (nroots == 0) {
+        fprintf(stderr, RED "[!]" RESET " --imports needs at least one file or directory\n");
+        return 2;
+    }
+
+    char *text = NULL, **list = NULL;
+    size_t nlist = 0;
+    if (watch_spec && load_watch_list(watch_spec, &text, &list, &nlist) < 0) {
+        fprintf(stderr, RED "[!]" RESET " Cannot read watch list %s: %s\n", watch_spec, strerror(errno));
+        return 2;
+    }
+
+    sym_watch_t watch;
+    int built = list ? sym_watch_build(&watch, (const char *const *)list, nlist)
+                     : sym_watch_build(&watch, default_watch,
+                                       sizeof(default_watch) / sizeof(default_watch[0]));
+    free(list);
+    free(text);
+    if (built < 0) {
+        if (errno == EINVAL) {
+            fprintf(stderr, RED "[!]" RESET " Cannot compile watch list: more than %d names\n",
+                    SYM_WATCH_MAX);
+        } else {
+            fprintf(stderr, RED "[!]" RESET " Cannot compile watch list: %s\n", strerror(errno));
+        }
+        return 2;
+    }
+
+    census_ctx_t ctx = { .watch = &watch };
+    ctx.counts = calloc(watch.n ? watch.n : 1, sizeof(*ctx.counts));
+    if (!ctx.counts) {
+        sym_watch_free(&watch);
+        fprintf(stderr, RED "[!]" RESET " Out of memory\n");
+        return 2;
+    }
+
+    /* Records go to stdout in path order; the human summary moves to stderr */
+    out_sink_t sink;
+    FILE *report = stdout;
+    if (format != OUT_TEXT) {
+        if (out_sink_open(&sink, STDOUT_FILENO, format, 1) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Cannot write output: %s\n", strerror(errno));
+            free(ctx.counts);
+            sym_watch_free(&watch);
+            return 2;
+        }
+        ctx.sink = &sink;
+        report = stderr;
+    }
+
+    fs_walk_stats_t stats;
+    double secs = walk_roots(roots, nroots, nthreads, 1, census_binary, &ctx, &stats);
+
+    fprintf(report, "\n");
+    fprintf(report, CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    fprintf(report, CYAN "  IMPORT CENSUS (%u watched symbols)\n" RESET, watch.n);
+    fprintf(report, CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    for (uint32_t k = 0; k < watch.n; k++) {
+        if (ctx.counts[k]) fprintf(report, "  %-24s %8lu binaries\n", watch.names[k], ctx.counts[k]);
+    }
+    fprintf(report, "\n");
+    fprintf(report, "  ELF files parsed:       %lu (%lu with .dynsym)\n", ctx.elf_files, ctx.with_dynsym);
+    fprintf(report, "  Importing any:          %s%lu" RESET "\n", ctx.flagged ? RED : GREEN, ctx.flagged);
+    fprintf(report, "  Unreadable / malformed: %lu\n", stats.errors + ctx.failed);
+    fprintf(report, "  Elapsed:                %.2f s (%.0f files/s)\n\n",
+            secs, secs > 0 ? ctx.elf_files / secs : 0.0);
+
+    int rc = ctx.flagged ? 1 : 0;
+    if (ctx.sink) {
+        out_begin(&sink, "summary", "\x7f");
+        out_int(&sink, "elf_files", ctx.elf_files);
+        out_int(&sink, "with_dynsym", ctx.with_dynsym);
+        out_int(&sink, "flagged", ctx.flagged);
+        out_int(&sink, "unreadable", stats.errors + ctx.failed);
+        out_end(&sink);
+        if (out_sink_close(&sink) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Output failed: %s\n", strerror(errno));
+            rc = 2;
+        }
+    }
+
+    free(ctx.counts);
+    sym_watch_free(&watch);
+    return rc;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * HARDENING CENSUS (--hardening)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Weak enough to be worth a look: no RELRO, executable stack, text relocations */
+#define HARD_WEAK(f) (!((f) & HARD_RELRO) || ((f) & (HARD_EXEC_STACK | HARD_TEXTREL)))
+
+typedef struct {
+    out_sink_t    *sink;            /* NULL for the text report */
+    unsigned long  bits[HARD_NBITS];
+    unsigned long  full_relro;
+    unsigned long  elf_files;
+    unsigned long  weak;
+    unsigned long  failed;
+} hardening_ctx_t;
+
+#define HARD_COUNT(ctx, flag) ((ctx).bits[__builtin_ctz(flag)])
+
+/*
+ * fs_walk callback: headers only, via hardening_probe(), which also
+ * rejects non-ELF files, objects and core dumps, so the walk does not
+ * check the magic first.
+ */
+static void hardening_binary(const char *path, int fd, void *arg) {
+    hardening_ctx_t *ctx = arg;
+    unsigned f;
+
+    if (hardening_probe(fd, &f) < 0) {
+        if (errno != ENOEXEC) CENSUS_COUNT(&ctx->failed);
+        return;
+    }
+    CENSUS_COUNT(&ctx->elf_files);
+    for (int b = 0; b < HARD_NBITS; b++) {
+        if (f & (1u << b)) CENSUS_COUNT(&ctx->bits[b]);
+    }
+    if ((f & HARD_FULL_RELRO) == HARD_FULL_RELRO) CENSUS_COUNT(&ctx->full_relro);
+    if (HARD_WEAK(f)) CENSUS_COUNT(&ctx->weak);
+
+    if (ctx->sink) {
+        out_begin(ctx->sink, "hardening", path);
+        out_str(ctx->sink, "path", path);
+        out_int(ctx->sink, "flags", f);
+        out_str(ctx->sink, "relro", hardening_relro(f));
+        out_bool(ctx->sink, "nx", !(f & HARD_EXEC_STACK));
+        out_bool(ctx->sink, "pie", f & HARD_PIE);
+        out_bool(ctx->sink, "textrel", f & HARD_TEXTREL);
+        out_bool(ctx->sink, "debug", f & HARD_DEBUG);
+        out_end(ctx->sink);
+        return;
+    }
+
+    const char *relro = hardening_relro(f);
+    const char *type = (f & HARD_PIE) ? "PIE" : (f & HARD_ET_DYN) ? "DSO" : "no";
+    printf("  %s%-8s" RESET " %s%-5s" RESET " %-4s %s%-7s" RESET " %-5s %s\n",
+           relro[0] == 'f' ? GREEN : relro[0] == 'p' ? YELLOW : RED, relro,
+           (f & HARD_EXEC_STACK) ? RED : GREEN, (f & HARD_EXEC_STACK) ? "exec" : "NX",
+           type,
+           (f & HARD_TEXTREL) ? RED : "", (f & HARD_TEXTREL) ? "TEXTREL" : "-",
+           (f & HARD_DEBUG) ? "yes" : "-", path);
+}
+
+int hardening_mode(int argc, char *argv[], out_format_t format) {
+    const char *roots[MAX_ROOTS];
+    int nroots = 0;
+    int nthreads = 0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            nthreads = atoi(argv[++i]);
+        } else if (nroots < MAX_ROOTS) {
+            roots[nroots++] = argv[i];
+        } else {
+            fprintf(stderr, RED "[!]" RESET " --hardening takes at most %d files or directories\n", MAX_ROOTS);
+            return 2;
+        }
+    }
+    if (nroots == 0) {
+        fprintf(stderr, RED "[!]" RESET " --hardening needs at least one file or directory\n");
+        return 2;
+    }
+
+    hardening_ctx_t ctx = {0};
+    out_sink_t sink;
+    FILE *report = stdout;
+    if (format != OUT_TEXT) {
+        if (out_sink_open(&sink, STDOUT_FILENO, format, 1) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Cannot write output: %s\n", strerror(errno));
+            return 2;
+        }
+        ctx.sink = &sink;
+        report = stderr;
+    } else {
+        printf("  %-8s %-5s %-4s %-7s %-5s %s\n", "RELRO", "STACK", "PIE", "TEXTREL", "DEBUG", "FILE");
+    }
+
+    fs_walk_stats_t stats;
+    double secs = walk_roots(roots, nroots, nthreads, 0, hardening_binary, &ctx, &stats);
+    unsigned long relro = HARD_COUNT(ctx, HARD_RELRO);
+    unsigned long pie = HARD_COUNT(ctx, HARD_PIE);
+    unsigned long execstack = HARD_COUNT(ctx, HARD_EXEC_STACK);
+    unsigned long textrel = HARD_COUNT(ctx, HARD_TEXTREL);
+
+    fprintf(report, "\n");
+    fprintf(report, CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    fprintf(report, CYAN "  HARDENING CENSUS\n" RESET);
+    fprintf(report, CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    fprintf(report, "  ELF files:              %lu (%lu dynamic)\n",
+            ctx.elf_files, HARD_COUNT(ctx, HARD_DYNAMIC));
+    fprintf(report, "  Full/partial/no RELRO:  %lu / %lu / %lu\n",
+            ctx.full_relro, relro - ctx.full_relro, ctx.elf_files - relro);
+    fprintf(report, "  PIE:                    %lu (%lu shared objects)\n",
+            pie, HARD_COUNT(ctx, HARD_ET_DYN) - pie);
+    fprintf(report, "  Executable stack:       %s%lu" RESET " (%lu without PT_GNU_STACK)\n",
+            execstack ? RED : GREEN, execstack, ctx.elf_files - HARD_COUNT(ctx, HARD_GNU_STACK));
+    fprintf(report, "  TEXTREL:                %s%lu" RESET "\n", textrel ? RED : GREEN, textrel);
+    fprintf(report, "  DT_DEBUG:               %lu\n", HARD_COUNT(ctx, HARD_DEBUG));
+    fprintf(report, "  Weak (any above):       %s%lu" RESET "\n", ctx.weak ? RED : GREEN, ctx.weak);
+    fprintf(report, "  Unreadable / malformed: %lu\n", stats.errors + ctx.failed);
+    fprintf(report, "  Elapsed:                %.2f s (%.0f files/s)\n\n",
+            secs, secs > 0 ? ctx.elf_files / secs : 0.0);
+
+    int rc = ctx.weak ? 1 : 0;
+    if (ctx.sink) {
+        out_begin(&sink, "summary", "\x7f");
+        out_int(&sink, "elf_files", ctx.elf_files);
+        for (int b = 0; b < HARD_NBITS; b++) out_int(&sink, hard_flag_names[b], ctx.bits[b]);
+        out_int(&sink, "full_relro", ctx.full_relro);
+        out_int(&sink, "weak", ctx.weak);
+        out_int(&sink, "unreadable", stats.errors + ctx.failed);
+        out_end(&sink);
+        if (out_sink_close(&sink) < 0) {
+            fprintf(stderr, RED "[!]" RESET " Output failed: %s\n", strerror(errno));
+            rc = 2;
+        }
+    }
+    return rc;
+}
+
 /* ═══════════════════════════════════════════════════════════════════════════
  * MAIN
  * ═══════════════════════════════════════════════════════════════════════════ */
 
+/* The relocation type a slot record carries */
+static const char *reloc_name(uint32_t type) {
+    switch (type) {
+    case R_X86_64_NONE:         return NULL;
+    case R_X86_64_JUMP_SLOT:    return "JUMP_SLOT";
+    case R_X86_64_IRELATIVE:    return "IRELATIVE";
+    case R_X86_64_GLOB_DAT:     return "GLOB_DAT";
+    default:                    return "other";
+    }
+}
+
+/*
+ * --format: one "got" record per binary plus one per slot, or with
+ * --summary one per symbol version the slots bind instead of the slots
+ */
+int emit_binary(out_sink_t *sink, const char *filename, int summary) {
+    elf_view_t view;
+    section_info_t got_info, gotplt_info;
+    elf_versions_t vs;
+    plt_map_t map;
+
+    if (elf_view_open(&view, filename) < 0) {
+        fprintf(stderr, "%s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+    if (load_plt_map(&view, &vs, &map) < 0) {
+        fprintf(stderr, "%s: %s\n", filename, strerror(errno));
+        elf_view_close(&view);
+        return -1;
+    }
+
+    int have_got = find_section(&view, ".got", &got_info) == 0;
+    int have_gotplt = find_section(&view, ".got.plt", &gotplt_info) == 0;
+
+    out_begin(sink, "got", filename);
+    out_str(sink, "path", filename);
+    out_int(sink, "got_addr", have_got ? (int64_t)got_info.vaddr : 0);
+    out_int(sink, "got_entries", have_got ? (int64_t)(got_info.size / 8) : 0);
+    out_int(sink, "gotplt_addr", have_gotplt ? (int64_t)gotplt_info.vaddr : 0);
+    out_int(sink, "gotplt_entries", have_gotplt ? (int64_t)(gotplt_info.size / 8) : 0);
+    unsigned flags = hardening_from_view(&view);
+    out_str(sink, "relro", hardening_relro(flags));
+    out_bool(sink, "bind_now", flags & HARD_BIND_NOW);
+    out_int(sink, "pltgot_addr", map.nslots ? (int64_t)map.vaddr : 0);
+    out_int(sink, "plt_slots", map.nslots);
+    out_bool(sink, "slots_in_relro", slots_in_relro(&view, &map));
+    out_int(sink, "plt_relocs", map.nrela);
+    out_int(sink, "jump_slots", map.njump);
+    out_int(sink, "irelative", map.nirelative);
+    out_int(sink, "unmatched", map.noutside + map.nbadsym);
+    out_end(sink);
+
+    char key[4096 + 16];
+    if (summary) {
+        unsigned *by_ndx = calloc(vs.max_ndx + 1, sizeof(*by_ndx));
+        for (size_t i = 0; by_ndx && i < map.nslots; i++) {
+            uint16_t ndx = map.versym[i] & VERSYM_VERSION;
+            if (map.name[i] && vs.by_ndx && ndx <= vs.max_ndx && vs.by_ndx[ndx]) by_ndx[ndx]++;
+        }
+        for (uint16_t ndx = 0; by_ndx && ndx <= vs.max_ndx; ndx++) {
+            if (!by_ndx[ndx]) continue;
+            snprintf(key, sizeof(key), "%s\x1f%05u", filename, ndx);
+            out_begin(sink, "gotplt_version", key);
+            out_str(sink, "path", filename);
+            out_str(sink, "version", vs.by_ndx[ndx]);
+            out_int(sink, "slots", by_ndx[ndx]);
+            out_end(sink);
+        }
+        free(by_ndx);
+    }
+
+    for (size_t i = 0; !summary && map.values && i < map.nslots; i++) {
+        snprintf(key, sizeof(key), "%s\x1f%08zu", filename, i);
+        out_begin(sink, "gotplt_slot", key);
+        out_str(sink, "path", filename);
+        out_int(sink, "index", i);
+        out_int(sink, "addr", map.vaddr + i * 8);
+        out_int(sink, "value", map.values[i]);
+        out_str(sink, "reloc", reloc_name(map.type[i]));
+        out_str(sink, "symbol", map.name[i]);
+        out_str(sink, "version", map.name[i] ? elf_versions_name(&vs, map.versym[i]) : NULL);
+        out_end(sink);
+    }
+
+    free_plt_map(&vs, &map);
+    elf_view_close(&view);
+    return 0;
+}
+
+/* Map the binary once and run every analysis against the same view */
+int inspect_binary(const char *filename, int summary) {
+    elf_view_t view;
+
+    if (elf_view_open(&view, filename) < 0) {
+        perror(filename);
+        return -1;
+    }
+
+    analyze_got(&view, summary);
+    check_relro(&view);
+    elf_view_close(&view);
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
+    out_format_t format = OUT_TEXT;
+
+    if (argc > 2 && strcmp(argv[1], "--format") == 0) {
+        if (out_format_parse(argv[2], &format) < 0) {
+            fprintf(stderr, "Unknown format: %s\n", argv[2]);
+            return 2;
+        }
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+
+    /* --summary: decode every slot but print only the counts */
+    int summary = 0;
+    if (argc > 1 && strcmp(argv[1], "--summary") == 0) {
+        summary = 1;
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--imports") == 0) {
+        return census_mode(argc - 2, argv + 2, format);
+    }
+    if (argc > 1 && strcmp(argv[1], "--hardening") == 0) {
+        return hardening_mode(argc - 2, argv + 2, format);
+    }
+
+    if (format != OUT_TEXT) {
+        out_sink_t sink;
+        int rc = 0;
+
+        if (out_sink_open(&sink, STDOUT_FILENO, format, 1) < 0) {
+            perror("stdout");
+            return 2;
+        }
+        for (int i = 1; i < argc; i++) {
+            if (emit_binary(&sink, argv[i], summary) < 0) rc = 1;
+        }
+        if (out_sink_close(&sink) < 0) {
+            perror("stdout");
+            rc = 2;
+        }
+        return rc;
+    }
+
     printf("\n");
     printf(CYAN "╔════════════════════════════════════════════════════════════════════╗\n" RESET);
     printf(CYAN "║" RESET "                    GOT/PLT INSPECTOR UTILITY                       " CYAN "║\n" RESET);
     printf(CYAN "╚════════════════════════════════════════════════════════════════════╝\n" RESET);
 
     if (argc < 2) {
-        printf("\nUsage: %s <binary>\n", argv[0]);
+        printf("\nUsage: %s [--summary] <binary>\n", argv[0]);
+        printf("       %s --format jsonl|binary [--summary] <binary> ...\n", argv[0]);
+        printf("       %s [--format ...] --imports [--watch SYM,...|@FILE] [--threads N] <file|dir> ...\n",
+               argv[0]);
+        printf("       %s [--format ...] --hardening [--threads N] <file|dir> ...\n", argv[0]);
         printf("\nExample:\n");
         printf("  %s ./victim          # Analyze victim binary\n", argv[0]);
         printf("  %s /bin/ls           # Analyze system binary\n", argv[0]);
+        printf("  %s --summary a b c   # Slot counts and versions only\n", argv[0]);
 
         /* If no argument, analyze self */
         printf("\n" YELLOW "[*] No binary specified, analyzing self...\n" RESET);
@@ -336,13 +960,13 @@ int main(int argc, char *argv[]) {
         ssize_t len = readlink("/proc/self/exe", self_path, sizeof(self_path) - 1);
         if (len > 0) {
             self_path[len] = '\0';
-            analyze_got(self_path);
-            check_relro(self_path);
+            inspect_binary(self_path, summary);
             print_plt_explanation();
         }
+    } else if (summary) {
+        for (int i = 1; i < argc; i++) inspect_binary(argv[i], 1);
     } else {
-        analyze_got(argv[1]);
-        check_relro(argv[1]);
+        inspect_binary(argv[1], 0);
         print_plt_explanation();
     }
 
@@ -0,0 +1,154 @@
+/*
+ * hardening.c - checksec-style hardening flags of one ELF file
+ *
+ * See hardening.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "hardening.h"
+
+#define HEAD_SIZE       4096                /* ELF header and, nearly always, the phdrs */
+#define MAX_PHNUM       256
+#define MAX_DYN_SIZE    (64 * 1024)
+#define DYN_INLINE      128                 /* entries read into a stack buffer */
+
+const char *const hard_flag_names[HARD_NBITS] = {
+    "dynamic", "relro", "bind_now", "gnu_stack", "exec_stack",
+    "et_dyn", "pie", "textrel", "debug",
+};
+
+int hardening_loadable(const Elf64_Ehdr *ehdr) {
+    return ehdr->e_type == ET_EXEC || ehdr->e_type == ET_DYN;
+}
+
+unsigned hardening_eval(const Elf64_Ehdr *ehdr, const Elf64_Phdr *phdr, int phnum,
+                        const Elf64_Dyn *dyn, size_t ndyn) {
+    unsigned flags = 0;
+    int interp = 0;
+
+    if (!hardening_loadable(ehdr)) return 0;
+    if (ehdr->e_type == ET_DYN) flags |= HARD_ET_DYN;
+
+    for (int i = 0; i < phnum; i++) {
+        switch (phdr[i].p_type) {
+            case PT_DYNAMIC:
+                flags |= HARD_DYNAMIC;
+                break;
+            case PT_INTERP:
+                interp = 1;
+                break;
+            case PT_GNU_RELRO:
+                flags |= HARD_RELRO;
+                break;
+            case PT_GNU_STACK:
+                flags |= HARD_GNU_STACK;
+                if (phdr[i].p_flags & PF_X) flags |= HARD_EXEC_STACK;
+                break;
+        }
+    }
+    /* Without PT_GNU_STACK the loader falls back to an executable stack */
+    if (!(flags & HARD_GNU_STACK)) flags |= HARD_EXEC_STACK;
+
+    int pie_flag = 0, soname = 0;
+    for (size_t i = 0; dyn && i < ndyn && dyn[i].d_tag != DT_NULL; i++) {
+        switch (dyn[i].d_tag) {
+            case DT_FLAGS:
+                if (dyn[i].d_un.d_val & DF_BIND_NOW) flags |= HARD_BIND_NOW;
+                if (dyn[i].d_un.d_val & DF_TEXTREL) flags |= HARD_TEXTREL;
+                break;
+            case DT_FLAGS_1:
+                if (dyn[i].d_un.d_val & DF_1_NOW) flags |= HARD_BIND_NOW;
+                if (dyn[i].d_un.d_val & DF_1_PIE) pie_flag = 1;
+                break;
+            case DT_TEXTREL:
+                flags |= HARD_TEXTREL;
+                break;
+            case DT_DEBUG:
+                flags |= HARD_DEBUG;
+                break;
+            case DT_SONAME:
+                soname = 1;
+                break;
+        }
+    }
+
+    /* A DSO may carry PT_INTERP to be runnable; only pre-DF_1_PIE PIEs lack both */
+    if ((flags & HARD_ET_DYN) && (pie_flag || (interp && !soname))) flags |= HARD_PIE;
+    return flags;
+}
+
+unsigned hardening_from_view(const elf_view_t *v) {
+    return hardening_eval(v->ehdr, v->phdr, v->phnum, v->dynamic, v->dyn_count);
+}
+
+/* Exactly len bytes at off, or -1 (a short read means a truncated file) */
+static int pread_full(int fd, void *buf, size_t len, uint64_t off) {
+    ssize_t n = pread(fd, buf, len, off);
+    if (n == (ssize_t)len) return 0;
+    if (n >= 0) errno = ENOEXEC;
+    return -1;
+}
+
+int hardening_probe(int fd, unsigned *flags) {
+    /* 8-byte aligned, so the headers can be used in place */
+    uint64_t head[HEAD_SIZE / sizeof(uint64_t)];
+    ssize_t got = pread(fd, head, sizeof(head), 0);
+    if (got < 0) return -1;
+
+    const Elf64_Ehdr *eh = (const Elf64_Ehdr *)head;
+    if ((size_t)got < sizeof(*eh) ||
+        memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh->e_ident[EI_CLASS] != ELFCLASS64 ||
+        !hardening_loadable(eh) ||
+        eh->e_phentsize != sizeof(Elf64_Phdr) ||
+        eh->e_phnum == 0 || eh->e_phnum > MAX_PHNUM) {
+        errno = ENOEXEC;
+        return -1;
+    }
+
+    /* Program headers: from the header page, else one more read */
+    Elf64_Phdr phbuf[MAX_PHNUM];
+    const Elf64_Phdr *ph = phbuf;
+    size_t phsize = (size_t)eh->e_phnum * sizeof(Elf64_Phdr);
+    if (eh->e_phoff <= (uint64_t)got && phsize <= (uint64_t)got - eh->e_phoff &&
+        eh->e_phoff % sizeof(uint64_t) == 0) {
+        ph = (const Elf64_Phdr *)((const char *)head + eh->e_phoff);
+    } else if (pread_full(fd, phbuf, phsize, eh->e_phoff) < 0) {
+        return -1;
+    }
+
+    /* The dynamic segment: on the stack unless it is unusually large */
+    Elf64_Dyn dynbuf[DYN_INLINE];
+    Elf64_Dyn *dyn = NULL;
+    size_t ndyn = 0;
+    for (int i = 0; i < eh->e_phnum; i++) {
+        if (ph[i].p_type != PT_DYNAMIC) continue;
+        if (ph[i].p_filesz > MAX_DYN_SIZE) break;
+        ndyn = ph[i].p_filesz / sizeof(Elf64_Dyn);
+        dyn = ndyn <= DYN_INLINE ? dynbuf : malloc(ndyn * sizeof(*dyn));
+        if (!dyn) return -1;
+        if (pread_full(fd, dyn, ndyn * sizeof(*dyn), ph[i].p_offset) < 0) {
+            int saved = errno;
+            if (dyn != dynbuf) free(dyn);
+            errno = saved;
+            return -1;
+        }
+        break;
+    }
+
+    *flags = hardening_eval(eh, ph, eh->e_phnum, dyn, ndyn);
+    if (dyn != dynbuf) free(dyn);
+    return 0;
+}
+
+const char *hardening_relro(unsigned flags) {
+    if (!(flags & HARD_RELRO)) return "none";
+    return (flags & HARD_BIND_NOW) ? "full" : "partial";
+}
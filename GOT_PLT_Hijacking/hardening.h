@@ -0,0 +1,78 @@
+/*
+ * hardening.h - checksec-style hardening flags of one ELF file
+ *
+ * Everything got_inspector --hardening reports comes from three small
+ * pieces at known offsets: the ELF header, the program headers and the
+ * dynamic segment. hardening_probe() fetches them with pread() (one read
+ * for the header page, which almost always holds the program headers,
+ * and one for PT_DYNAMIC) instead of mapping the whole file:
+ *
+ *   ELF header         e_type               → ET_DYN
+ *   program headers    PT_GNU_RELRO         → RELRO
+ *                      PT_GNU_STACK p_flags → executable stack
+ *   dynamic segment    DT_FLAGS / FLAGS_1   → BIND_NOW, PIE, TEXTREL
+ *                      DT_TEXTREL, DT_DEBUG
+ *
+ * Only ET_EXEC and ET_DYN files are judged; relocatable objects and core
+ * dumps have no loader behaviour to harden. An ET_DYN file is a PIE
+ * executable when DT_FLAGS_1 has DF_1_PIE; the rest are shared objects,
+ * even those with a PT_INTERP of their own (libc.so.6, ld.so). Linkers
+ * older than DF_1_PIE leave only PT_INTERP without DT_SONAME as a hint.
+ *
+ * The verdict is a bitmask so a census can count it with a handful of
+ * atomic adds and store it in a single field.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef HARDENING_H
+#define HARDENING_H
+
+#include <stddef.h>
+#include <elf.h>
+
+#include "elf_view.h"
+
+#ifndef DF_1_PIE
+#define DF_1_PIE        0x08000000
+#endif
+
+typedef enum {
+    HARD_DYNAMIC    = 1 << 0,   /* has PT_DYNAMIC */
+    HARD_RELRO      = 1 << 1,   /* PT_GNU_RELRO */
+    HARD_BIND_NOW   = 1 << 2,   /* DF_BIND_NOW or DF_1_NOW */
+    HARD_GNU_STACK  = 1 << 3,   /* PT_GNU_STACK present */
+    HARD_EXEC_STACK = 1 << 4,   /* PT_GNU_STACK has PF_X, or is missing */
+    HARD_ET_DYN     = 1 << 5,
+    HARD_PIE        = 1 << 6,   /* ET_DYN executable: DF_1_PIE (see above) */
+    HARD_TEXTREL    = 1 << 7,   /* DT_TEXTREL or DF_TEXTREL */
+    HARD_DEBUG      = 1 << 8,   /* DT_DEBUG: ld.so publishes r_debug here */
+    HARD_NBITS      = 9
+} hard_flag_t;
+
+#define HARD_FULL_RELRO (HARD_RELRO | HARD_BIND_NOW)
+
+/* Flag names for reports, indexed by bit */
+extern const char *const hard_flag_names[HARD_NBITS];
+
+/* ET_EXEC or ET_DYN: the only files the flags mean anything for */
+int hardening_loadable(const Elf64_Ehdr *ehdr);
+
+/* Verdict from headers already in memory; dyn may be NULL */
+unsigned hardening_eval(const Elf64_Ehdr *ehdr, const Elf64_Phdr *phdr, int phnum,
+                        const Elf64_Dyn *dyn, size_t ndyn);
+
+/* Same, from an open view (0 if it is not loadable) */
+unsigned hardening_from_view(const elf_view_t *v);
+
+/*
+ * Read just the headers of fd with pread(). Returns 0 and the verdict
+ * in *flags, or -1 with errno set (ENOEXEC: not an ELF64 executable or
+ * shared object, so a census skips it).
+ */
+int hardening_probe(int fd, unsigned *flags);
+
+/* "none", "partial" or "full" */
+const char *hardening_relro(unsigned flags);
+
+#endif /* HARDENING_H */
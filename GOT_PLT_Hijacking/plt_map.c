@@ -0,0 +1,122 @@
+/*
+ * plt_map.c - .got.plt slots joined to the symbols that fill them
+ *
+ * See plt_map.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "plt_map.h"
+
+/*
+ * The columns share one block:
+ *
+ *   [addend[n]][name[n]][type[n]][versym[n]]
+ *
+ * widest first so every column stays aligned.
+ */
+static int columns_alloc(plt_map_t *m, size_t n) {
+    size_t size = n * (sizeof(*m->addend) + sizeof(*m->name) +
+                       sizeof(*m->type) + sizeof(*m->versym));
+    char *p = calloc(1, size ? size : 1);
+    if (!p) {
+        errno = ENOMEM;
+        return -1;
+    }
+    m->addend = (int64_t *)p;
+    p += n * sizeof(*m->addend);
+    m->name = (const char **)p;
+    p += n * sizeof(*m->name);
+    m->type = (uint32_t *)p;
+    p += n * sizeof(*m->type);
+    m->versym = (uint16_t *)p;
+    return 0;
+}
+
+void plt_map_free(plt_map_t *m) {
+    free(m->addend);
+    memset(m, 0, sizeof(*m));
+}
+
+int plt_tables_from_dynamic(plt_tables_t *t, const elf_view_t *v) {
+    memset(t, 0, sizeof(*t));
+    if (!elf_view_has(v, DT_JMPREL) || !elf_view_has(v, DT_PLTGOT)) return -1;
+    if (elf_view_has(v, DT_PLTREL) && elf_view_dyn(v, DT_PLTREL) != DT_RELA) return -1;
+
+    t->nrela = elf_view_dyn(v, DT_PLTRELSZ) / sizeof(Elf64_Rela);
+    t->rela = elf_view_vaddr(v, elf_view_dyn(v, DT_JMPREL), t->nrela * sizeof(Elf64_Rela));
+    if (!t->rela) {
+        t->nrela = 0;
+        return -1;
+    }
+
+    /*
+     * Nothing records the table's length. It ends after the highest slot
+     * a relocation targets, which is PLT_RESERVED + nrela unless the
+     * linker left gaps; a wild r_offset cannot stretch it past twice that.
+     */
+    t->vaddr = elf_view_dyn(v, DT_PLTGOT);
+    t->nslots = PLT_RESERVED + t->nrela;
+    for (size_t i = 0; i < t->nrela; i++) {
+        uint64_t slot = (t->rela[i].r_offset - t->vaddr) / sizeof(uint64_t);
+        if (slot >= t->nslots && slot < 2 * (PLT_RESERVED + t->nrela)) t->nslots = slot + 1;
+    }
+    t->values = elf_view_vaddr(v, t->vaddr, t->nslots * sizeof(uint64_t));
+    return 0;
+}
+
+int plt_map_build(plt_map_t *m, const elf_view_t *v, const elf_versions_t *vs,
+                  const plt_tables_t *t) {
+    memset(m, 0, sizeof(*m));
+    m->vaddr = t->vaddr;
+    m->nslots = t->nslots;
+    m->values = t->values;
+    m->nrela = t->nrela;
+    if (columns_alloc(m, t->nslots) < 0) return -1;
+
+    /* The version table already located .dynsym; don't count it twice */
+    size_t nsyms = 0;
+    const Elf64_Sym *syms = vs ? vs->dynsym : elf_view_dynsym(v, &nsyms);
+    const Elf64_Half *versym = vs ? vs->versym : NULL;
+    if (vs) nsyms = vs->nsyms;
+    if (!syms) nsyms = 0;
+
+    /*
+     * One pass, in table order. The slot test is a single unsigned
+     * compare: an r_offset below the table wraps to a huge index.
+     */
+    for (size_t i = 0; i < t->nrela; i++) {
+        const Elf64_Rela *r = &t->rela[i];
+        uint64_t delta = r->r_offset - t->vaddr;
+        uint64_t slot = delta / sizeof(uint64_t);
+        uint32_t type = ELF64_R_TYPE(r->r_info);
+        uint32_t sym = ELF64_R_SYM(r->r_info);
+
+        if (slot >= t->nslots || (delta % sizeof(uint64_t))) {
+            m->noutside++;
+            continue;
+        }
+        m->type[slot] = type;
+        m->addend[slot] = r->r_addend;
+
+        if (type == R_X86_64_IRELATIVE) {
+            m->nirelative++;
+            continue;
+        }
+        if (type == R_X86_64_JUMP_SLOT) m->njump++;
+        else m->nother++;
+
+        if (sym >= nsyms) {
+            m->nbadsym += sym != 0;
+            continue;
+        }
+        m->name[slot] = elf_view_dynstr(v, syms[sym].st_name);
+        m->versym[slot] = versym ? versym[sym] : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * plt_map.h - .got.plt slots joined to the symbols that fill them
+ *
+ * Every PLT slot is written by exactly one relocation in .rela.plt
+ * (DT_JMPREL). The relocation names the slot by address and the
+ * symbol by .dynsym index, so one pass over the table is enough to
+ * label every slot:
+ *
+ *   .rela.plt[i] ──r_offset──→ slot = (r_offset - table) / 8
+ *                └─r_info────→ sym ──→ .dynsym[sym].st_name ──→ .dynstr
+ *                                  └──→ .gnu.version[sym] ───→ GLIBC_2.34
+ *
+ * Both tables are found through the dynamic segment alone, the way
+ * ld.so finds them, so stripped section headers do not matter:
+ *
+ *   DT_JMPREL, DT_PLTRELSZ   the relocations (DT_PLTREL must be DT_RELA)
+ *   DT_PLTGOT                slot 0; three words reserved for ld.so
+ *                            (_DYNAMIC, link_map, resolver), then the
+ *                            slots, normally one per PLT relocation
+ *
+ * The result is kept as columns (one array per field, indexed by slot)
+ * rather than one struct per slot: the decode loop only writes, the
+ * summary only reads the columns it counts, and nothing is formatted
+ * until someone asks for a row.
+ *
+ * Names point into the view's .dynstr: a map is valid until the view
+ * is closed.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef PLT_MAP_H
+#define PLT_MAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <elf.h>
+
+#include "elf_view.h"
+#include "elf_version.h"
+
+#define PLT_RESERVED    3           /* GOT[0..2] */
+
+/* Where the slots and their relocations are */
+typedef struct {
+    uint64_t            vaddr;      /* first slot */
+    size_t              nslots;
+    const uint64_t     *values;     /* link-time contents; NULL if not in the file */
+    const Elf64_Rela   *rela;
+    size_t              nrela;
+} plt_tables_t;
+
+typedef struct {
+    uint64_t            vaddr;
+    size_t              nslots;
+    const uint64_t     *values;
+
+    /* Per slot, from the relocation that targets it */
+    uint32_t           *type;       /* R_X86_64_*; R_X86_64_NONE: no relocation */
+    const char        **name;       /* NULL: no symbol (reserved, IRELATIVE, bad index) */
+    uint16_t           *versym;     /* .gnu.version entry; 0 if unversioned */
+    int64_t            *addend;     /* IRELATIVE: the resolver's address */
+
+    size_t              nrela;
+    size_t              njump;      /* R_X86_64_JUMP_SLOT */
+    size_t              nirelative; /* R_X86_64_IRELATIVE */
+    size_t              nother;     /* any other type */
+    size_t              noutside;   /* r_offset is not a slot of the table */
+    size_t              nbadsym;    /* symbol index past the end of .dynsym */
+} plt_map_t;
+
+/*
+ * Locate the tables from v's dynamic segment. Returns 0, or -1 if the
+ * file has no PLT relocations ld.so would process (no DT_JMPREL or
+ * DT_PLTGOT, DT_PLTREL other than DT_RELA, or a table outside the file).
+ */
+int plt_tables_from_dynamic(plt_tables_t *t, const elf_view_t *v);
+
+/*
+ * Decode t->rela against v's .dynsym and, if vs is non-NULL, its
+ * version table. Returns 0, or -1 on ENOMEM.
+ */
+int plt_map_build(plt_map_t *m, const elf_view_t *v, const elf_versions_t *vs,
+                  const plt_tables_t *t);
+void plt_map_free(plt_map_t *m);
+
+#endif /* PLT_MAP_H */
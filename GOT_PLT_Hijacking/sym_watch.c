@@ -0,0 +1,182 @@
+/*
+ * sym_watch.c - Compiled watch list of symbol names (perfect hash)
+ *
+ * See sym_watch.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "sym_watch.h"
+
+/* Displacements tried per bucket before the table is doubled */
+#define MAX_DISP    (1u << 16)
+
+static uint64_t name_hash(const char *s, size_t *len) {
+    /* FNV-1a */
+    const char *p = s;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*p) {
+        h = (h ^ (unsigned char)*p++) * 0x100000001b3ULL;
+    }
+    *len = p - s;
+    return h;
+}
+
+static uint32_t slot_of(uint64_t h, uint32_t d, uint32_t mask) {
+    /* splitmix64 finalizer */
+    uint64_t x = h ^ (d * 0x9e3779b97f4a7c15ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return (uint32_t)(x ^ (x >> 31)) & mask;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BUILD
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    uint32_t bucket;
+    uint32_t key;
+} bucket_key_t;
+
+/* Largest buckets first: they are the hardest to place */
+static int cmp_bucket(const void *a, const void *b, void *arg) {
+    const uint32_t *size = arg;
+    const bucket_key_t *x = a, *y = b;
+    uint32_t sx = size[x->bucket], sy = size[y->bucket];
+    if (sx != sy) return sx > sy ? -1 : 1;
+    if (x->bucket != y->bucket) return x->bucket < y->bucket ? -1 : 1;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+/* Place every key at the current table size; 0, or -1 if some bucket would not fit */
+static int place(sym_watch_t *w, const uint64_t *hash, bucket_key_t *order, uint32_t *size) {
+    uint32_t nslots = w->mask + 1;
+
+    for (uint32_t s = 0; s < nslots; s++) w->slots[s] = SYM_WATCH_NONE;
+    memset(w->disp, 0, w->nbuckets * sizeof(*w->disp));
+    memset(size, 0, w->nbuckets * sizeof(*size));
+    for (uint32_t k = 0; k < w->n; k++) {
+        order[k].bucket = (uint32_t)(hash[k] >> 32) % w->nbuckets;
+        order[k].key = k;
+        size[order[k].bucket]++;
+    }
+    qsort_r(order, w->n, sizeof(*order), cmp_bucket, size);
+
+    for (uint32_t i = 0; i < w->n; ) {
+        uint32_t b = order[i].bucket, end = i;
+        while (end < w->n && order[end].bucket == b) end++;
+
+        uint32_t d;
+        for (d = 1; d < MAX_DISP; d++) {
+            uint32_t k;
+            for (k = i; k < end; k++) {
+                uint32_t s = slot_of(hash[order[k].key], d, w->mask);
+                if (w->slots[s] != SYM_WATCH_NONE) break;
+                w->slots[s] = order[k].key;     /* tentative */
+            }
+            if (k == end) break;
+            while (k-- > i) w->slots[slot_of(hash[order[k].key], d, w->mask)] = SYM_WATCH_NONE;
+        }
+        if (d == MAX_DISP) return -1;
+        w->disp[b] = d;
+        i = end;
+    }
+
+    for (uint32_t s = 0; s < nslots; s++) {
+        w->hashes[s] = w->slots[s] == SYM_WATCH_NONE ? 0 : hash[w->slots[s]];
+    }
+    return 0;
+}
+
+int sym_watch_build(sym_watch_t *w, const char *const *names, size_t n) {
+    memset(w, 0, sizeof(*w));
+
+    w->names = calloc(n ? n : 1, sizeof(*w->names));
+    uint64_t *hash = malloc((n ? n : 1) * sizeof(*hash));
+    if (!w->names || !hash) goto nomem;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t len;
+        uint64_t h = name_hash(names[i], &len);
+        int dup = len == 0;
+        for (uint32_t k = 0; !dup && k < w->n; k++) {
+            dup = hash[k] == h && strcmp(w->names[k], names[i]) == 0;
+        }
+        if (dup) continue;
+        if (w->n == SYM_WATCH_MAX) {
+            free(hash);
+            sym_watch_free(w);
+            errno = EINVAL;
+            return -1;
+        }
+        w->names[w->n] = strdup(names[i]);
+        if (!w->names[w->n]) goto nomem;
+        hash[w->n++] = h;
+        w->lengths |= 1ULL << (len < 63 ? len : 63);
+    }
+
+    /* Load factor <= 1/2 and about four keys per bucket place at once */
+    uint32_t nslots = 8;
+    while (nslots < 2 * w->n) nslots *= 2;
+    w->nbuckets = w->n / 4 + 1;
+    w->disp = malloc(w->nbuckets * sizeof(*w->disp));
+    bucket_key_t *order = malloc((w->n ? w->n : 1) * sizeof(*order));
+    uint32_t *size = malloc(w->nbuckets * sizeof(*size));
+
+    int placed = -1;
+    while (w->disp && order && size && placed < 0 && nslots <= 16 * SYM_WATCH_MAX) {
+        free(w->slots);
+        free(w->hashes);
+        w->slots = malloc(nslots * sizeof(*w->slots));
+        w->hashes = malloc(nslots * sizeof(*w->hashes));
+        if (!w->slots || !w->hashes) break;
+        w->mask = nslots - 1;
+        placed = place(w, hash, order, size);
+        nslots *= 2;
+    }
+    free(order);
+    free(size);
+    free(hash);
+    hash = NULL;
+    if (placed < 0) goto nomem;     /* only two names with one 64-bit hash could get here */
+    return 0;
+
+nomem:
+    free(hash);
+    sym_watch_free(w);
+    errno = ENOMEM;
+    return -1;
+}
+
+void sym_watch_free(sym_watch_t *w) {
+    for (uint32_t i = 0; w->names && i < w->n; i++) free(w->names[i]);
+    free(w->names);
+    free(w->hashes);
+    free(w->slots);
+    free(w->disp);
+    memset(w, 0, sizeof(*w));
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * LOOKUP
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+uint32_t sym_watch_find(const sym_watch_t *w, const char *name) {
+    if (!w->n) return SYM_WATCH_NONE;
+
+    /* Length filter first: most imports are rejected after at most 63 bytes */
+    size_t len = strnlen(name, 63);
+    if (!(w->lengths & (1ULL << len))) return SYM_WATCH_NONE;
+
+    uint64_t h = name_hash(name, &len);
+    uint32_t d = w->disp[(uint32_t)(h >> 32) % w->nbuckets];
+    uint32_t s = slot_of(h, d, w->mask);
+    if (w->slots[s] == SYM_WATCH_NONE || w->hashes[s] != h) return SYM_WATCH_NONE;
+    return strcmp(w->names[w->slots[s]], name) == 0 ? w->slots[s] : SYM_WATCH_NONE;
+}
@@ -0,0 +1,57 @@
+/*
+ * sym_watch.h - Compiled watch list of symbol names (perfect hash)
+ *
+ * The import census (got_inspector --imports) tests every undefined
+ * .dynsym entry of every binary against a fixed list of names. The
+ * list is compiled once into a minimal-probe perfect hash (hash and
+ * displace):
+ *
+ *   name ──FNV-1a 64──→ h
+ *                        │ bucket = (h >> 32) % nbuckets
+ *                        ▼
+ *              disp[bucket] = d ──→ slot = mix(h ^ d·φ) & mask
+ *                                        │
+ *                                        ▼
+ *                        slots[slot] → watch index, or empty
+ *
+ * Every displacement is chosen at build time so that no two names share
+ * a slot, so a lookup is one hash of the name, two table reads and one
+ * 64-bit compare; strcmp only runs on a real hit. A length bitmap
+ * rejects most names before they are hashed at all.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef SYM_WATCH_H
+#define SYM_WATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SYM_WATCH_MAX   1024    /* names per list */
+#define SYM_WATCH_NONE  0xffffffffu
+
+typedef struct {
+    char     **names;           /* deduplicated, in list order */
+    uint32_t   n;
+
+    uint64_t  *hashes;          /* per slot: FNV-1a of the name stored there */
+    uint32_t  *slots;           /* per slot: watch index or SYM_WATCH_NONE */
+    uint32_t   mask;
+    uint32_t  *disp;            /* per bucket displacement */
+    uint32_t   nbuckets;
+
+    uint64_t   lengths;         /* bit min(len, 63) set for every name */
+} sym_watch_t;
+
+/*
+ * Compile a watch list; duplicate and empty names are dropped.
+ * Returns 0, or -1 with errno set (EINVAL: more than SYM_WATCH_MAX names).
+ */
+int sym_watch_build(sym_watch_t *w, const char *const *names, size_t n);
+void sym_watch_free(sym_watch_t *w);
+
+/* Watch index of name, or SYM_WATCH_NONE */
+uint32_t sym_watch_find(const sym_watch_t *w, const char *name);
+
+#endif /* SYM_WATCH_H */
@@ -2,7 +2,21 @@
  * version_explorer.c - Symbol Versioning Explorer
  *
  * Demonstrates how symbol versioning works and shows the ELF sections
- * involved. Uses system tools for reliable parsing.
+ * involved. With -v, the version tables of any number of files are
+ * parsed in-process (common/elf_version.c): no readelf, no shell.
+ * With --index, the tables of a whole tree go into a column-store
+ * index (version_index.h) that later queries answer in milliseconds.
+ *
+ * Usage: ./version_explorer            Explanation and demo
+ *        ./version_explorer -v         ... plus this binary's version tables
+ *        ./version_explorer -v FILE... Version tables of each FILE only
+ *        ./version_explorer --index IDX [--threads N] <file|dir>...
+ *        ./version_explorer --requires IDX VERSION   e.g. GLIBC_2.34 or newer
+ *        ./version_explorer --unsatisfied IDX        needed, but not defined
+ *
+ * Compile: gcc -I../common -pthread -o version_explorer version_explorer.c \
+ *              version_index.c ../common/elf_view.c ../common/read_batch.c \
+ *              ../common/elf_version.c ../common/fs_walk.c ../common/task_pool.c -ldl
  *
  * EDUCATIONAL PURPOSES ONLY
  */
@@ -12,8 +26,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <time.h>
 #include <dlfcn.h>
 
+#include "elf_view.h"
+#include "elf_version.h"
+#include "version_index.h"
+
 /* Color codes */
 #define RED     "\033[1;31m"
 #define GREEN   "\033[1;32m"
@@ -124,21 +144,289 @@ void demonstrate_versioning(void) {
     printf("      Can be hijacked to steal sensitive env vars!\n\n");
 }
 
+/* ═══════════════════════════════════════════════════════════════════════════
+ * VERSION TABLES (.gnu.version, .gnu.version_r, .gnu.version_d)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int show_version_tables(const char *path) {
+    elf_view_t view;
+    elf_versions_t vs;
+
+    if (elf_view_open(&view, path) < 0) {
+        fprintf(stderr, RED "[!]" RESET " %s: %s\n", path,
+                errno == ENOEXEC ? "not a 64-bit ELF file" : strerror(errno));
+        return -1;
+    }
+    if (elf_versions_load(&vs, &view) < 0) {
+        fprintf(stderr, RED "[!]" RESET " %s: %s\n", path, strerror(errno));
+        elf_view_close(&view);
+        return -1;
+    }
+
+    printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    printf(CYAN "  VERSION TABLES: %s\n" RESET, path);
+    printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
+    printf("\n");
+
+    if (!vs.versym && !vs.nneeds && !vs.ndefs) {
+        printf("  (no symbol version information)\n\n");
+        elf_versions_free(&vs);
+        elf_view_close(&view);
+        return 0;
+    }
+
+    /* Requirements: library → version → the symbols bound to it */
+    if (vs.nneeds) {
+        printf(YELLOW "  Required versions (.gnu.version_r):\n" RESET);
+        for (size_t i = 0; i < vs.nneeds; i++) {
+            const elf_verneed_t *vn = &vs.needs[i];
+            if (i == 0 || strcmp(vn->file, vs.needs[i - 1].file) != 0) {
+                printf("    %s\n", vn->file);
+            }
+
+            int count = 0;
+            for (size_t s = 1; vs.versym && s < vs.nsyms; s++) {
+                if ((vs.versym[s] & VERSYM_VERSION) == vn->ndx) count++;
+            }
+            printf("      " GREEN "%-20s" RESET " %3d symbol%s%s", vn->name, count, count == 1 ? "" : "s",
+                   (vn->flags & VER_FLG_WEAK) ? " (weak)" : "");
+
+            const char *sep = ": ";
+            for (size_t s = 1; vs.versym && s < vs.nsyms; s++) {
+                if ((vs.versym[s] & VERSYM_VERSION) != vn->ndx) continue;
+                const char *name = elf_view_dynstr(&view, vs.dynsym[s].st_name);
+                printf("%s%s", sep, name ? name : "?");
+                sep = ", ";
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+
+    /* Definitions: what this object provides, with version inheritance */
+    if (vs.ndefs) {
+        printf(YELLOW "  Defined versions (.gnu.version_d):\n" RESET);
+        for (size_t i = 0; i < vs.ndefs; i++) {
+            const elf_verdef_t *vd = &vs.defs[i];
+            int count = 0, hidden = 0;
+
+            for (size_t s = 1; vs.versym && s < vs.nsyms; s++) {
+                if ((vs.versym[s] & VERSYM_VERSION) != vd->ndx || vs.dynsym[s].st_shndx == SHN_UNDEF) continue;
+                count++;
+                if (vs.versym[s] & VERSYM_HIDDEN) hidden++;
+            }
+
+            if (vd->flags & VER_FLG_BASE) {
+                printf("    [%2u] %s (base)\n", vd->ndx, vd->name);
+            } else {
+                printf("    [%2u] " GREEN "%-20s" RESET " %4d symbol%s", vd->ndx, vd->name,
+                       count, count == 1 ? "" : "s");
+                if (hidden) printf(", %d hidden (compat)", hidden);
+                if (vd->parent) printf("  ← %s", vd->parent);
+                printf("\n");
+            }
+        }
+        printf("\n");
+    }
+
+    if (vs.versym) {
+        size_t versioned = 0;
+        for (size_t s = 1; s < vs.nsyms; s++) {
+            if ((vs.versym[s] & VERSYM_VERSION) > VER_NDX_GLOBAL) versioned++;
+        }
+        printf("  Versioned symbols (.gnu.version): %zu of %zu dynamic symbols\n\n",
+               versioned, vs.nsyms ? vs.nsyms - 1 : 0);
+    }
+
+    elf_versions_free(&vs);
+    elf_view_close(&view);
+    return 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * FLEET INDEX (version_index.h)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static double elapsed_ms(const struct timespec *t0, const struct timespec *t1) {
+    return ((t1->tv_sec - t0->tv_sec) * 1e9 + (t1->tv_nsec - t0->tv_nsec)) / 1e6;
+}
+
+int index_mode(const char *index_file, int argc, char *argv[]) {
+    const char *roots[256];
+    int nroots = 0;
+    int nthreads = 0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            nthreads = atoi(argv[++i]);
+        } else if (nroots < 256) {
+            roots[nroots++] = argv[i];
+        }
+    }
+    if (nroots == 0) {
+        fprintf(stderr, RED "[!] --index needs at least one file or directory\n" RESET);
+        return 1;
+    }
+
+    version_index_opts_t opts = {
+        .roots = roots,
+        .nroots = nroots,
+        .nthreads = nthreads,
+    };
+    version_index_stats_t stats;
+    struct timespec t0, t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int rc = version_index_build(&opts, index_file, &stats);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc < 0) {
+        fprintf(stderr, RED "[!] Failed to write index %s: %s\n" RESET, index_file, strerror(errno));
+        return 1;
+    }
+
+    printf(GREEN "[+] Version index saved to %s\n" RESET, index_file);
+    printf("  ELF files parsed:     %lu\n", stats.files);
+    printf("  Dynamic objects:      %lu\n", stats.objects);
+    printf("  Required versions:    %lu rows\n", stats.needs);
+    printf("  Defined versions:     %lu rows\n", stats.defs);
+    if (stats.errors) printf("  Unreadable:           %lu\n", stats.errors);
+    printf("  Elapsed:              %.2f s\n\n", elapsed_ms(&t0, &t1) / 1e3);
+    return 0;
+}
+
+static int open_index(version_index_t *idx, const char *index_file) {
+    if (version_index_open(idx, index_file) < 0) {
+        fprintf(stderr, RED "[!] Cannot read index %s: %s\n" RESET, index_file, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static void print_query_footer(const version_index_t *idx, const struct timespec *t0,
+                               const struct timespec *t1) {
+    char built[64];
+    time_t when = (time_t)idx->built;
+    strftime(built, sizeof(built), "%Y-%m-%d %H:%M:%S", localtime(&when));
+    printf("  Query time: %.3f ms (index built %s)\n\n", elapsed_ms(t0, t1), built);
+}
+
+/* Objects needing version or newer, each with the newest version it needs */
+int requires_query(const char *index_file, const char *version) {
+    version_index_t idx;
+    struct timespec t0, t1;
+
+    if (open_index(&idx, index_file) < 0) return 1;
+
+    uint32_t *best = malloc((idx.nobjs ? idx.nobjs : 1) * sizeof(*best));
+    if (!best) {
+        fprintf(stderr, RED "[!] Out of memory\n" RESET);
+        version_index_close(&idx);
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint32_t matched = version_index_requires(&idx, version, best);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    for (uint32_t o = 0; o < idx.nobjs; o++) {
+        if (best[o] == VIDX_NONE) continue;
+        printf("  %-60s " GREEN "%-16s" RESET " %s\n", version_index_path(&idx, o),
+               version_index_version(&idx, idx.need_ver[best[o]]),
+               version_index_name(&idx, idx.need_lib[best[o]]));
+    }
+    printf("\n  " RED "%u" RESET " of %u indexed objects require %s or newer\n",
+           matched, idx.nobjs, version);
+    print_query_footer(&idx, &t0, &t1);
+
+    free(best);
+    version_index_close(&idx);
+    return 0;
+}
+
+/* Needed versions that no indexed object with the right soname defines */
+int unsatisfied_query(const char *index_file) {
+    version_index_t idx;
+    struct timespec t0, t1;
+    uint32_t *rows;
+    size_t nrows, unindexed;
+
+    if (open_index(&idx, index_file) < 0) return 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int rc = version_index_unsatisfied(&idx, &rows, &nrows, &unindexed);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (rc < 0) {
+        fprintf(stderr, RED "[!] Out of memory\n" RESET);
+        version_index_close(&idx);
+        return 1;
+    }
+
+    /* Rows arrive grouped by (library, version) */
+    for (size_t i = 0; i < nrows; i++) {
+        uint32_t r = rows[i];
+        if (i == 0 || idx.need_lib[r] != idx.need_lib[rows[i - 1]] ||
+            idx.need_ver[r] != idx.need_ver[rows[i - 1]]) {
+            printf("  " YELLOW "%s" RESET " does not define " RED "%s" RESET "\n",
+                   version_index_name(&idx, idx.need_lib[r]),
+                   version_index_version(&idx, idx.need_ver[r]));
+        }
+        printf("    %s%s\n", version_index_path(&idx, idx.need_obj[r]),
+               (idx.need_flags[r] & VER_FLG_WEAK) ? " (weak: warning only)" : "");
+    }
+    if (nrows) printf("\n");
+
+    printf("  " RED "%zu" RESET " unsatisfied version requirement%s", nrows, nrows == 1 ? "" : "s");
+    if (unindexed) printf(" (%zu more from libraries not in the index)", unindexed);
+    printf("\n");
+    print_query_footer(&idx, &t0, &t1);
+
+    free(rows);
+    version_index_close(&idx);
+    return nrows ? 1 : 0;
+}
+
+static int usage(const char *prog) {
+    fprintf(stderr, "\nUsage: %s                  Explanation and demo\n", prog);
+    fprintf(stderr, "       %s -v [FILE...]\n", prog);
+    fprintf(stderr, "       %s --index IDX [--threads N] <file|dir>...\n", prog);
+    fprintf(stderr, "       %s --requires IDX VERSION\n", prog);
+    fprintf(stderr, "       %s --unsatisfied IDX\n\n", prog);
+    return 1;
+}
+
 int main(int argc, char *argv[]) {
+    /* A query mode with its arguments missing must not fall through to the demo */
+    if (argc > 1 && ((strcmp(argv[1], "--index") == 0 && argc < 3) ||
+                     (strcmp(argv[1], "--requires") == 0 && argc < 4) ||
+                     (strcmp(argv[1], "--unsatisfied") == 0 && argc < 3))) {
+        fprintf(stderr, RED "[!] %s: missing argument\n" RESET, argv[1]);
+        return usage(argv[0]);
+    }
+    if (argc > 2 && strcmp(argv[1], "--index") == 0) {
+        return index_mode(argv[2], argc - 3, argv + 3);
+    }
+    if (argc > 3 && strcmp(argv[1], "--requires") == 0) {
+        return requires_query(argv[2], argv[3]);
+    }
+    if (argc > 2 && strcmp(argv[1], "--unsatisfied") == 0) {
+        return unsatisfied_query(argv[2]);
+    }
+
+    /* -v FILE...: just the tables, one pass per file, any number of files */
+    if (argc > 2 && strcmp(argv[1], "-v") == 0) {
+        int rc = 0;
+        for (int i = 2; i < argc; i++) {
+            if (show_version_tables(argv[i]) < 0) rc = 1;
+        }
+        return rc;
+    }
+
     print_versioning_explanation();
     demonstrate_versioning();
 
-    /* Optionally show version info using system tools */
+    /* Optionally show our own version tables */
     if (argc > 1 && strcmp(argv[1], "-v") == 0) {
-        printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
-        printf(CYAN "  VERSION REQUIREMENTS (via readelf)\n" RESET);
-        printf(CYAN "═══════════════════════════════════════════════════════════════════\n" RESET);
-        printf("\n");
-
-        char cmd[256];
-        snprintf(cmd, sizeof(cmd), "readelf -V %s 2>/dev/null | head -50", argv[0]);
-        printf("  Running: %s\n\n", cmd);
-        system(cmd);
+        show_version_tables("/proc/self/exe");
     }
 
     printf(GREEN "[✓] Explorer complete.\n" RESET);
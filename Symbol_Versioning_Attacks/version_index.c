@@ -0,0 +1,860 @@
+/*
+ * version_index.c - Fleet-wide symbol version index (column store)
+ *
+ * See version_index.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "version_index.h"
+#include "elf_view.h"
+#include "elf_version.h"
+#include "fs_walk.h"
+
+#define VIDX_MAGIC      "VERIDX01"
+#define VIDX_VERSION    1
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t nobjs;
+    uint32_t nnames;
+    uint32_t nvers;
+    uint32_t nneeds;
+    uint32_t ndefs;
+    int64_t  built;
+
+    /* Column offsets from the start of the file, each 8-aligned */
+    uint64_t obj_path_off;
+    uint64_t obj_name_off;
+    uint64_t name_off_off;
+    uint64_t name_flags_off;
+    uint64_t ver_off_off;
+    uint64_t need_obj_off;
+    uint64_t need_lib_off;
+    uint64_t need_ver_off;
+    uint64_t need_flags_off;
+    uint64_t def_obj_off;
+    uint64_t def_lib_off;
+    uint64_t def_ver_off;
+    uint64_t strings_off;
+    uint64_t strings_size;
+} vidx_header_t;
+
+static uint64_t align8(uint64_t n) {
+    return (n + 7) & ~(uint64_t)7;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * VERSION ORDER
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Length of the family part: up to the first "_<digit>", else the whole name */
+static size_t family_len(const char *s) {
+    for (const char *p = s; *p; p++) {
+        if (*p == '_' && isdigit((unsigned char)p[1])) return p + 1 - s;
+    }
+    return strlen(s);
+}
+
+static int family_cmp(const char *a, size_t la, const char *b, size_t lb) {
+    int c = memcmp(a, b, la < lb ? la : lb);
+    if (c) return c;
+    return (la > lb) - (la < lb);
+}
+
+int version_cmp(const char *a, const char *b) {
+    size_t la = family_len(a), lb = family_len(b);
+    int c = family_cmp(a, la, b, lb);
+    if (c) return c;
+
+    /* 2.2.5 < 2.14 < 2.34 < 2.34.1; separators are '.' or '_' */
+    const char *p = a + la, *q = b + lb;
+    for (;;) {
+        int dp = isdigit((unsigned char)*p), dq = isdigit((unsigned char)*q);
+        if (!dp || !dq) {
+            if (dp != dq) return dp - dq;
+            break;
+        }
+        char *ep, *eq;
+        unsigned long long x = strtoull(p, &ep, 10);
+        unsigned long long y = strtoull(q, &eq, 10);
+        if (x != y) return x < y ? -1 : 1;
+        p = ep;
+        q = eq;
+        if ((*p == '.' || *p == '_') && (*q == '.' || *q == '_')) {
+            p++;
+            q++;
+        }
+    }
+    return strcmp(a, b);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BUILD: DICTIONARIES (caller holds b->lock)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct dict_entry {
+    struct dict_entry *next;
+    uint64_t           hash;
+    uint32_t           id;
+    char               key[];
+} dict_entry_t;
+
+typedef struct {
+    dict_entry_t **buckets;
+    size_t         nbuckets;
+    dict_entry_t **by_id;
+    uint32_t       n;
+    uint32_t       cap;
+} dict_t;
+
+static uint64_t key_hash(const char *s) {
+    /* FNV-1a */
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*s) {
+        h = (h ^ (unsigned char)*s++) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/* Id of key, added if new; VIDX_NONE when out of memory */
+static uint32_t dict_intern(dict_t *d, const char *key, int *added) {
+    uint64_t hash = key_hash(key);
+    if (added) *added = 0;
+
+    if (d->nbuckets) {
+        for (dict_entry_t *e = d->buckets[hash & (d->nbuckets - 1)]; e; e = e->next) {
+            if (e->hash == hash && strcmp(e->key, key) == 0) return e->id;
+        }
+    }
+
+    if (d->n >= d->cap) {
+        uint32_t cap = d->cap ? d->cap * 2 : 256;
+        if (cap >= VIDX_NONE) return VIDX_NONE;
+        dict_entry_t **by_id = realloc(d->by_id, (size_t)cap * sizeof(*by_id));
+        dict_entry_t **buckets = calloc(cap, sizeof(*buckets));
+        if (by_id) d->by_id = by_id;
+        if (!by_id || !buckets) {
+            free(buckets);
+            return VIDX_NONE;
+        }
+        for (uint32_t i = 0; i < d->n; i++) {
+            dict_entry_t *e = d->by_id[i];
+            e->next = buckets[e->hash & (cap - 1)];
+            buckets[e->hash & (cap - 1)] = e;
+        }
+        free(d->buckets);
+        d->buckets = buckets;
+        d->nbuckets = cap;
+        d->cap = cap;
+    }
+
+    size_t len = strlen(key) + 1;
+    dict_entry_t *e = malloc(sizeof(*e) + len);
+    if (!e) return VIDX_NONE;
+    e->hash = hash;
+    e->id = d->n;
+    memcpy(e->key, key, len);
+    e->next = d->buckets[hash & (d->nbuckets - 1)];
+    d->buckets[hash & (d->nbuckets - 1)] = e;
+    d->by_id[d->n++] = e;
+    if (added) *added = 1;
+    return e->id;
+}
+
+static void dict_free(dict_t *d) {
+    for (uint32_t i = 0; i < d->n; i++) free(d->by_id[i]);
+    free(d->by_id);
+    free(d->buckets);
+    memset(d, 0, sizeof(*d));
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BUILD: WALK
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    uint32_t obj;
+    uint32_t lib;
+    uint32_t ver;
+    uint32_t flags;
+} vidx_row_t;
+
+typedef struct {
+    uint32_t path;              /* id in builder.paths */
+    uint32_t name;              /* id in builder.names; VIDX_NONE until named by path */
+    uint32_t versioned;         /* has a .gnu.version_d */
+} vidx_obj_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+
+    dict_t      inodes;         /* "<dev>:<ino>" → object id */
+    dict_t      paths;
+    dict_t      names;
+    dict_t      vers;
+
+    vidx_obj_t *objs;
+    uint32_t    nobjs, capobjs;
+    vidx_row_t *needs;
+    size_t      nneeds, capneeds;
+    vidx_row_t *defs;
+    size_t      ndefs, capdefs;
+
+    version_index_stats_t stats;
+    int         oom;
+} builder_t;
+
+static int push_row(vidx_row_t **rows, size_t *n, size_t *cap, vidx_row_t row) {
+    if (*n >= *cap) {
+        size_t c = *cap ? *cap * 2 : 1024;
+        vidx_row_t *r = realloc(*rows, c * sizeof(*r));
+        if (!r) return -1;
+        *rows = r;
+        *cap = c;
+    }
+    (*rows)[(*n)++] = row;
+    return 0;
+}
+
+/*
+ * Add one parsed object and its rows (caller holds b->lock). A file
+ * reached through several hard links is indexed once, under its
+ * smallest path, so the choice does not depend on the walk order.
+ * soname is NULL when the object has none; it is then named after
+ * that path once the walk is over (name_by_path()).
+ */
+static int add_object(builder_t *b, const elf_view_t *v, const elf_versions_t *vs,
+                      const char *path, const char *soname) {
+    char key[64];
+    int added;
+    snprintf(key, sizeof(key), "%lx:%lx", (unsigned long)v->st.st_dev, (unsigned long)v->st.st_ino);
+    uint32_t id = dict_intern(&b->inodes, key, &added);
+    if (id == VIDX_NONE) return -1;
+    if (!added) {
+        vidx_obj_t *o = &b->objs[id];
+        if (strcmp(path, b->paths.by_id[o->path]->key) < 0) {
+            o->path = dict_intern(&b->paths, path, NULL);
+            if (o->path == VIDX_NONE) return -1;
+        }
+        return 0;
+    }
+
+    if (b->nobjs >= b->capobjs) {
+        uint32_t c = b->capobjs ? b->capobjs * 2 : 1024;
+        vidx_obj_t *o = realloc(b->objs, (size_t)c * sizeof(*o));
+        if (!o) return -1;
+        b->objs = o;
+        b->capobjs = c;
+    }
+    vidx_obj_t *o = &b->objs[b->nobjs];
+    o->path = dict_intern(&b->paths, path, NULL);
+    o->name = soname ? dict_intern(&b->names, soname, NULL) : VIDX_NONE;
+    o->versioned = vs->ndefs > 0;
+    if (o->path == VIDX_NONE || (soname && o->name == VIDX_NONE)) return -1;
+    uint32_t obj = b->nobjs++;
+
+    for (size_t i = 0; i < vs->nneeds; i++) {
+        vidx_row_t row = {
+            .obj = obj,
+            .lib = dict_intern(&b->names, vs->needs[i].file, NULL),
+            .ver = dict_intern(&b->vers, vs->needs[i].name, NULL),
+            .flags = vs->needs[i].flags & VER_FLG_WEAK,
+        };
+        if (row.lib == VIDX_NONE || row.ver == VIDX_NONE ||
+            push_row(&b->needs, &b->nneeds, &b->capneeds, row) < 0) {
+            return -1;
+        }
+    }
+    for (size_t i = 0; i < vs->ndefs; i++) {
+        if (vs->defs[i].flags & VER_FLG_BASE) continue;     /* the soname itself */
+        vidx_row_t row = {
+            .obj = obj,
+            .lib = o->name,
+            .ver = dict_intern(&b->vers, vs->defs[i].name, NULL),
+        };
+        if (row.ver == VIDX_NONE || push_row(&b->defs, &b->ndefs, &b->capdefs, row) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* fs_walk callback, runs on the worker threads: parse unlocked, add locked */
+static void index_file(const char *path, int fd, void *arg) {
+    builder_t *b = arg;
+    elf_view_t view;
+    elf_versions_t vs;
+
+    if (elf_view_open_fd(&view, fd, path) < 0) {
+        pthread_mutex_lock(&b->lock);
+        if (errno != ENOEXEC) b->stats.errors++;
+        pthread_mutex_unlock(&b->lock);
+        return;
+    }
+
+    /* Static binaries have no version tables and need nothing */
+    int parsed = view.pt_dynamic && elf_versions_load(&vs, &view) == 0;
+    pthread_mutex_lock(&b->lock);
+    b->stats.files++;
+    if (view.pt_dynamic && !parsed) b->oom = 1;
+    pthread_mutex_unlock(&b->lock);
+
+    if (parsed) {
+        /* ld.so matches DT_NEEDED against DT_SONAME, else the file name */
+        const char *soname = elf_view_has(&view, DT_SONAME) ?
+                             elf_view_dynstr(&view, elf_view_dyn(&view, DT_SONAME)) : NULL;
+
+        /* Tables read from the zero pages of a truncated file are not its own */
+        pthread_mutex_lock(&b->lock);
+        if (elf_view_truncated(&view)) b->stats.errors++;
+        else if (add_object(b, &view, &vs, path, soname) < 0) b->oom = 1;
+        pthread_mutex_unlock(&b->lock);
+        elf_versions_free(&vs);
+    }
+    elf_view_close(&view);
+}
+
+static void collect(builder_t *b, const version_index_opts_t *opts) {
+    const char **dirs = calloc(opts->nroots ? opts->nroots : 1, sizeof(*dirs));
+    int ndirs = 0;
+
+    /* Plain files are indexed as given; directories are walked for ELF files */
+    for (int i = 0; i < opts->nroots; i++) {
+        struct stat st;
+        if (stat(opts->roots[i], &st) < 0) {
+            b->stats.errors++;
+        } else if (S_ISDIR(st.st_mode)) {
+            if (dirs) dirs[ndirs++] = opts->roots[i];
+        } else {
+            int fd = open(opts->roots[i], O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                b->stats.errors++;
+                continue;
+            }
+            index_file(opts->roots[i], fd, b);
+            close(fd);
+        }
+    }
+
+    if (ndirs) {
+        fs_walk_opts_t wo = {
+            .roots = dirs,
+            .nroots = ndirs,
+            .nthreads = opts->nthreads,
+            .elf_only = 1,
+            .fn = index_file,
+            .arg = b,
+        };
+        fs_walk_stats_t ws;
+        fs_walk(&wo, &ws);
+        b->stats.errors += ws.errors;
+    }
+    free(dirs);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BUILD: ENCODE AND WRITE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static int cmp_path(const void *a, const void *b, void *arg) {
+    const builder_t *bld = arg;
+    const vidx_obj_t *x = &bld->objs[*(const uint32_t *)a];
+    const vidx_obj_t *y = &bld->objs[*(const uint32_t *)b];
+    return strcmp(bld->paths.by_id[x->path]->key, bld->paths.by_id[y->path]->key);
+}
+
+static int cmp_name(const void *a, const void *b, void *arg) {
+    const dict_t *d = arg;
+    return strcmp(d->by_id[*(const uint32_t *)a]->key, d->by_id[*(const uint32_t *)b]->key);
+}
+
+static int cmp_ver(const void *a, const void *b, void *arg) {
+    const dict_t *d = arg;
+    return version_cmp(d->by_id[*(const uint32_t *)a]->key, d->by_id[*(const uint32_t *)b]->key);
+}
+
+static int cmp_row(const void *a, const void *b) {
+    const vidx_row_t *x = a, *y = b;
+    if (x->lib != y->lib) return x->lib < y->lib ? -1 : 1;
+    if (x->ver != y->ver) return x->ver < y->ver ? -1 : 1;
+    return (x->obj > y->obj) - (x->obj < y->obj);
+}
+
+/* Sort a dictionary; rank[old id] = new id, order[new id] = old id */
+static int dict_order(const dict_t *d, int (*cmp)(const void *, const void *, void *),
+                      uint32_t **order, uint32_t **rank) {
+    *order = malloc((d->n ? d->n : 1) * sizeof(**order));
+    *rank = malloc((d->n ? d->n : 1) * sizeof(**rank));
+    if (!*order || !*rank) return -1;
+    for (uint32_t i = 0; i < d->n; i++) (*order)[i] = i;
+    qsort_r(*order, d->n, sizeof(**order), cmp, (void *)d);
+    for (uint32_t i = 0; i < d->n; i++) (*rank)[(*order)[i]] = i;
+    return 0;
+}
+
+/* Append s to the blob; its offset, or VIDX_NONE if the blob is full */
+static uint32_t blob_add(char *blob, uint64_t *len, const char *s) {
+    size_t n = strlen(s) + 1;
+    if (*len + n >= VIDX_NONE) return VIDX_NONE;
+    uint32_t off = *len;
+    memcpy(blob + off, s, n);
+    *len += n;
+    return off;
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* Objects without DT_SONAME are known by the file name of their final path */
+static int name_by_path(builder_t *b) {
+    for (uint32_t i = 0; i < b->nobjs; i++) {
+        vidx_obj_t *o = &b->objs[i];
+        if (o->name != VIDX_NONE) continue;
+        const char *path = b->paths.by_id[o->path]->key;
+        const char *slash = strrchr(path, '/');
+        o->name = dict_intern(&b->names, slash ? slash + 1 : path, NULL);
+        if (o->name == VIDX_NONE) return -1;
+    }
+    for (size_t i = 0; i < b->ndefs; i++) {
+        if (b->defs[i].lib == VIDX_NONE) b->defs[i].lib = b->objs[b->defs[i].obj].name;
+    }
+    return 0;
+}
+
+static int encode_and_write(builder_t *b, const char *file) {
+    vidx_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, VIDX_MAGIC, sizeof(h.magic));
+    h.version = VIDX_VERSION;
+    h.built = time(NULL);
+
+    if (b->nneeds >= VIDX_NONE || b->ndefs >= VIDX_NONE) {
+        errno = EFBIG;
+        return -1;
+    }
+    if (name_by_path(b) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    h.nobjs = b->nobjs;
+    h.nnames = b->names.n;
+    h.nvers = b->vers.n;
+    h.nneeds = b->nneeds;
+    h.ndefs = b->ndefs;
+
+    uint64_t blob_size = 0;
+    for (uint32_t i = 0; i < b->nobjs; i++) blob_size += strlen(b->paths.by_id[b->objs[i].path]->key) + 1;
+    for (uint32_t i = 0; i < b->names.n; i++) blob_size += strlen(b->names.by_id[i]->key) + 1;
+    for (uint32_t i = 0; i < b->vers.n; i++) blob_size += strlen(b->vers.by_id[i]->key) + 1;
+
+    size_t no = b->nobjs ? b->nobjs : 1, nn = h.nnames ? h.nnames : 1, nv = h.nvers ? h.nvers : 1;
+    size_t nr = b->nneeds ? b->nneeds : 1, nd = b->ndefs ? b->ndefs : 1;
+    uint32_t *name_order = NULL, *name_rank = NULL, *ver_order = NULL, *ver_rank = NULL;
+    uint32_t *obj_order = malloc(no * sizeof(*obj_order));
+    uint32_t *obj_rank = malloc(no * sizeof(*obj_rank));
+    uint32_t *obj_path = malloc(no * sizeof(*obj_path));
+    uint32_t *obj_name = malloc(no * sizeof(*obj_name));
+    uint32_t *name_off = malloc(nn * sizeof(*name_off));
+    uint8_t *name_flags = calloc(nn, sizeof(*name_flags));
+    uint32_t *ver_off = malloc(nv * sizeof(*ver_off));
+    uint32_t *need_obj = malloc(nr * sizeof(*need_obj));
+    uint32_t *need_lib = malloc(nr * sizeof(*need_lib));
+    uint32_t *need_ver = malloc(nr * sizeof(*need_ver));
+    uint8_t *need_flags = malloc(nr * sizeof(*need_flags));
+    uint32_t *def_obj = malloc(nd * sizeof(*def_obj));
+    uint32_t *def_lib = malloc(nd * sizeof(*def_lib));
+    uint32_t *def_ver = malloc(nd * sizeof(*def_ver));
+    char *blob = malloc(blob_size ? blob_size : 1);
+    int ret = -1;
+
+    if (!obj_order || !obj_rank || !obj_path || !obj_name || !name_off || !name_flags || !ver_off ||
+        !need_obj || !need_lib || !need_ver || !need_flags || !def_obj || !def_lib ||
+        !def_ver || !blob ||
+        dict_order(&b->names, cmp_name, &name_order, &name_rank) < 0 ||
+        dict_order(&b->vers, cmp_ver, &ver_order, &ver_rank) < 0) {
+        errno = ENOMEM;
+        goto out;
+    }
+
+    /* Objects by path: the walk order is lost, so the file is the same whatever the thread count */
+    for (uint32_t i = 0; i < b->nobjs; i++) obj_order[i] = i;
+    qsort_r(obj_order, b->nobjs, sizeof(*obj_order), cmp_path, b);
+    for (uint32_t i = 0; i < b->nobjs; i++) obj_rank[obj_order[i]] = i;
+
+    /* Strings: paths, then names and versions in dictionary order */
+    uint64_t len = 0;
+    int full = 0;
+    for (uint32_t i = 0; i < b->nobjs; i++) {
+        const vidx_obj_t *o = &b->objs[obj_order[i]];
+        obj_path[i] = blob_add(blob, &len, b->paths.by_id[o->path]->key);
+        obj_name[i] = name_rank[o->name];
+        name_flags[obj_name[i]] |= VIDX_PROVIDED | (o->versioned ? VIDX_VERSIONED : 0);
+        full |= obj_path[i] == VIDX_NONE;
+    }
+    for (uint32_t i = 0; i < h.nnames; i++) {
+        name_off[i] = blob_add(blob, &len, b->names.by_id[name_order[i]]->key);
+        full |= name_off[i] == VIDX_NONE;
+    }
+    for (uint32_t i = 0; i < h.nvers; i++) {
+        ver_off[i] = blob_add(blob, &len, b->vers.by_id[ver_order[i]]->key);
+        full |= ver_off[i] == VIDX_NONE;
+    }
+    if (full) {
+        errno = EFBIG;
+        goto out;
+    }
+
+    /* Rows: re-encode with the sorted ids, then sort by (lib, ver, obj) */
+    vidx_row_t *sets[2] = { b->needs, b->defs };
+    size_t counts[2] = { b->nneeds, b->ndefs };
+    for (int s = 0; s < 2; s++) {
+        for (size_t r = 0; r < counts[s]; r++) {
+            sets[s][r].obj = obj_rank[sets[s][r].obj];
+            sets[s][r].lib = name_rank[sets[s][r].lib];
+            sets[s][r].ver = ver_rank[sets[s][r].ver];
+        }
+        qsort(sets[s], counts[s], sizeof(vidx_row_t), cmp_row);
+    }
+    for (size_t r = 0; r < b->nneeds; r++) {
+        need_obj[r] = b->needs[r].obj;
+        need_lib[r] = b->needs[r].lib;
+        need_ver[r] = b->needs[r].ver;
+        need_flags[r] = b->needs[r].flags;
+    }
+    for (size_t r = 0; r < b->ndefs; r++) {
+        def_obj[r] = b->defs[r].obj;
+        def_lib[r] = b->defs[r].lib;
+        def_ver[r] = b->defs[r].ver;
+    }
+
+    /* Lay out the columns */
+    uint64_t pos = align8(sizeof(h));
+    h.obj_path_off = pos;   pos = align8(pos + (uint64_t)h.nobjs * sizeof(uint32_t));
+    h.obj_name_off = pos;   pos = align8(pos + (uint64_t)h.nobjs * sizeof(uint32_t));
+    h.name_off_off = pos;   pos = align8(pos + (uint64_t)h.nnames * sizeof(uint32_t));
+    h.name_flags_off = pos; pos = align8(pos + (uint64_t)h.nnames);
+    h.ver_off_off = pos;    pos = align8(pos + (uint64_t)h.nvers * sizeof(uint32_t));
+    h.need_obj_off = pos;   pos = align8(pos + (uint64_t)h.nneeds * sizeof(uint32_t));
+    h.need_lib_off = pos;   pos = align8(pos + (uint64_t)h.nneeds * sizeof(uint32_t));
+    h.need_ver_off = pos;   pos = align8(pos + (uint64_t)h.nneeds * sizeof(uint32_t));
+    h.need_flags_off = pos; pos = align8(pos + (uint64_t)h.nneeds);
+    h.def_obj_off = pos;    pos = align8(pos + (uint64_t)h.ndefs * sizeof(uint32_t));
+    h.def_lib_off = pos;    pos = align8(pos + (uint64_t)h.ndefs * sizeof(uint32_t));
+    h.def_ver_off = pos;    pos = align8(pos + (uint64_t)h.ndefs * sizeof(uint32_t));
+    h.strings_off = pos;
+    h.strings_size = len;
+
+    char tmp[4096];
+    int fd = -1;
+
+    /* mkostemp(): O_EXCL, so a planted file or symlink is never followed */
+    if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", file) >= (int)sizeof(tmp)) {
+        errno = ENAMETOOLONG;
+    } else {
+        fd = mkostemp(tmp, O_CLOEXEC);
+    }
+    if (fd >= 0) {
+        static const uint8_t zero[8];
+        struct {
+            uint64_t    at;
+            const void *data;
+            uint64_t    len;
+        } parts[] = {
+            { 0,                &h,         sizeof(h) },
+            { h.obj_path_off,   obj_path,   (uint64_t)h.nobjs * sizeof(uint32_t) },
+            { h.obj_name_off,   obj_name,   (uint64_t)h.nobjs * sizeof(uint32_t) },
+            { h.name_off_off,   name_off,   (uint64_t)h.nnames * sizeof(uint32_t) },
+            { h.name_flags_off, name_flags, h.nnames },
+            { h.ver_off_off,    ver_off,    (uint64_t)h.nvers * sizeof(uint32_t) },
+            { h.need_obj_off,   need_obj,   (uint64_t)h.nneeds * sizeof(uint32_t) },
+            { h.need_lib_off,   need_lib,   (uint64_t)h.nneeds * sizeof(uint32_t) },
+            { h.need_ver_off,   need_ver,   (uint64_t)h.nneeds * sizeof(uint32_t) },
+            { h.need_flags_off, need_flags, h.nneeds },
+            { h.def_obj_off,    def_obj,    (uint64_t)h.ndefs * sizeof(uint32_t) },
+            { h.def_lib_off,    def_lib,    (uint64_t)h.ndefs * sizeof(uint32_t) },
+            { h.def_ver_off,    def_ver,    (uint64_t)h.ndefs * sizeof(uint32_t) },
+            { h.strings_off,    blob,       len },
+        };
+
+        int ok = fchmod(fd, 0644) == 0;        /* readable by all, like the files it indexes */
+        uint64_t at = 0;
+        for (size_t i = 0; ok && i < sizeof(parts) / sizeof(parts[0]); i++) {
+            ok = write_all(fd, zero, parts[i].at - at) == 0 &&
+                 write_all(fd, parts[i].data, parts[i].len) == 0;
+            at = parts[i].at + parts[i].len;
+        }
+        if (ok && fsync(fd) != 0) ok = 0;
+        if (close(fd) != 0) ok = 0;
+        if (ok) ret = rename(tmp, file);
+        if (ret < 0) unlink(tmp);
+    }
+
+out:
+    free(name_order);
+    free(name_rank);
+    free(ver_order);
+    free(ver_rank);
+    free(obj_order);
+    free(obj_rank);
+    free(obj_path);
+    free(obj_name);
+    free(name_off);
+    free(name_flags);
+    free(ver_off);
+    free(need_obj);
+    free(need_lib);
+    free(need_ver);
+    free(need_flags);
+    free(def_obj);
+    free(def_lib);
+    free(def_ver);
+    free(blob);
+    return ret;
+}
+
+int version_index_build(const version_index_opts_t *opts, const char *file,
+                        version_index_stats_t *stats) {
+    builder_t b;
+    memset(&b, 0, sizeof(b));
+    pthread_mutex_init(&b.lock, NULL);
+
+    collect(&b, opts);
+
+    int ret = -1;
+    if (b.oom) {
+        errno = ENOMEM;
+    } else {
+        ret = encode_and_write(&b, file);
+    }
+
+    b.stats.objects = b.nobjs;
+    b.stats.needs = b.nneeds;
+    b.stats.defs = b.ndefs;
+    if (stats) *stats = b.stats;
+
+    int saved = errno;
+    dict_free(&b.inodes);
+    dict_free(&b.paths);
+    dict_free(&b.names);
+    dict_free(&b.vers);
+    free(b.objs);
+    free(b.needs);
+    free(b.defs);
+    pthread_mutex_destroy(&b.lock);
+    errno = saved;
+    return ret;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * OPEN
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static int section_ok(const version_index_t *idx, uint64_t off, uint64_t count, uint64_t size) {
+    return off <= idx->size && count <= (idx->size - off) / (size ? size : 1);
+}
+
+/* Every entry of col[n] is below limit */
+static int ids_ok(const uint32_t *col, uint64_t n, uint64_t limit) {
+    int bad = 0;
+    for (uint64_t i = 0; i < n; i++) bad |= col[i] >= limit;
+    return !bad;
+}
+
+int version_index_open(version_index_t *idx, const char *file) {
+    memset(idx, 0, sizeof(*idx));
+
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(vidx_header_t)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    idx->map = map;
+    idx->size = st.st_size;
+
+    const vidx_header_t *h = map;
+    if (memcmp(h->magic, VIDX_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != VIDX_VERSION ||
+        !section_ok(idx, h->obj_path_off, h->nobjs, sizeof(uint32_t)) ||
+        !section_ok(idx, h->obj_name_off, h->nobjs, sizeof(uint32_t)) ||
+        !section_ok(idx, h->name_off_off, h->nnames, sizeof(uint32_t)) ||
+        !section_ok(idx, h->name_flags_off, h->nnames, 1) ||
+        !section_ok(idx, h->ver_off_off, h->nvers, sizeof(uint32_t)) ||
+        !section_ok(idx, h->need_obj_off, h->nneeds, sizeof(uint32_t)) ||
+        !section_ok(idx, h->need_lib_off, h->nneeds, sizeof(uint32_t)) ||
+        !section_ok(idx, h->need_ver_off, h->nneeds, sizeof(uint32_t)) ||
+        !section_ok(idx, h->need_flags_off, h->nneeds, 1) ||
+        !section_ok(idx, h->def_obj_off, h->ndefs, sizeof(uint32_t)) ||
+        !section_ok(idx, h->def_lib_off, h->ndefs, sizeof(uint32_t)) ||
+        !section_ok(idx, h->def_ver_off, h->ndefs, sizeof(uint32_t)) ||
+        !section_ok(idx, h->strings_off, h->strings_size, 1) ||
+        (h->strings_size && idx->map[h->strings_off + h->strings_size - 1] != '\0')) {
+        version_index_close(idx);
+        errno = EINVAL;
+        return -1;
+    }
+
+    idx->nobjs = h->nobjs;
+    idx->nnames = h->nnames;
+    idx->nvers = h->nvers;
+    idx->nneeds = h->nneeds;
+    idx->ndefs = h->ndefs;
+    idx->built = h->built;
+    idx->obj_path = (const void *)(idx->map + h->obj_path_off);
+    idx->obj_name = (const void *)(idx->map + h->obj_name_off);
+    idx->name_off = (const void *)(idx->map + h->name_off_off);
+    idx->name_flags = idx->map + h->name_flags_off;
+    idx->ver_off = (const void *)(idx->map + h->ver_off_off);
+    idx->need_obj = (const void *)(idx->map + h->need_obj_off);
+    idx->need_lib = (const void *)(idx->map + h->need_lib_off);
+    idx->need_ver = (const void *)(idx->map + h->need_ver_off);
+    idx->need_flags = idx->map + h->need_flags_off;
+    idx->def_obj = (const void *)(idx->map + h->def_obj_off);
+    idx->def_lib = (const void *)(idx->map + h->def_lib_off);
+    idx->def_ver = (const void *)(idx->map + h->def_ver_off);
+    idx->strings = (const char *)idx->map + h->strings_off;
+    idx->strings_size = h->strings_size;
+
+    /* Ids and offsets are trusted by the queries, so check them all once */
+    if (!ids_ok(idx->obj_path, idx->nobjs, idx->strings_size) ||
+        !ids_ok(idx->obj_name, idx->nobjs, idx->nnames) ||
+        !ids_ok(idx->name_off, idx->nnames, idx->strings_size) ||
+        !ids_ok(idx->ver_off, idx->nvers, idx->strings_size) ||
+        !ids_ok(idx->need_obj, idx->nneeds, idx->nobjs) ||
+        !ids_ok(idx->need_lib, idx->nneeds, idx->nnames) ||
+        !ids_ok(idx->need_ver, idx->nneeds, idx->nvers) ||
+        !ids_ok(idx->def_obj, idx->ndefs, idx->nobjs) ||
+        !ids_ok(idx->def_lib, idx->ndefs, idx->nnames) ||
+        !ids_ok(idx->def_ver, idx->ndefs, idx->nvers)) {
+        version_index_close(idx);
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+void version_index_close(version_index_t *idx) {
+    if (idx->map) munmap((void *)idx->map, idx->size);
+    memset(idx, 0, sizeof(*idx));
+}
+
+const char *version_index_path(const version_index_t *idx, uint32_t obj) {
+    return idx->strings + idx->obj_path[obj];
+}
+
+const char *version_index_name(const version_index_t *idx, uint32_t name) {
+    return idx->strings + idx->name_off[name];
+}
+
+const char *version_index_version(const version_index_t *idx, uint32_t ver) {
+    return idx->strings + idx->ver_off[ver];
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * QUERIES
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+uint32_t version_index_requires(const version_index_t *idx, const char *version,
+                                uint32_t *best) {
+    size_t flen = family_len(version);
+
+    /* [lo, hi): dictionary ids of version and every newer one of its family */
+    uint32_t lo = 0, hi = idx->nvers;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (version_cmp(version_index_version(idx, mid), version) < 0) lo = mid + 1; else hi = mid;
+    }
+    hi = idx->nvers;
+    for (uint32_t l = lo; l < hi; ) {
+        uint32_t mid = l + (hi - l) / 2;
+        const char *v = version_index_version(idx, mid);
+        if (family_cmp(v, family_len(v), version, flen) <= 0) l = mid + 1; else hi = mid;
+    }
+
+    /* One pass over the version column: an integer range test per row */
+    uint32_t matched = 0;
+    for (uint32_t o = 0; o < idx->nobjs; o++) best[o] = VIDX_NONE;
+    for (uint32_t r = 0; r < idx->nneeds; r++) {
+        uint32_t v = idx->need_ver[r];
+        if (v - lo >= hi - lo) continue;
+        uint32_t *b = &best[idx->need_obj[r]];
+        if (*b == VIDX_NONE) matched++;
+        if (*b == VIDX_NONE || v > idx->need_ver[*b]) *b = r;
+    }
+    return matched;
+}
+
+int version_index_unsatisfied(const version_index_t *idx, uint32_t **rows,
+                              size_t *nrows, size_t *unindexed) {
+    size_t n = 0, cap = 0;
+    uint32_t *out = NULL;
+
+    *unindexed = 0;
+
+    /* Sorted-merge anti-join: both sides are ordered by (lib, ver) */
+    uint32_t d = 0;
+    for (uint32_t r = 0; r < idx->nneeds; r++) {
+        uint32_t lib = idx->need_lib[r], ver = idx->need_ver[r];
+        while (d < idx->ndefs &&
+               (idx->def_lib[d] < lib || (idx->def_lib[d] == lib && idx->def_ver[d] < ver))) {
+            d++;
+        }
+        if (d < idx->ndefs && idx->def_lib[d] == lib && idx->def_ver[d] == ver) continue;
+
+        if (!(idx->name_flags[lib] & VIDX_PROVIDED)) {
+            (*unindexed)++;
+            continue;
+        }
+        if (!(idx->name_flags[lib] & VIDX_VERSIONED)) continue;
+
+        if (n >= cap) {
+            size_t c = cap ? cap * 2 : 256;
+            uint32_t *grown = realloc(out, c * sizeof(*grown));
+            if (!grown) {
+                free(out);
+                errno = ENOMEM;
+                return -1;
+            }
+            out = grown;
+            cap = c;
+        }
+        out[n++] = r;
+    }
+
+    *rows = out;
+    *nrows = n;
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * version_index.h - Fleet-wide symbol version index (column store)
+ *
+ * Answers "which binaries require GLIBC_2.34 or newer?" and "which
+ * binaries need a version their library does not define?" for a whole
+ * tree without rescanning it. One parallel walk (../common/fs_walk.h)
+ * parses every ELF object's version tables (../common/elf_version.h)
+ * into two relations:
+ *
+ *   need(object, library, version, flags)   from .gnu.version_r
+ *   def(object, library, version)           from .gnu.version_d
+ *
+ * where library is the DT_NEEDED name on the need side and the
+ * provider's DT_SONAME (else its file name) on the def side. Both are
+ * saved column by column to a file that is mmap'ed read-only for
+ * queries:
+ *
+ *   ┌────────────────────┐
+ *   │ header             │  magic, version, counts, section offsets
+ *   ├────────────────────┤
+ *   │ obj_path[nobjs]    │  objects, sorted by path
+ *   │ obj_name[nobjs]    │  name id of the object's soname
+ *   │ name_off[nnames]   │  name dictionary (sonames), sorted by strcmp
+ *   │ name_flags[nnames] │  VIDX_PROVIDED / VIDX_VERSIONED
+ *   │ ver_off[nvers]     │  version dictionary, sorted in version order
+ *   │ need_obj/lib/ver   │  need rows, sorted by (lib, ver, obj)
+ *   │ need_flags         │
+ *   │ def_obj/lib/ver    │  def rows, sorted by (lib, ver, obj)
+ *   ├────────────────────┤
+ *   │ string blob        │
+ *   └────────────────────┘
+ *
+ * Every string is dictionary encoded, and the version dictionary is
+ * order preserving: GLIBC_2.2.5 < GLIBC_2.14 < GLIBC_2.34 compare as
+ * their ids do, and one family (same name before the number) is one
+ * contiguous id range. "GLIBC_2.34 or newer" is therefore an integer
+ * range test over one uint32 column, and since both relations share
+ * their sort order, "needed but not defined" is a single sorted-merge
+ * anti-join.
+ *
+ * The index is a snapshot: rebuild it after packages change.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef VERSION_INDEX_H
+#define VERSION_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define VIDX_NONE       0xffffffffu     /* id / row: not present */
+
+/* name_flags */
+#define VIDX_PROVIDED   0x01    /* some indexed object carries this soname */
+#define VIDX_VERSIONED  0x02    /* ... and one of them has a .gnu.version_d */
+
+typedef struct {
+    const char **roots;         /* files or directory trees */
+    int          nroots;
+    int          nthreads;      /* <= 0: one per online CPU */
+} version_index_opts_t;
+
+typedef struct {
+    unsigned long files;        /* ELF files parsed */
+    unsigned long objects;      /* distinct dynamic objects indexed */
+    unsigned long needs;
+    unsigned long defs;
+    unsigned long errors;       /* unreadable files and directories */
+} version_index_stats_t;
+
+typedef struct {
+    const uint8_t  *map;
+    size_t          size;
+
+    uint32_t        nobjs;
+    uint32_t        nnames;
+    uint32_t        nvers;
+    uint32_t        nneeds;
+    uint32_t        ndefs;
+    int64_t         built;      /* time() of the build */
+
+    const uint32_t *obj_path;   /* string offsets */
+    const uint32_t *obj_name;
+    const uint32_t *name_off;
+    const uint8_t  *name_flags;
+    const uint32_t *ver_off;
+    const uint32_t *need_obj;
+    const uint32_t *need_lib;
+    const uint32_t *need_ver;
+    const uint8_t  *need_flags; /* VER_FLG_WEAK */
+    const uint32_t *def_obj;
+    const uint32_t *def_lib;
+    const uint32_t *def_ver;
+    const char     *strings;
+    uint64_t        strings_size;
+} version_index_t;
+
+/* Walk opts->roots and write the index to file (tmp file + rename) */
+int version_index_build(const version_index_opts_t *opts, const char *file,
+                        version_index_stats_t *stats);
+
+int version_index_open(version_index_t *idx, const char *file);
+void version_index_close(version_index_t *idx);
+
+const char *version_index_path(const version_index_t *idx, uint32_t obj);
+const char *version_index_name(const version_index_t *idx, uint32_t name);
+const char *version_index_version(const version_index_t *idx, uint32_t ver);
+
+/*
+ * Objects that need version or a newer one of the same family (the
+ * part before the number: "GLIBC_" for GLIBC_2.34). best[obj] receives
+ * the need row with the newest such version, or VIDX_NONE; best has
+ * idx->nobjs entries. Returns the number of objects matched.
+ */
+uint32_t version_index_requires(const version_index_t *idx, const char *version,
+                                uint32_t *best);
+
+/*
+ * Need rows whose library is indexed and versioned, but no object with
+ * that soname defines the version: ld.so refuses to start these (or, for
+ * VER_FLG_WEAK rows, warns). Rows come back in (lib, ver, obj) order in
+ * a malloc'ed array. Needs from libraries that are not in the index at
+ * all are only counted in *unindexed; needs from unversioned libraries
+ * are skipped, as ld.so accepts those. Returns 0, or -1 on ENOMEM.
+ */
+int version_index_unsatisfied(const version_index_t *idx, uint32_t **rows,
+                              size_t *nrows, size_t *unindexed);
+
+/* Version order: family by strcmp, then dotted numbers numerically */
+int version_cmp(const char *a, const char *b);
+
+#endif /* VERSION_INDEX_H */
@@ -0,0 +1,207 @@
+/*
+ * core_embed.c - Embed the rpath_scanner core the way a host agent would
+ *
+ * Exercises rpath_core.h from a program of its own: one shared core, a
+ * caller-supplied allocator, a pool of threads analyzing files at once,
+ * and a new epoch (rpath_core_reset()) between rounds. Every round must
+ * give the same answers as a single-threaded pass, every result block
+ * must come back to the allocator, and the core's tables must start
+ * each round empty. Meant to be run under ASan and TSan (make embed-check).
+ *
+ * Usage: core_embed [-t threads] [-r rounds] [-n max_files] <file|dir>...
+ *
+ * Prints one summary line and exits 0, or 1 on the first mismatch.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "rpath_core.h"
+
+/* Counting allocator: what an agent would plug in to account for memory */
+typedef struct {
+    long live;
+    long total;
+} count_alloc_t;
+
+static void *count_alloc(void *ctx, size_t size) {
+    count_alloc_t *c = ctx;
+    void *p = malloc(size);
+    if (p) {
+        __atomic_fetch_add(&c->live, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&c->total, 1, __ATOMIC_RELAXED);
+    }
+    return p;
+}
+
+static void count_free(void *ctx, void *p) {
+    count_alloc_t *c = ctx;
+    __atomic_fetch_sub(&c->live, 1, __ATOMIC_RELAXED);
+    free(p);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * FILES
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static char **files;
+static size_t nfiles, max_files = 20000;
+
+static int collect(const char *path, const struct stat *st, int type, struct FTW *ftw) {
+    (void)ftw;
+    if (type != FTW_F || !S_ISREG(st->st_mode)) return 0;
+    if (nfiles == max_files) return 1;
+    if (!(files[nfiles] = strdup(path))) return -1;
+    nfiles++;
+    return 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * ANSWERS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Everything a result says, folded into one value */
+static uint64_t fold(uint64_t h, const char *s) {
+    for (; s && *s; s++) h = (h ^ (unsigned char)*s) * 0x100000001b3ULL;
+    return (h ^ 0xff) * 0x100000001b3ULL;
+}
+
+static uint64_t answer(int rc, const rpath_result_t *res) {
+    if (rc < 0) return 0;
+    uint64_t h = 0xcbf29ce484222325ULL ^ (uint64_t)res->verdict;
+    h = fold(fold(h, res->rpath), res->runpath);
+    for (uint32_t i = 0; i < res->needed_count; i++) {
+        h = fold(h, res->needed[i]);
+        if (res->resolved) h = fold(h, res->resolved[i].path) ^ (uint64_t)res->resolved[i].source;
+    }
+    for (uint32_t i = 0; i < res->dir_count; i++) {
+        h = fold(h, res->dirs[i].dir) ^ (uint64_t)res->dirs[i].vulns;
+    }
+    return h | 1;
+}
+
+typedef struct {
+    rpath_core_t     *core;
+    rpath_result_t  **results;      /* held until the round ends */
+    uint64_t         *answers;
+    size_t            next;
+} round_t;
+
+static void *worker(void *arg) {
+    round_t *r = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&r->next, 1, __ATOMIC_RELAXED);
+        if (i >= nfiles) break;
+        int rc = rpath_analyze(r->core, files[i], &r->results[i]);
+        r->answers[i] = answer(rc, r->results[i]);
+    }
+    return NULL;
+}
+
+static void run_round(round_t *r, int nthreads) {
+    pthread_t tids[64];
+    int started = 0;
+
+    r->next = 0;
+    for (int t = 0; t < nthreads; t++) {
+        if (pthread_create(&tids[started], NULL, worker, r) == 0) started++;
+    }
+    if (!started) worker(r);
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+}
+
+int main(int argc, char *argv[]) {
+    int nthreads = 8, rounds = 3, opt;
+
+    while ((opt = getopt(argc, argv, "t:r:n:")) != -1) {
+        if (opt == 't') nthreads = atoi(optarg);
+        else if (opt == 'r') rounds = atoi(optarg);
+        else if (opt == 'n') max_files = strtoul(optarg, NULL, 10);
+        else return 2;
+    }
+    if (optind == argc || nthreads < 1 || nthreads > 64 || rounds < 1 || !max_files) {
+        fprintf(stderr, "Usage: %s [-t threads] [-r rounds] [-n max_files] <file|dir>...\n", argv[0]);
+        return 2;
+    }
+
+    files = calloc(max_files, sizeof(*files));
+    if (!files) return 1;
+    for (int i = optind; i < argc; i++) {
+        if (nftw(argv[i], collect, 64, FTW_PHYS) < 0) {
+            fprintf(stderr, "core_embed: %s: %s\n", argv[i], strerror(errno));
+            return 1;
+        }
+    }
+
+    count_alloc_t counts = {0};
+    rpath_alloc_t alloc = { count_alloc, count_free, &counts };
+    rpath_core_opts_t opts = { .uid = getuid(), .resolve = 1, .alloc = &alloc };
+    rpath_core_t core;
+    if (rpath_core_init(&core, &opts) < 0) {
+        fprintf(stderr, "core_embed: rpath_core_init: %s\n", strerror(errno));
+        return 1;
+    }
+
+    uint64_t *expect = calloc(nfiles ? nfiles : 1, sizeof(*expect));
+    round_t r = {
+        .core = &core,
+        .results = calloc(nfiles ? nfiles : 1, sizeof(*r.results)),
+        .answers = calloc(nfiles ? nfiles : 1, sizeof(*r.answers)),
+    };
+    if (!expect || !r.results || !r.answers) return 1;
+
+    /* Round 0 is the single-threaded reference; the rest run in parallel */
+    int bad = 0;
+    size_t elf = 0;
+    for (int round = 0; round <= rounds && !bad; round++) {
+        run_round(&r, round ? nthreads : 1);
+
+        for (size_t i = 0; i < nfiles; i++) {
+            if (round == 0) {
+                expect[i] = r.answers[i];
+                elf += expect[i] != 0;
+            } else if (r.answers[i] != expect[i]) {
+                fprintf(stderr, "core_embed: round %d: %s differs\n", round, files[i]);
+                bad = 1;
+            }
+            rpath_result_free(&core, r.results[i]);
+            r.results[i] = NULL;
+        }
+
+        long live = __atomic_load_n(&counts.live, __ATOMIC_RELAXED);
+        if (live != 0) {
+            fprintf(stderr, "core_embed: round %d: %ld results not freed\n", round, live);
+            bad = 1;
+        }
+
+        if (rpath_core_reset(&core) < 0) {
+            fprintf(stderr, "core_embed: rpath_core_reset: %s\n", strerror(errno));
+            bad = 1;
+        } else if (dir_cache_size(&core.dirs) != 0 || core.strs.unique != 0 ||
+                   core.ldso.memo_hits + core.ldso.memo_misses != 0) {
+            fprintf(stderr, "core_embed: round %d: tables not empty after reset\n", round);
+            bad = 1;
+        }
+    }
+
+    printf("core_embed: %zu files (%zu analyzed), %d rounds x %d threads, %ld results: %s\n",
+           nfiles, elf, rounds, nthreads, counts.total, bad ? "FAIL" : "OK");
+
+    rpath_core_destroy(&core);
+    for (size_t i = 0; i < nfiles; i++) free(files[i]);
+    free(files);
+    free(expect);
+    free(r.results);
+    free(r.answers);
+    return bad;
+}
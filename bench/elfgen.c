@@ -0,0 +1,558 @@
+/*
+ * elfgen.c - Synthetic ELF corpus generator for the scanner benchmarks
+ *
+ * Writes a reproducible tree of ELF64 x86-64 executables and shared
+ * objects that the scanners can parse but that are never meant to run:
+ *
+ *   <out>/bin/progNNNNN            ET_EXEC, PT_INTERP, NEEDED/RPATH/RUNPATH
+ *   <out>/lib/libbenchNNNN.so.1    ET_DYN with SONAME, exports, NEEDED
+ *   <out>/opt/vendorN/lib/...      libraries only reachable through RPATH
+ *   <out>/writable                 mode 0777, referenced by some RPATHs
+ *
+ * Every file has the usual loader-facing pieces (.dynamic, .dynstr,
+ * .dynsym, .hash, .rela.plt, .got, .got.plt, section headers), with the
+ * knobs the scanners' costs depend on varied per file:
+ *
+ *   DT_NEEDED count     1-13 per executable, 0-4 per library (+ libc.so.6)
+ *   RPATH/RUNPATH       none, short, or many (long) components
+ *   relocations         0-~500 JUMP_SLOT imports
+ *   file size           padding from nothing up to ~256 KiB
+ *
+ * The same seed and counts always produce byte-identical files.
+ *
+ * Usage: elfgen -o DIR [-n executables] [-l libraries] [-s seed]
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <elf.h>
+#include <sys/stat.h>
+
+#define EXEC_BASE       0x400000
+#define NVENDORS        8
+#define MAX_NEEDED      16
+#define INTERP          "/lib64/ld-linux-x86-64.so.2"
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * DETERMINISTIC RANDOMNESS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static uint64_t rng_state;
+
+static uint64_t rng(void) {
+    /* xorshift64* */
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545f4914f6cdd1dULL;
+}
+
+static uint32_t rnd(uint32_t n) {
+    return n ? (uint32_t)(rng() % n) : 0;
+}
+
+/* Roughly log-uniform in [0, max): many small values, a few large ones */
+static uint32_t rnd_log(uint32_t max) {
+    uint32_t bits = 0;
+    while ((1u << bits) < max) bits++;
+    uint32_t v = (uint32_t)(rng() & ((1ULL << rnd(bits + 1)) - 1));
+    return v < max ? v : max - 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BYTE BUFFERS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    uint8_t *data;
+    size_t   len;
+    size_t   cap;
+} buf_t;
+
+static void buf_reserve(buf_t *b, size_t n) {
+    if (b->len + n <= b->cap) return;
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < b->len + n) cap *= 2;
+    b->data = realloc(b->data, cap);
+    if (!b->data) {
+        perror("realloc");
+        exit(1);
+    }
+    b->cap = cap;
+}
+
+static size_t buf_put(buf_t *b, const void *p, size_t n) {
+    buf_reserve(b, n);
+    size_t off = b->len;
+    if (p) memcpy(b->data + off, p, n);
+    else memset(b->data + off, 0, n);
+    b->len += n;
+    return off;
+}
+
+static void buf_align(buf_t *b, size_t a) {
+    while (b->len % a) buf_put(b, "", 1);
+}
+
+static uint32_t str_add(buf_t *strtab, const char *s) {
+    return (uint32_t)buf_put(strtab, s, strlen(s) + 1);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * OBJECT DESCRIPTION
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    int         is_lib;
+    const char *soname;                 /* libs only */
+    const char *needed[MAX_NEEDED + 1];
+    int         nneeded;
+    char        rpath[4096];            /* "" = none */
+    int         runpath;                /* emit as DT_RUNPATH instead of DT_RPATH */
+    int         nimports;
+    int         nexports;
+    int         relro;
+    int         bind_now;
+    uint32_t    padding;
+    uint32_t    id;
+} object_t;
+
+static uint32_t sysv_hash(const char *name) {
+    uint32_t h = 0, g;
+    while (*name) {
+        h = (h << 4) + (unsigned char)*name++;
+        g = h & 0xf0000000;
+        if (g) h ^= g >> 24;
+        h &= ~g;
+    }
+    return h;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * ELF WRITER
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+enum {
+    S_NULL, S_INTERP, S_DYNSYM, S_DYNSTR, S_HASH, S_RELAPLT, S_TEXT,
+    S_GOT, S_GOTPLT, S_DYNAMIC, S_PAD, S_SHSTRTAB, S_COUNT
+};
+
+static int write_object(const object_t *o, const char *path) {
+    buf_t f = {0}, dynstr = {0}, shstr = {0};
+    uint64_t base = o->is_lib ? 0 : EXEC_BASE;
+    Elf64_Shdr sh[S_COUNT];
+    uint32_t names[S_COUNT];
+    char sym[64];
+
+    memset(sh, 0, sizeof(sh));
+
+    static const char *const secnames[S_COUNT] = {
+        "", ".interp", ".dynsym", ".dynstr", ".hash", ".rela.plt", ".text",
+        ".got", ".got.plt", ".dynamic", ".comment", ".shstrtab"
+    };
+    for (int i = 0; i < S_COUNT; i++) names[i] = str_add(&shstr, secnames[i]);
+
+    /* String table and symbols */
+    buf_put(&dynstr, "", 1);
+    uint32_t needed_off[MAX_NEEDED + 1];
+    for (int i = 0; i < o->nneeded; i++) needed_off[i] = str_add(&dynstr, o->needed[i]);
+    uint32_t soname_off = o->soname ? str_add(&dynstr, o->soname) : 0;
+    uint32_t rpath_off = o->rpath[0] ? str_add(&dynstr, o->rpath) : 0;
+
+    int nsym = 1 + o->nimports + o->nexports;
+    Elf64_Sym *syms = calloc(nsym, sizeof(*syms));
+    char **symnames = calloc(nsym, sizeof(*symnames));
+    for (int i = 0; i < o->nimports; i++) {
+        snprintf(sym, sizeof(sym), "bench_fn_%u", (unsigned)rnd(4096));
+        syms[1 + i].st_name = str_add(&dynstr, sym);
+        syms[1 + i].st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+        symnames[1 + i] = strdup(sym);
+    }
+    for (int i = 0; i < o->nexports; i++) {
+        snprintf(sym, sizeof(sym), "bench_fn_%u", (unsigned)((o->id * 131 + i) % 4096));
+        syms[1 + o->nimports + i].st_name = str_add(&dynstr, sym);
+        syms[1 + o->nimports + i].st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+        syms[1 + o->nimports + i].st_shndx = S_TEXT;
+        syms[1 + o->nimports + i].st_size = 1;
+        symnames[1 + o->nimports + i] = strdup(sym);
+    }
+
+    /* SysV hash table */
+    uint32_t nbucket = nsym / 2 + 1;
+    uint32_t *hash = calloc(2 + nbucket + nsym, sizeof(uint32_t));
+    hash[0] = nbucket;
+    hash[1] = nsym;
+    for (int i = nsym - 1; i >= 1; i--) {
+        uint32_t b = sysv_hash(symnames[i]) % nbucket;
+        hash[2 + nbucket + i] = hash[2 + b];
+        hash[2 + b] = i;
+    }
+
+    /* Lay out the file: headers first, sections after */
+    int nphdr = o->is_lib ? 4 : 5;
+    buf_put(&f, NULL, sizeof(Elf64_Ehdr) + nphdr * sizeof(Elf64_Phdr));
+
+    if (!o->is_lib) {
+        sh[S_INTERP].sh_offset = buf_put(&f, INTERP, sizeof(INTERP));
+        sh[S_INTERP].sh_size = sizeof(INTERP);
+    }
+
+    buf_align(&f, 8);
+    sh[S_DYNSYM].sh_offset = f.len;
+    sh[S_DYNSYM].sh_size = nsym * sizeof(Elf64_Sym);
+    size_t dynsym_at = buf_put(&f, NULL, sh[S_DYNSYM].sh_size);
+
+    sh[S_DYNSTR].sh_offset = buf_put(&f, dynstr.data, dynstr.len);
+    sh[S_DYNSTR].sh_size = dynstr.len;
+
+    buf_align(&f, 8);
+    sh[S_HASH].sh_size = (2 + nbucket + nsym) * sizeof(uint32_t);
+    sh[S_HASH].sh_offset = buf_put(&f, hash, sh[S_HASH].sh_size);
+
+    buf_align(&f, 8);
+    sh[S_RELAPLT].sh_size = o->nimports * sizeof(Elf64_Rela);
+    size_t rela_at = sh[S_RELAPLT].sh_offset = buf_put(&f, NULL, sh[S_RELAPLT].sh_size);
+
+    buf_align(&f, 16);
+    sh[S_TEXT].sh_size = 16 * (o->nimports + 1) + o->nexports;
+    sh[S_TEXT].sh_offset = buf_put(&f, NULL, sh[S_TEXT].sh_size);
+    memset(f.data + sh[S_TEXT].sh_offset, 0xc3, sh[S_TEXT].sh_size);     /* ret */
+
+    /* RELRO covers .got and .dynamic; .got.plt follows unless BIND_NOW */
+    buf_align(&f, 8);
+    sh[S_GOT].sh_size = 4 * 8;
+    sh[S_GOT].sh_offset = buf_put(&f, NULL, sh[S_GOT].sh_size);
+
+    int ndyn = o->nneeded + 16;
+    sh[S_DYNAMIC].sh_size = ndyn * sizeof(Elf64_Dyn);
+    size_t dyn_at = sh[S_DYNAMIC].sh_offset = buf_put(&f, NULL, sh[S_DYNAMIC].sh_size);
+
+    sh[S_GOTPLT].sh_size = (3 + o->nimports) * 8;
+    size_t gotplt_at = sh[S_GOTPLT].sh_offset = buf_put(&f, NULL, sh[S_GOTPLT].sh_size);
+
+    sh[S_PAD].sh_size = o->padding;
+    sh[S_PAD].sh_offset = buf_put(&f, NULL, o->padding);
+
+    sh[S_SHSTRTAB].sh_offset = buf_put(&f, shstr.data, shstr.len);
+    sh[S_SHSTRTAB].sh_size = shstr.len;
+
+    buf_align(&f, 8);
+    size_t shoff = buf_put(&f, NULL, sizeof(sh));
+    size_t file_size = f.len;
+
+    /* Addresses: one PT_LOAD maps the whole file at base */
+    for (int i = 1; i < S_COUNT; i++) {
+        if (i != S_PAD && i != S_SHSTRTAB) sh[i].sh_addr = base + sh[i].sh_offset;
+    }
+
+    /* Symbols (exports live in .text) and PLT relocations */
+    Elf64_Sym *dsym = (Elf64_Sym *)(f.data + dynsym_at);
+    memcpy(dsym, syms, nsym * sizeof(Elf64_Sym));
+    for (int i = 0; i < o->nexports; i++) {
+        dsym[1 + o->nimports + i].st_value = sh[S_TEXT].sh_addr + 16 * (o->nimports + 1) + i;
+    }
+
+    Elf64_Rela *rela = (Elf64_Rela *)(f.data + rela_at);
+    uint64_t *gotplt = (uint64_t *)(f.data + gotplt_at);
+    gotplt[0] = sh[S_DYNAMIC].sh_addr;
+    for (int i = 0; i < o->nimports; i++) {
+        rela[i].r_offset = sh[S_GOTPLT].sh_addr + (3 + i) * 8;
+        rela[i].r_info = ELF64_R_INFO(1 + i, R_X86_64_JUMP_SLOT);
+        gotplt[3 + i] = sh[S_TEXT].sh_addr + 16 * (i + 1) + 6;
+    }
+
+    /* Dynamic section */
+    Elf64_Dyn *dyn = (Elf64_Dyn *)(f.data + dyn_at);
+    int nd = 0;
+    for (int i = 0; i < o->nneeded; i++) dyn[nd++] = (Elf64_Dyn){ DT_NEEDED, { needed_off[i] } };
+    if (o->soname) dyn[nd++] = (Elf64_Dyn){ DT_SONAME, { soname_off } };
+    if (o->rpath[0]) dyn[nd++] = (Elf64_Dyn){ o->runpath ? DT_RUNPATH : DT_RPATH, { rpath_off } };
+    dyn[nd++] = (Elf64_Dyn){ DT_HASH,     { sh[S_HASH].sh_addr } };
+    dyn[nd++] = (Elf64_Dyn){ DT_STRTAB,   { sh[S_DYNSTR].sh_addr } };
+    dyn[nd++] = (Elf64_Dyn){ DT_SYMTAB,   { sh[S_DYNSYM].sh_addr } };
+    dyn[nd++] = (Elf64_Dyn){ DT_STRSZ,    { sh[S_DYNSTR].sh_size } };
+    dyn[nd++] = (Elf64_Dyn){ DT_SYMENT,   { sizeof(Elf64_Sym) } };
+    dyn[nd++] = (Elf64_Dyn){ DT_PLTGOT,   { sh[S_GOTPLT].sh_addr } };
+    if (o->nimports) {
+        dyn[nd++] = (Elf64_Dyn){ DT_PLTRELSZ, { sh[S_RELAPLT].sh_size } };
+        dyn[nd++] = (Elf64_Dyn){ DT_PLTREL,   { DT_RELA } };
+        dyn[nd++] = (Elf64_Dyn){ DT_JMPREL,   { sh[S_RELAPLT].sh_addr } };
+    }
+    if (o->bind_now) {
+        dyn[nd++] = (Elf64_Dyn){ DT_FLAGS,   { DF_BIND_NOW } };
+        dyn[nd++] = (Elf64_Dyn){ DT_FLAGS_1, { DF_1_NOW } };
+    }
+    dyn[nd++] = (Elf64_Dyn){ DT_NULL, { 0 } };
+
+    /* Section headers */
+    static const struct { uint32_t type; uint64_t flags; uint64_t entsize; } kinds[S_COUNT] = {
+        [S_INTERP]   = { SHT_PROGBITS, SHF_ALLOC, 0 },
+        [S_DYNSYM]   = { SHT_DYNSYM,   SHF_ALLOC, sizeof(Elf64_Sym) },
+        [S_DYNSTR]   = { SHT_STRTAB,   SHF_ALLOC, 0 },
+        [S_HASH]     = { SHT_HASH,     SHF_ALLOC, 4 },
+        [S_RELAPLT]  = { SHT_RELA,     SHF_ALLOC | SHF_INFO_LINK, sizeof(Elf64_Rela) },
+        [S_TEXT]     = { SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0 },
+        [S_GOT]      = { SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 8 },
+        [S_GOTPLT]   = { SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 8 },
+        [S_DYNAMIC]  = { SHT_DYNAMIC,  SHF_ALLOC | SHF_WRITE, sizeof(Elf64_Dyn) },
+        [S_PAD]      = { SHT_PROGBITS, 0, 1 },
+        [S_SHSTRTAB] = { SHT_STRTAB,   0, 0 },
+    };
+    for (int i = 1; i < S_COUNT; i++) {
+        sh[i].sh_name = names[i];
+        sh[i].sh_type = kinds[i].type;
+        sh[i].sh_flags = kinds[i].flags;
+        sh[i].sh_entsize = kinds[i].entsize;
+        sh[i].sh_addralign = 8;
+    }
+    if (o->is_lib) sh[S_INTERP].sh_type = SHT_NULL;
+    sh[S_DYNSYM].sh_link = S_DYNSTR;
+    sh[S_DYNSYM].sh_info = 1;
+    sh[S_HASH].sh_link = S_DYNSYM;
+    sh[S_RELAPLT].sh_link = S_DYNSYM;
+    sh[S_RELAPLT].sh_info = S_GOTPLT;
+    sh[S_DYNAMIC].sh_link = S_DYNSTR;
+    memcpy(f.data + shoff, sh, sizeof(sh));
+
+    /* Program headers */
+    Elf64_Phdr *ph = (Elf64_Phdr *)(f.data + sizeof(Elf64_Ehdr));
+    int np = 0;
+    if (!o->is_lib) {
+        ph[np++] = (Elf64_Phdr){ PT_INTERP, PF_R, sh[S_INTERP].sh_offset, sh[S_INTERP].sh_addr,
+                                 sh[S_INTERP].sh_addr, sh[S_INTERP].sh_size, sh[S_INTERP].sh_size, 1 };
+    }
+    ph[np++] = (Elf64_Phdr){ PT_LOAD, PF_R | PF_W | PF_X, 0, base, base, file_size, file_size, 0x1000 };
+    ph[np++] = (Elf64_Phdr){ PT_DYNAMIC, PF_R | PF_W, sh[S_DYNAMIC].sh_offset, sh[S_DYNAMIC].sh_addr,
+                             sh[S_DYNAMIC].sh_addr, sh[S_DYNAMIC].sh_size, sh[S_DYNAMIC].sh_size, 8 };
+    ph[np++] = (Elf64_Phdr){ PT_GNU_STACK, PF_R | PF_W, 0, 0, 0, 0, 0, 16 };
+    if (o->relro) {
+        uint64_t end = o->bind_now ? sh[S_GOTPLT].sh_offset + sh[S_GOTPLT].sh_size
+                                   : sh[S_GOTPLT].sh_offset;
+        uint64_t len = end - sh[S_GOT].sh_offset;
+        ph[np++] = (Elf64_Phdr){ PT_GNU_RELRO, PF_R, sh[S_GOT].sh_offset, sh[S_GOT].sh_addr,
+                                 sh[S_GOT].sh_addr, len, len, 1 };
+    } else {
+        ph[np++] = (Elf64_Phdr){ PT_NULL, 0, 0, 0, 0, 0, 0, 0 };
+    }
+    if (o->is_lib && np > nphdr) np = nphdr;
+
+    /* ELF header */
+    Elf64_Ehdr *eh = (Elf64_Ehdr *)f.data;
+    memcpy(eh->e_ident, ELFMAG, SELFMAG);
+    eh->e_ident[EI_CLASS] = ELFCLASS64;
+    eh->e_ident[EI_DATA] = ELFDATA2LSB;
+    eh->e_ident[EI_VERSION] = EV_CURRENT;
+    eh->e_type = o->is_lib ? ET_DYN : ET_EXEC;
+    eh->e_machine = EM_X86_64;
+    eh->e_version = EV_CURRENT;
+    eh->e_entry = sh[S_TEXT].sh_addr;
+    eh->e_phoff = sizeof(Elf64_Ehdr);
+    eh->e_shoff = shoff;
+    eh->e_ehsize = sizeof(Elf64_Ehdr);
+    eh->e_phentsize = sizeof(Elf64_Phdr);
+    eh->e_phnum = nphdr;
+    eh->e_shentsize = sizeof(Elf64_Shdr);
+    eh->e_shnum = S_COUNT;
+    eh->e_shstrndx = S_SHSTRTAB;
+
+    int ret = -1;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0755);
+    if (fd >= 0) {
+        ret = write(fd, f.data, file_size) == (ssize_t)file_size ? 0 : -1;
+        if (close(fd) != 0) ret = -1;
+    }
+    if (ret < 0) perror(path);
+
+    for (int i = 0; i < nsym; i++) free(symnames[i]);
+    free(symnames);
+    free(syms);
+    free(hash);
+    free(f.data);
+    free(dynstr.data);
+    free(shstr.data);
+    return ret;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * CORPUS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void mkdir_p(const char *path, mode_t mode) {
+    char buf[PATH_MAX];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for (char *p = buf + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(buf, 0755);
+            *p = '/';
+        }
+    }
+    if (mkdir(buf, mode) < 0 && errno != EEXIST) {
+        perror(buf);
+        exit(1);
+    }
+    chmod(buf, mode);
+}
+
+/* Library i lives in lib/ or, for every 5th one, in a vendor dir */
+static void lib_dir(const char *out, uint32_t i, char *dir, size_t len) {
+    if (i % 5 == 4) snprintf(dir, len, "%s/opt/vendor%u/lib", out, i % NVENDORS);
+    else snprintf(dir, len, "%s/lib", out);
+}
+
+/* A search list: where the needed libraries really are, plus noise */
+static void make_rpath(object_t *o, const char *out, const uint32_t *libs, int nlibs) {
+    char *p = o->rpath;
+    size_t room = sizeof(o->rpath);
+    int n;
+
+    o->rpath[0] = '\0';
+    if (rnd(10) < 3) return;                    /* 30%: none */
+    o->runpath = rnd(2);
+
+    n = snprintf(p, room, "%s", rnd(3) ? "$ORIGIN/../lib" : "");
+    if (!n) n = snprintf(p, room, "%s/lib", out);
+    p += n;
+    room -= n;
+
+    for (int i = 0; i < nlibs && room > 256; i++) {
+        if (libs[i] % 5 == 4) {
+            char dir[PATH_MAX];
+            lib_dir(out, libs[i], dir, sizeof(dir));
+            n = snprintf(p, room, ":%s", dir);
+            p += n;
+            room -= n;
+        }
+    }
+
+    /* Extra components: missing, writable, or just long */
+    int extra = rnd_log(12);
+    for (int i = 0; i < extra && room > 256; i++) {
+        switch (rnd(4)) {
+            case 0:  n = snprintf(p, room, ":/opt/bench-missing-%u/lib", rnd(64)); break;
+            case 1:  n = snprintf(p, room, ":%s/writable", out); break;
+            case 2:  n = snprintf(p, room, ":/usr/local/lib/bench/%0*u", (int)rnd(160) + 1, 0); break;
+            default: n = snprintf(p, room, ":%s/opt/vendor%u/lib", out, rnd(NVENDORS)); break;
+        }
+        p += n;
+        room -= n;
+    }
+}
+
+static void pick_libs(uint32_t limit, int count, uint32_t *out, int *n) {
+    *n = 0;
+    for (int tries = 0; *n < count && tries < count * 4 && limit; tries++) {
+        uint32_t l = rnd(limit);
+        int dup = 0;
+        for (int i = 0; i < *n; i++) dup |= out[i] == l;
+        if (!dup) out[(*n)++] = l;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *out = NULL;
+    uint32_t nexec = 3000, nlib = 600;
+    uint64_t seed = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:n:l:s:")) != -1) {
+        switch (opt) {
+            case 'o': out = optarg; break;
+            case 'n': nexec = strtoul(optarg, NULL, 0); break;
+            case 'l': nlib = strtoul(optarg, NULL, 0); break;
+            case 's': seed = strtoull(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "Usage: %s -o DIR [-n executables] [-l libraries] [-s seed]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (!out || nlib == 0) {
+        fprintf(stderr, "Usage: %s -o DIR [-n executables] [-l libraries] [-s seed]\n", argv[0]);
+        return 2;
+    }
+    rng_state = seed * 0x9e3779b97f4a7c15ULL + 1;
+
+    char dir[PATH_MAX], path[PATH_MAX + 64];
+    char names[MAX_NEEDED][64];
+
+    snprintf(dir, sizeof(dir), "%s/bin", out);
+    mkdir_p(dir, 0755);
+    snprintf(dir, sizeof(dir), "%s/lib", out);
+    mkdir_p(dir, 0755);
+    snprintf(dir, sizeof(dir), "%s/writable", out);
+    mkdir_p(dir, 0777);
+    for (int v = 0; v < NVENDORS; v++) {
+        snprintf(dir, sizeof(dir), "%s/opt/vendor%d/lib", out, v);
+        mkdir_p(dir, 0755);
+    }
+
+    unsigned long bytes = 0;
+
+    /* Libraries: each needs a few lower-numbered ones, so the graph is a DAG */
+    for (uint32_t i = 0; i < nlib; i++) {
+        object_t o = {0};
+        uint32_t deps[MAX_NEEDED];
+        int ndeps;
+        char soname[64];
+
+        o.is_lib = 1;
+        o.id = i;
+        snprintf(soname, sizeof(soname), "libbench%04u.so.1", i);
+        o.soname = soname;
+        pick_libs(i, rnd(5), deps, &ndeps);
+        for (int d = 0; d < ndeps; d++) {
+            snprintf(names[d], sizeof(names[d]), "libbench%04u.so.1", deps[d]);
+            o.needed[o.nneeded++] = names[d];
+        }
+        o.needed[o.nneeded++] = "libc.so.6";
+        if (rnd(10) < 8) snprintf(o.rpath, sizeof(o.rpath), "$ORIGIN");
+        o.runpath = 1;
+        o.nimports = rnd_log(200);
+        o.nexports = 1 + rnd_log(64);
+        o.relro = rnd(10) < 8;
+        o.bind_now = o.relro && rnd(2);
+        o.padding = rnd_log(256 * 1024);
+
+        lib_dir(out, i, dir, sizeof(dir));
+        snprintf(path, sizeof(path), "%s/%s", dir, soname);
+        if (write_object(&o, path) < 0) return 1;
+        bytes += o.padding;
+    }
+
+    /* Executables */
+    for (uint32_t i = 0; i < nexec; i++) {
+        object_t o = {0};
+        uint32_t deps[MAX_NEEDED];
+        int ndeps;
+
+        o.id = nlib + i;
+        pick_libs(nlib, 1 + rnd_log(13), deps, &ndeps);
+        for (int d = 0; d < ndeps; d++) {
+            snprintf(names[d], sizeof(names[d]), "libbench%04u.so.1", deps[d]);
+            o.needed[o.nneeded++] = names[d];
+        }
+        o.needed[o.nneeded++] = "libc.so.6";
+        make_rpath(&o, out, deps, ndeps);
+        o.nimports = rnd_log(512);
+        o.relro = rnd(10) < 7;
+        o.bind_now = o.relro && rnd(3) == 0;
+        o.padding = rnd_log(256 * 1024);
+
+        snprintf(path, sizeof(path), "%s/bin/prog%05u", out, i);
+        if (write_object(&o, path) < 0) return 1;
+        bytes += o.padding;
+    }
+
+    printf("elfgen: %u executables + %u libraries in %s (seed %llu, %lu KiB padding)\n",
+           nexec, nlib, out, (unsigned long long)seed, bytes / 1024);
+    return 0;
+}
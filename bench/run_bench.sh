@@ -0,0 +1,106 @@
+#!/bin/sh
+#
+# run_bench.sh - Throughput benchmark for the scanners over a synthetic corpus
+#
+# Generates (once per parameter set) a corpus with elfgen, then runs each
+# scanner over it with benchrun and reports:
+#
+#   files/s      corpus files divided by the best wall time of $REPEAT runs
+#   syscalls     per file, from one extra ptrace'd run
+#   peak RSS     largest ru_maxrss over the timed runs
+#
+# Runs are warm (the corpus is in the page cache after generation).
+#
+# Usage: ./run_bench.sh [--corpus] [tool ...]
+#          --corpus   only generate the corpus
+#          tools      rpath_scanner dt_needed_explorer got_inspector (default: all)
+#
+# Environment: CORPUS (/tmp/elf_bench_corpus), NEXEC (3000), NLIB (600),
+#              SEED (1), REPEAT (3), THREADS (tool default)
+#
+# EDUCATIONAL PURPOSES ONLY
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(dirname "$HERE")
+CORPUS=${CORPUS:-/tmp/elf_bench_corpus}
+NEXEC=${NEXEC:-3000}
+NLIB=${NLIB:-600}
+SEED=${SEED:-1}
+REPEAT=${REPEAT:-3}
+
+CORPUS_ONLY=0
+if [ "$1" = "--corpus" ]; then
+    CORPUS_ONLY=1
+    shift
+fi
+TOOLS=${*:-"rpath_scanner dt_needed_explorer got_inspector"}
+
+make -s -C "$HERE" elfgen benchrun
+
+# ═══════════════════════════════════════════════════════════════════════════
+# CORPUS
+# ═══════════════════════════════════════════════════════════════════════════
+
+# Regenerate only when the parameters change, and never wipe a directory
+# elfgen did not create
+STAMP="$CORPUS/.elfgen"
+PARAMS="$NEXEC $NLIB $SEED"
+if [ "$(cat "$STAMP" 2>/dev/null)" != "$PARAMS" ]; then
+    if [ -e "$CORPUS" ] && [ ! -f "$STAMP" ]; then
+        echo "[!] $CORPUS exists and is not an elfgen corpus; set CORPUS=" >&2
+        exit 1
+    fi
+    rm -rf "$CORPUS"
+    "$HERE/elfgen" -o "$CORPUS" -n "$NEXEC" -l "$NLIB" -s "$SEED"
+    echo "$PARAMS" > "$STAMP"
+fi
+[ "$CORPUS_ONLY" = 1 ] && exit 0
+
+# ═══════════════════════════════════════════════════════════════════════════
+# RUNS
+# ═══════════════════════════════════════════════════════════════════════════
+
+THREADS_OPT=
+[ -n "$THREADS" ] && THREADS_OPT="--threads $THREADS"
+RESULT=$(mktemp)
+trap 'rm -f "$RESULT"' EXIT
+
+printf "\n%-20s %7s %9s %10s %10s %9s %10s\n" \
+    "tool" "files" "best s" "files/s" "syscalls" "sys/file" "peak RSS"
+printf "%-20s %7s %9s %10s %10s %9s %10s\n" \
+    "────────────────────" "───────" "─────────" "──────────" "──────────" "─────────" "──────────"
+
+for tool in $TOOLS; do
+    case $tool in
+        rpath_scanner)
+            dir=DT_RPATH_Exploitation
+            files=$((NEXEC + NLIB))
+            set -- --scan-system $THREADS_OPT --format jsonl "$CORPUS" ;;
+        dt_needed_explorer)
+            dir=DT_NEEDED_Injection
+            files=$((NEXEC + NLIB))
+            set -- --graph $THREADS_OPT --format jsonl "$CORPUS" ;;
+        got_inspector)
+            dir=GOT_PLT_Hijacking
+            files=$NEXEC
+            set -- --format jsonl "$CORPUS"/bin/* ;;
+        *)
+            echo "[!] Unknown tool: $tool" >&2
+            exit 2 ;;
+    esac
+
+    make -s -C "$ROOT/$dir" "$tool"
+    "$HERE/benchrun" -r "$REPEAT" -s -o "$RESULT" -- "$ROOT/$dir/$tool" "$@" >/dev/null 2>&1
+
+    awk -v tool="$tool" -v files="$files" '{
+        for (i = 1; i <= NF; i++) { split($i, kv, "="); r[kv[1]] = kv[2] }
+        rate = r["wall_s"] > 0 ? files / r["wall_s"] : 0
+        per = r["syscalls"] == "-" ? "-" : sprintf("%.2f", r["syscalls"] / files)
+        note = (r["status"] > 1) ? "  (exit " r["status"] ")" : ""
+        printf "%-20s %7d %9.3f %10.0f %10s %9s %6.1f MiB%s\n", tool, files, r["wall_s"],
+               rate, r["syscalls"], per, r["maxrss_kb"] / 1024, note
+    }' "$RESULT"
+done
+echo
@@ -0,0 +1,174 @@
+/*
+ * elf_version.c - GNU symbol version tables read from an elf_view
+ *
+ * See elf_version.h. Each chain is walked twice: once to count the
+ * entries, once to fill arrays of exactly that size. The second walk
+ * stops at that size even if it finds more: a file rewritten between
+ * the two must not overrun the arrays.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "elf_version.h"
+
+/* A chain never has more links than its DT_*NUM says; this caps a lying one */
+#define MAX_CHAIN   4096
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * VERNEED (.gnu.version_r)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static size_t walk_verneed(const elf_view_t *v, elf_verneed_t *out, size_t max) {
+    uint64_t at = elf_view_dyn(v, DT_VERNEED);
+    uint64_t num = elf_view_dyn(v, DT_VERNEEDNUM);
+    size_t n = 0;
+
+    if (num > MAX_CHAIN) num = MAX_CHAIN;
+    for (uint64_t i = 0; i < num; i++) {
+        const Elf64_Verneed *vn = elf_view_vaddr(v, at, sizeof(*vn));
+        if (!vn || vn->vn_version != VER_NEED_CURRENT) break;
+
+        const char *file = elf_view_dynstr(v, vn->vn_file);
+        uint64_t aux_at = at + vn->vn_aux;
+
+        for (unsigned k = 0; k < vn->vn_cnt && k < MAX_CHAIN; k++) {
+            const Elf64_Vernaux *aux = elf_view_vaddr(v, aux_at, sizeof(*aux));
+            if (!aux) break;
+
+            const char *name = elf_view_dynstr(v, aux->vna_name);
+            if (name && file) {
+                if (n == max) return n;
+                if (out) {
+                    out[n] = (elf_verneed_t){
+                        .file = file,
+                        .name = name,
+                        .hash = aux->vna_hash,
+                        .flags = aux->vna_flags,
+                        .ndx = aux->vna_other & VERSYM_VERSION,
+                    };
+                }
+                n++;
+            }
+            if (aux->vna_next == 0) break;
+            aux_at += aux->vna_next;
+        }
+
+        if (vn->vn_next == 0) break;
+        at += vn->vn_next;
+    }
+    return n;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * VERDEF (.gnu.version_d)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static size_t walk_verdef(const elf_view_t *v, elf_verdef_t *out, size_t max) {
+    uint64_t at = elf_view_dyn(v, DT_VERDEF);
+    uint64_t num = elf_view_dyn(v, DT_VERDEFNUM);
+    size_t n = 0;
+
+    if (num > MAX_CHAIN) num = MAX_CHAIN;
+    for (uint64_t i = 0; i < num; i++) {
+        const Elf64_Verdef *vd = elf_view_vaddr(v, at, sizeof(*vd));
+        if (!vd || vd->vd_version != VER_DEF_CURRENT) break;
+
+        const Elf64_Verdaux *aux = vd->vd_cnt ? elf_view_vaddr(v, at + vd->vd_aux, sizeof(*aux)) : NULL;
+        const char *name = aux ? elf_view_dynstr(v, aux->vda_name) : NULL;
+
+        if (name) {
+            if (n == max) return n;
+            const char *parent = NULL;
+            if (vd->vd_cnt > 1 && aux->vda_next) {
+                const Elf64_Verdaux *up = elf_view_vaddr(v, at + vd->vd_aux + aux->vda_next, sizeof(*up));
+                if (up) parent = elf_view_dynstr(v, up->vda_name);
+            }
+            if (out) {
+                out[n] = (elf_verdef_t){
+                    .name = name,
+                    .parent = parent,
+                    .hash = vd->vd_hash,
+                    .flags = vd->vd_flags,
+                    .ndx = vd->vd_ndx & VERSYM_VERSION,
+                };
+            }
+            n++;
+        }
+
+        if (vd->vd_next == 0) break;
+        at += vd->vd_next;
+    }
+    return n;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * LOAD
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int elf_versions_load(elf_versions_t *vs, const elf_view_t *v) {
+    memset(vs, 0, sizeof(*vs));
+
+    vs->dynsym = elf_view_dynsym(v, &vs->nsyms);
+    if (vs->dynsym && elf_view_has(v, DT_VERSYM)) {
+        vs->versym = elf_view_vaddr(v, elf_view_dyn(v, DT_VERSYM), vs->nsyms * sizeof(Elf64_Half));
+    }
+
+    if (elf_view_has(v, DT_VERNEED)) {
+        size_t n = walk_verneed(v, NULL, SIZE_MAX);
+        if (n) {
+            vs->needs = malloc(n * sizeof(*vs->needs));
+            if (!vs->needs) goto nomem;
+            vs->nneeds = walk_verneed(v, vs->needs, n);
+        }
+    }
+    if (elf_view_has(v, DT_VERDEF)) {
+        size_t n = walk_verdef(v, NULL, SIZE_MAX);
+        if (n) {
+            vs->defs = malloc(n * sizeof(*vs->defs));
+            if (!vs->defs) goto nomem;
+            vs->ndefs = walk_verdef(v, vs->defs, n);
+        }
+    }
+
+    /* Index → name, over both tables (they share one index space) */
+    for (size_t i = 0; i < vs->nneeds; i++) {
+        if (vs->needs[i].ndx > vs->max_ndx) vs->max_ndx = vs->needs[i].ndx;
+    }
+    for (size_t i = 0; i < vs->ndefs; i++) {
+        if (vs->defs[i].ndx > vs->max_ndx) vs->max_ndx = vs->defs[i].ndx;
+    }
+    if (vs->nneeds || vs->ndefs) {
+        vs->by_ndx = calloc((size_t)vs->max_ndx + 1, sizeof(*vs->by_ndx));
+        if (!vs->by_ndx) goto nomem;
+        for (size_t i = 0; i < vs->nneeds; i++) {
+            vs->by_ndx[vs->needs[i].ndx] = vs->needs[i].name;
+        }
+        for (size_t i = 0; i < vs->ndefs; i++) {
+            if (!(vs->defs[i].flags & VER_FLG_BASE)) vs->by_ndx[vs->defs[i].ndx] = vs->defs[i].name;
+        }
+    }
+    return 0;
+
+nomem:
+    elf_versions_free(vs);
+    errno = ENOMEM;
+    return -1;
+}
+
+void elf_versions_free(elf_versions_t *vs) {
+    free(vs->needs);
+    free(vs->defs);
+    free(vs->by_ndx);
+    memset(vs, 0, sizeof(*vs));
+}
+
+const char *elf_versions_name(const elf_versions_t *vs, uint16_t versym) {
+    uint16_t ndx = versym & VERSYM_VERSION;
+    if (ndx <= VER_NDX_GLOBAL || ndx > vs->max_ndx || !vs->by_ndx) return NULL;
+    return vs->by_ndx[ndx];
+}
@@ -0,0 +1,76 @@
+/*
+ * elf_version.h - GNU symbol version tables read from an elf_view
+ *
+ * The three tables readelf -V prints, parsed in-process from the mapped
+ * file (no readelf, no shell):
+ *
+ *   .gnu.version     DT_VERSYM     one Elf64_Half per dynamic symbol:
+ *                                  version index, bit 15 = hidden
+ *   .gnu.version_r   DT_VERNEED    per needed library, the versions it
+ *                                  must define (GLIBC_2.34, ...)
+ *   .gnu.version_d   DT_VERDEF     the versions this object defines
+ *
+ * Everything is located through the dynamic segment, so stripped
+ * section headers do not matter. Every offset and chain link is bounds
+ * checked against the mapping; a malformed chain ends the walk rather
+ * than failing the whole file.
+ *
+ * Strings point into the view's .dynstr: an elf_versions_t is valid
+ * until the view is closed.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef ELF_VERSION_H
+#define ELF_VERSION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "elf_view.h"
+
+#ifndef VERSYM_HIDDEN
+#define VERSYM_HIDDEN       0x8000
+#define VERSYM_VERSION      0x7fff
+#endif
+
+/* One Vernaux entry: library file needs version name */
+typedef struct {
+    const char *file;           /* vn_file: the DT_NEEDED soname */
+    const char *name;           /* vna_name: e.g. "GLIBC_2.34" */
+    uint32_t    hash;           /* vna_hash (ELF hash of name) */
+    uint16_t    flags;          /* VER_FLG_WEAK */
+    uint16_t    ndx;            /* vna_other: index used in .gnu.version */
+} elf_verneed_t;
+
+/* One Verdef entry */
+typedef struct {
+    const char *name;           /* first Verdaux: the version (or soname for the base) */
+    const char *parent;         /* second Verdaux, if any (version inheritance) */
+    uint32_t    hash;           /* vd_hash */
+    uint16_t    flags;          /* VER_FLG_BASE, VER_FLG_WEAK */
+    uint16_t    ndx;
+} elf_verdef_t;
+
+typedef struct {
+    const Elf64_Sym   *dynsym;
+    size_t             nsyms;
+    const Elf64_Half  *versym;      /* nsyms entries, NULL if no DT_VERSYM */
+
+    elf_verneed_t     *needs;       /* in file order, grouped by library */
+    size_t             nneeds;
+    elf_verdef_t      *defs;
+    size_t             ndefs;
+
+    const char       **by_ndx;      /* version index → name (NULL: none) */
+    uint16_t           max_ndx;
+} elf_versions_t;
+
+/* Parse the version tables of v. Returns 0 (also when there are none), -1 on ENOMEM. */
+int elf_versions_load(elf_versions_t *vs, const elf_view_t *v);
+void elf_versions_free(elf_versions_t *vs);
+
+/* Version name for a .gnu.version entry (hidden bit ignored); NULL for local/global */
+const char *elf_versions_name(const elf_versions_t *vs, uint16_t versym);
+
+#endif /* ELF_VERSION_H */
@@ -0,0 +1,788 @@
+/*
+ * elf_view.c - Single-pass ELF file view shared by the scanners
+ *
+ * See elf_view.h for the layout. Everything here reads the file through
+ * elf_view_at(), which serves either the one read-only mapping made by
+ * elf_view_open() or, for a ranged view, the pieces read so far. Values
+ * taken from the file are only ever compared by subtraction against
+ * what is left, so a huge offset or count cannot wrap past a check.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "elf_view.h"
+
+#define RANGE_PAGE      4096            /* misses are widened to whole pages */
+#define BATCH_ROUNDS    8               /* header, phdrs, dynamic, dynstr, strings, slack;
+                                           then a view finishes with plain reads */
+
+/* A piece of a ranged view's file; never moved or freed before close */
+typedef struct range_chunk {
+    struct range_chunk *next;
+    uint64_t            off;
+    size_t              len;
+    uint64_t            data[];         /* 8-byte aligned, so headers are usable in place */
+} range_chunk_t;
+
+#define MAX_MISSES      8               /* independent pieces a probe can ask for */
+
+struct elf_view_io {
+    range_chunk_t *chunks;              /* newest first */
+    range_chunk_t *last;                /* last chunk a lookup hit */
+    int            no_fetch;            /* batch probe: record misses, don't read */
+    int            nmiss;
+    int            overflow;            /* wanted more than MAX_MISSES pieces */
+    uint64_t       miss_off[MAX_MISSES];    /* whole pages, merged */
+    uint64_t       miss_len[MAX_MISSES];
+    unsigned long  reads;
+    uint64_t       bytes;
+};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * SIGBUS GUARD
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/*
+ * Touching a page of a mapping that lies past the end of its file raises
+ * SIGBUS. A mapped view registers its range here; the handler maps a
+ * zero page over the faulting one and marks the slot, and the read that
+ * faulted simply resumes. Slots are per thread: SIGBUS for a fault is
+ * delivered to the thread that touched the page.
+ */
+#define GUARD_SLOTS     16
+
+typedef struct {
+    uintptr_t              start, end;  /* [start, end) of the mapping; 0, 0 if free */
+    volatile sig_atomic_t  hit;
+} guard_t;
+
+static __thread guard_t guards[GUARD_SLOTS];
+static struct sigaction guard_prev;
+static uintptr_t guard_page;
+static pthread_once_t guard_once = PTHREAD_ONCE_INIT;
+
+static void guard_handler(int sig, siginfo_t *si, void *uc) {
+    uintptr_t addr = (uintptr_t)si->si_addr;
+
+    for (int i = 0; i < GUARD_SLOTS; i++) {
+        guard_t *g = &guards[i];
+        if (addr < g->start || addr >= g->end) continue;
+
+        void *page = (void *)(addr & ~(guard_page - 1));
+        if (mmap(page, guard_page, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+                 -1, 0) != MAP_FAILED) {
+            g->hit = 1;
+            return;
+        }
+        break;
+    }
+
+    /* Not ours: whoever handled SIGBUS before, else the default death */
+    if (guard_prev.sa_flags & SA_SIGINFO) {
+        guard_prev.sa_sigaction(sig, si, uc);
+    } else if (guard_prev.sa_handler != SIG_DFL && guard_prev.sa_handler != SIG_IGN) {
+        guard_prev.sa_handler(sig);
+    } else {
+        signal(SIGBUS, SIG_DFL);        /* the access faults again, fatally */
+    }
+}
+
+static void guard_install(void) {
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = guard_handler;
+    sa.sa_flags = SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    guard_page = sysconf(_SC_PAGESIZE);
+    sigaction(SIGBUS, &sa, &guard_prev);
+}
+
+/* Guard v's mapping if a slot is free; an unguarded view reads as before */
+static void guard_add(elf_view_t *v) {
+    pthread_once(&guard_once, guard_install);
+    for (int i = 0; i < GUARD_SLOTS; i++) {
+        guard_t *g = &guards[i];
+        if (g->end) continue;
+        g->hit = 0;
+        g->start = (uintptr_t)v->map;
+        g->end = (uintptr_t)v->map + v->size;
+        v->guard = i + 1;
+        return;
+    }
+}
+
+static void guard_del(elf_view_t *v) {
+    if (!v->guard) return;
+    guard_t *g = &guards[v->guard - 1];
+    g->start = g->end = 0;
+    v->guard = 0;
+}
+
+int elf_view_truncated(const elf_view_t *v) {
+    return v->guard && guards[v->guard - 1].hit;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * DYNAMIC TAG TABLE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static const int64_t extra_tags[ELF_VIEW_DT_EXTRA] = {
+    DT_GNU_HASH, DT_VERSYM, DT_VERDEF, DT_VERDEFNUM,
+    DT_VERNEED, DT_VERNEEDNUM, DT_FLAGS_1, DT_RELACOUNT
+};
+
+static int dyn_slot(int64_t tag) {
+    if (tag >= 0 && tag < DT_NUM) {
+        return (int)tag;
+    }
+    for (int i = 0; i < ELF_VIEW_DT_EXTRA; i++) {
+        if (extra_tags[i] == tag) {
+            return DT_NUM + i;
+        }
+    }
+    return -1;
+}
+
+int elf_view_has(const elf_view_t *v, int64_t tag) {
+    int slot = dyn_slot(tag);
+    return slot >= 0 && (v->dyn_seen & (1ULL << slot)) != 0;
+}
+
+uint64_t elf_view_dyn(const elf_view_t *v, int64_t tag) {
+    int slot = dyn_slot(tag);
+    return slot >= 0 ? v->dyn_val[slot] : 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * ADDRESS TRANSLATION
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Exactly len bytes at off, or -1 (a short read means a truncated file) */
+static int pread_full(int fd, void *buf, size_t len, uint64_t off) {
+    while (len > 0) {
+        ssize_t n = pread(fd, buf, len, off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            if (n == 0) errno = ENOEXEC;
+            return -1;
+        }
+        buf = (char *)buf + n;
+        len -= n;
+        off += n;
+    }
+    return 0;
+}
+
+static range_chunk_t *chunk_alloc(uint64_t off, size_t len) {
+    range_chunk_t *c = malloc(sizeof(*c) + len);
+    if (!c) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    c->next = NULL;
+    c->off = off;
+    c->len = len;
+    return c;
+}
+
+static void chunk_link(struct elf_view_io *io, range_chunk_t *c) {
+    c->next = io->chunks;
+    io->chunks = c;
+    io->last = c;
+    io->bytes += c->len;
+}
+
+/* The whole pages around [off, off + len), clipped to the file */
+static void widen(const elf_view_t *v, uint64_t *off, uint64_t *len) {
+    uint64_t end = (*off + *len + RANGE_PAGE - 1) & ~(uint64_t)(RANGE_PAGE - 1);
+    if (end > v->size) end = v->size;
+    *off &= ~(uint64_t)(RANGE_PAGE - 1);
+    *len = end - *off;
+}
+
+/*
+ * A chunk holding at least need bytes at off, else the one holding the
+ * most (avail < need), or NULL. The last hit is tried first: lookups
+ * tend to walk through one table.
+ */
+static range_chunk_t *chunk_find(struct elf_view_io *io, uint64_t off, uint64_t need,
+                                 uint64_t *avail) {
+    range_chunk_t *best = io->last;
+
+    *avail = 0;
+    if (best && off >= best->off && off - best->off <= best->len) {
+        *avail = best->len - (off - best->off);
+        if (*avail >= need) return best;
+    } else {
+        best = NULL;
+    }
+    for (range_chunk_t *c = io->chunks; c; c = c->next) {
+        if (off >= c->off && off - c->off <= c->len && c->len - (off - c->off) > *avail) {
+            best = c;
+            *avail = c->len - (off - c->off);
+            if (*avail >= need) break;
+        }
+    }
+    if (best) io->last = best;
+    return best;
+}
+
+/* Probe: note that [off, off + len) is wanted, merged with what overlaps it */
+static void note_miss(const elf_view_t *v, uint64_t off, uint64_t len) {
+    struct elf_view_io *io = v->io;
+
+    widen(v, &off, &len);
+    for (int i = 0; i < io->nmiss; i++) {
+        uint64_t lo = io->miss_off[i], hi = lo + io->miss_len[i];
+        if (off <= hi && off + len >= lo) {
+            if (off < lo) lo = off;
+            if (off + len > hi) hi = off + len;
+            io->miss_off[i] = lo;
+            io->miss_len[i] = hi - lo;
+            return;
+        }
+    }
+    if (io->nmiss == MAX_MISSES) {
+        io->overflow = 1;               /* the probe is incomplete: another round */
+        return;
+    }
+    io->miss_off[io->nmiss] = off;
+    io->miss_len[io->nmiss++] = len;
+}
+
+/* Read [off, off + len), widened to whole pages, into a new chunk */
+static range_chunk_t *fetch(const elf_view_t *v, uint64_t off, uint64_t len) {
+    struct elf_view_io *io = v->io;
+
+    widen(v, &off, &len);
+    range_chunk_t *c = chunk_alloc(off, len);
+    if (!c) return NULL;
+    io->reads++;
+    if (pread_full(v->fd, c->data, len, off) < 0) {
+        free(c);
+        return NULL;
+    }
+    chunk_link(io, c);
+    return c;
+}
+
+/* Ranged view: from a piece already read, else read it now (unless probing) */
+static const void *range_at(const elf_view_t *v, uint64_t off, uint64_t len) {
+    uint64_t avail;
+    range_chunk_t *c = chunk_find(v->io, off, len, &avail);
+
+    if (!c || avail < len) {
+        if (v->io->no_fetch) {
+            note_miss(v, off, len);
+            return NULL;
+        }
+        if (!(c = fetch(v, off, len))) return NULL;
+    }
+    return (const uint8_t *)c->data + (off - c->off);
+}
+
+/*
+ * Ranged view: a NUL-terminated string at off, at most max bytes long
+ * with its NUL. Only the pages it lies on are read, one more at a time
+ * while no NUL has turned up; NULL if there is none within max.
+ */
+static const char *range_str(const elf_view_t *v, uint64_t off, uint64_t max) {
+    for (;;) {
+        uint64_t avail;
+        range_chunk_t *c = chunk_find(v->io, off, max, &avail);
+        const char *s = c ? (const char *)c->data + (off - c->off) : NULL;
+
+        if (s && memchr(s, '\0', avail < max ? avail : max)) return s;
+        if (s && avail >= max) return NULL;
+
+        uint64_t want = avail + 1 < max ? avail + 1 : max;
+        if (v->io->no_fetch) {
+            note_miss(v, off, want);
+            return NULL;
+        }
+        if (!fetch(v, off, want)) return NULL;
+    }
+}
+
+const void *elf_view_at(const elf_view_t *v, uint64_t off, uint64_t len) {
+    if (off > v->size || len > v->size - off) {
+        return NULL;
+    }
+    if (v->io) {
+        return range_at(v, off, len);
+    }
+    return v->map + off;
+}
+
+/* The PT_LOAD holding vaddr: its file offset, and the file bytes left in it from there */
+static int vaddr_lookup(const elf_view_t *v, uint64_t vaddr, uint64_t *off, uint64_t *left) {
+    for (int i = 0; i < v->phnum; i++) {
+        const Elf64_Phdr *ph = &v->phdr[i];
+        if (ph->p_type == PT_LOAD &&
+            vaddr >= ph->p_vaddr &&
+            vaddr - ph->p_vaddr < ph->p_filesz) {
+            *off = vaddr - ph->p_vaddr + ph->p_offset;
+            *left = ph->p_filesz - (vaddr - ph->p_vaddr);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int elf_view_vaddr_to_off(const elf_view_t *v, uint64_t vaddr, uint64_t *off) {
+    uint64_t left;
+    return vaddr_lookup(v, vaddr, off, &left);
+}
+
+const void *elf_view_vaddr(const elf_view_t *v, uint64_t vaddr, uint64_t len) {
+    uint64_t off, left;
+    if (vaddr_lookup(v, vaddr, &off, &left) < 0 || len > left) {
+        return NULL;
+    }
+    return elf_view_at(v, off, len);
+}
+
+const char *elf_view_dynstr(const elf_view_t *v, uint64_t off) {
+    if (!v->dynstr || off >= v->dynstr_size) {
+        return NULL;
+    }
+    if (v->io) {
+        return range_str(v, v->dynstr_off + off, v->dynstr_size - off);
+    }
+    return memchr(v->dynstr + off, '\0', v->dynstr_size - off) ? v->dynstr + off : NULL;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * SECTIONS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/*
+ * The section name table is only looked up here, so a view that never
+ * asks for a section never touches the header table at the end of the
+ * file.
+ */
+const Elf64_Shdr *elf_view_section(const elf_view_t *v, const char *name) {
+    if (v->ehdr->e_shstrndx >= v->shnum) return NULL;
+
+    const Elf64_Shdr *strs = &v->shdr[v->ehdr->e_shstrndx];
+    const char *shstrtab = elf_view_at(v, strs->sh_offset, strs->sh_size);
+    if (!shstrtab) return NULL;
+
+    size_t len = strlen(name);
+    for (int i = 0; i < v->shnum; i++) {
+        uint64_t at = v->shdr[i].sh_name;
+        if (at < strs->sh_size && len < strs->sh_size - at &&
+            memcmp(shstrtab + at, name, len + 1) == 0) {
+            return &v->shdr[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Symbols in a DT_GNU_HASH table: past the highest bucket start, to the
+ * chain end. The unhashed ones (undefined, local) sit below symoffset,
+ * so this is all of .dynsym; 0 if the table hashes no symbol at all.
+ */
+static size_t gnu_hash_symbols(const elf_view_t *v) {
+    const uint32_t *hdr = elf_view_vaddr(v, elf_view_dyn(v, DT_GNU_HASH), 4 * sizeof(uint32_t));
+    if (!hdr) return 0;
+
+    uint32_t nbuckets = hdr[0], symoffset = hdr[1], bloom_size = hdr[2];
+    uint64_t buckets_at = elf_view_dyn(v, DT_GNU_HASH) + 16 + (uint64_t)bloom_size * 8;
+    const uint32_t *buckets = elf_view_vaddr(v, buckets_at, (uint64_t)nbuckets * 4);
+    if (!buckets) return 0;
+
+    uint32_t last = 0;
+    for (uint32_t b = 0; b < nbuckets; b++) {
+        if (buckets[b] > last) last = buckets[b];
+    }
+    /* Nothing hashed: the table says nothing about the unhashed rest */
+    if (last < symoffset) return 0;
+
+    uint64_t chain_at = buckets_at + (uint64_t)nbuckets * 4;
+    for (;;) {
+        const uint32_t *h = elf_view_vaddr(v, chain_at + (uint64_t)(last - symoffset) * 4, 4);
+        if (!h) return 0;
+        if (*h & 1) return (size_t)last + 1;
+        last++;
+    }
+}
+
+const Elf64_Sym *elf_view_dynsym(const elf_view_t *v, size_t *count) {
+    size_t n = 0;
+
+    *count = 0;
+    if (!elf_view_has(v, DT_SYMTAB)) return NULL;
+
+    /* The hash tables sit next to .dynsym; the section headers do not */
+    if (elf_view_has(v, DT_HASH)) {
+        const uint32_t *hash = elf_view_vaddr(v, elf_view_dyn(v, DT_HASH), 2 * sizeof(uint32_t));
+        if (hash) n = hash[1];
+    }
+    if (n == 0 && elf_view_has(v, DT_GNU_HASH)) {
+        n = gnu_hash_symbols(v);
+    }
+    for (int i = 0; n == 0 && i < v->shnum; i++) {
+        if (v->shdr[i].sh_type == SHT_DYNSYM && v->shdr[i].sh_entsize == sizeof(Elf64_Sym)) {
+            n = v->shdr[i].sh_size / sizeof(Elf64_Sym);
+        }
+    }
+
+    const Elf64_Sym *syms = elf_view_vaddr(v, elf_view_dyn(v, DT_SYMTAB), (uint64_t)n * sizeof(Elf64_Sym));
+    if (syms) *count = n;
+    return syms;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * OPEN / INDEX
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void index_phdrs(elf_view_t *v) {
+    for (int i = 0; i < v->phnum; i++) {
+        const Elf64_Phdr *ph = &v->phdr[i];
+        switch (ph->p_type) {
+            case PT_DYNAMIC:
+                if (!v->pt_dynamic) v->pt_dynamic = ph;
+                break;
+            case PT_INTERP:
+                v->pt_interp = ph;
+                break;
+            case PT_GNU_RELRO:
+                v->pt_gnu_relro = ph;
+                break;
+            case PT_GNU_STACK:
+                v->pt_gnu_stack = ph;
+                break;
+        }
+    }
+}
+
+static void index_dynamic(elf_view_t *v) {
+    const Elf64_Phdr *ph = v->pt_dynamic;
+    if (!ph) return;
+
+    v->dynamic = elf_view_at(v, ph->p_offset, ph->p_filesz);
+    if (!v->dynamic) return;
+
+    size_t max = ph->p_filesz / sizeof(Elf64_Dyn);
+    for (v->dyn_count = 0; v->dyn_count < max; v->dyn_count++) {
+        const Elf64_Dyn *d = &v->dynamic[v->dyn_count];
+        if (d->d_tag == DT_NULL) break;
+
+        if (d->d_tag == DT_NEEDED) {
+            v->needed_count++;
+        }
+
+        /* First occurrence wins, as in ld.so */
+        int slot = dyn_slot(d->d_tag);
+        if (slot >= 0 && !(v->dyn_seen & (1ULL << slot))) {
+            v->dyn_val[slot] = d->d_un.d_val;
+            v->dyn_seen |= 1ULL << slot;
+        }
+    }
+
+    if (elf_view_has(v, DT_STRTAB)) {
+        uint64_t off, left;
+        if (vaddr_lookup(v, elf_view_dyn(v, DT_STRTAB), &off, &left) == 0 &&
+            off < v->size) {
+            uint64_t size = elf_view_dyn(v, DT_STRSZ);
+            if (size > left) {
+                size = left;
+            }
+            if (size > v->size - off) {
+                size = v->size - off;
+            }
+            /* A ranged view reads strings as they are asked for */
+            v->dynstr = elf_view_at(v, off, v->io && size ? 1 : size);
+            if (v->dynstr) {
+                v->dynstr_off = off;
+                v->dynstr_size = size;
+            }
+        }
+    }
+}
+
+/* Bounds only: the headers themselves are read on first elf_view_section() */
+static void index_sections(elf_view_t *v) {
+    const Elf64_Ehdr *eh = v->ehdr;
+    if (eh->e_shoff == 0 || eh->e_shnum == 0 ||
+        eh->e_shentsize != sizeof(Elf64_Shdr)) {
+        return;
+    }
+
+    v->shdr = elf_view_at(v, eh->e_shoff, (uint64_t)eh->e_shnum * sizeof(Elf64_Shdr));
+    if (v->shdr) {
+        v->shnum = eh->e_shnum;
+    }
+}
+
+/*
+ * Everything below the fields set at open: on a ranged view this runs
+ * once per batch round, so it must start from a clean index each time.
+ */
+static int view_index(elf_view_t *v) {
+    memset(&v->ehdr, 0, sizeof(*v) - offsetof(elf_view_t, ehdr));
+    if (v->size < sizeof(Elf64_Ehdr)) {
+        errno = ENOEXEC;
+        return -1;
+    }
+
+    v->ehdr = elf_view_at(v, 0, sizeof(Elf64_Ehdr));
+    if (!v->ehdr) {
+        if (!v->io || !v->io->no_fetch) return -1;
+        return 0;
+    }
+    if (memcmp(v->ehdr->e_ident, ELFMAG, SELFMAG) != 0 ||
+        v->ehdr->e_ident[EI_CLASS] != ELFCLASS64) {
+        errno = ENOEXEC;
+        return -1;
+    }
+
+    if (v->ehdr->e_phentsize == sizeof(Elf64_Phdr)) {
+        v->phdr = elf_view_at(v, v->ehdr->e_phoff,
+                              (uint64_t)v->ehdr->e_phnum * sizeof(Elf64_Phdr));
+        if (v->phdr) {
+            v->phnum = v->ehdr->e_phnum;
+        }
+    }
+
+    index_phdrs(v);
+    index_dynamic(v);
+    if (!v->io) {
+        index_sections(v);
+    }
+    return 0;
+}
+
+static int stat_file(elf_view_t *v, off_t min_size) {
+    if (fstat(v->fd, &v->st) < 0) {
+        return -1;
+    }
+    if (!S_ISREG(v->st.st_mode) || v->st.st_size < min_size) {
+        errno = ENOEXEC;
+        return -1;
+    }
+    v->size = v->st.st_size;
+    return 0;
+}
+
+static int fail_close(elf_view_t *v) {
+    int saved = errno;
+    elf_view_close(v);
+    errno = saved;
+    return -1;
+}
+
+static int map_and_index(elf_view_t *v) {
+    if (stat_file(v, sizeof(Elf64_Ehdr)) < 0) {
+        return fail_close(v);
+    }
+
+    void *map = mmap(NULL, v->size, PROT_READ, MAP_PRIVATE, v->fd, 0);
+    if (map == MAP_FAILED) {
+        return fail_close(v);
+    }
+    v->map = map;
+    guard_add(v);
+
+    if (view_index(v) < 0) {
+        return fail_close(v);
+    }
+    if (elf_view_truncated(v)) {
+        errno = EIO;
+        return fail_close(v);
+    }
+    return 0;
+}
+
+/* Ranged view without any data yet */
+static int ranged_init(elf_view_t *v, int fd, const char *path, off_t min_size) {
+    memset(v, 0, sizeof(*v));
+    v->path = path;
+    v->fd = fd;
+    if (stat_file(v, min_size) < 0) {
+        return fail_close(v);
+    }
+    v->io = calloc(1, sizeof(*v->io));
+    if (!v->io) {
+        errno = ENOMEM;
+        return fail_close(v);
+    }
+    return 0;
+}
+
+int elf_view_open(elf_view_t *v, const char *path) {
+    memset(v, 0, sizeof(*v));
+    v->path = path;
+    v->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (v->fd < 0) {
+        return -1;
+    }
+    v->owns_fd = 1;
+    return map_and_index(v);
+}
+
+int elf_view_open_fd(elf_view_t *v, int fd, const char *path) {
+    memset(v, 0, sizeof(*v));
+    v->path = path;
+    v->fd = fd;
+    return map_and_index(v);
+}
+
+int elf_view_open_ranged(elf_view_t *v, int fd, const char *path) {
+    if (ranged_init(v, fd, path, sizeof(Elf64_Ehdr)) < 0) {
+        return -1;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+    if (view_index(v) < 0) {
+        return fail_close(v);
+    }
+    return 0;
+}
+
+/* The strings the dynamic segment itself names; a batch reads them up front */
+static void touch_dyn_strings(const elf_view_t *v) {
+    for (size_t i = 0; i < v->dyn_count; i++) {
+        switch (v->dynamic[i].d_tag) {
+            case DT_NEEDED:
+            case DT_SONAME:
+            case DT_RPATH:
+            case DT_RUNPATH:
+                elf_view_dynstr(v, v->dynamic[i].d_un.d_val);
+                break;
+        }
+    }
+}
+
+/*
+ * Each round probes every unfinished view: the index runs against the
+ * pieces read so far and notes what it is missing (header, then program
+ * headers, dynamic segment, .dynstr, then the strings the dynamic
+ * segment names). The missing pieces of all views are read as one batch
+ * and the round repeats; a view that misses nothing is complete, with
+ * exactly the index a synchronous open would have built. A view still
+ * missing pieces after BATCH_ROUNDS (a string spanning many pages, say)
+ * is finished by one more probe that reads what it needs with pread().
+ */
+void elf_view_open_batch(elf_view_batch_t *b, size_t n, read_batch_t *rb) {
+    read_req_t *reqs = calloc(n ? n * MAX_MISSES : 1, sizeof(*reqs));
+    size_t *owner = calloc(n ? n * MAX_MISSES : 1, sizeof(*owner));
+    int *busy = calloc(n ? n : 1, sizeof(*busy));
+
+    for (size_t i = 0; i < n; i++) {
+        b[i].is_elf = 0;
+        b[i].err = 0;
+        /* Anything non-empty: is_elf needs the magic even of a runt */
+        if (ranged_init(&b[i].view, b[i].fd, b[i].path, 1) < 0) {
+            b[i].err = errno;
+        } else if (!reqs || !owner || !busy) {
+            elf_view_close(&b[i].view);
+            b[i].err = ENOMEM;
+        } else {
+            busy[i] = 1;
+        }
+    }
+
+    for (int round = 0; reqs && owner && busy; round++) {
+        size_t k = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            if (!busy[i]) continue;
+            elf_view_t *v = &b[i].view;
+            struct elf_view_io *io = v->io;
+
+            io->no_fetch = round < BATCH_ROUNDS;
+            io->nmiss = 0;
+            io->overflow = 0;
+            int rc = 0;
+            const void *magic = elf_view_at(v, 0, v->size < SELFMAG ? v->size : SELFMAG);
+            if (magic) {
+                b[i].is_elf = v->size >= SELFMAG && memcmp(magic, ELFMAG, SELFMAG) == 0;
+                rc = view_index(v);
+                if (rc == 0 && io->nmiss == 0) {
+                    touch_dyn_strings(v);
+                }
+            } else if (!io->no_fetch) {
+                rc = -1;
+            }
+            io->no_fetch = 0;
+            if (rc < 0 || (!io->nmiss && !io->overflow)) {
+                busy[i] = 0;
+                if (rc < 0) {
+                    b[i].err = errno;
+                    elf_view_close(v);
+                }
+                continue;
+            }
+
+            for (int m = 0; m < io->nmiss; m++) {
+                range_chunk_t *c = chunk_alloc(io->miss_off[m], io->miss_len[m]);
+                if (!c) break;
+                reqs[k] = (read_req_t){
+                    .fd = v->fd, .random = round == 0 && m == 0,
+                    .off = c->off, .len = c->len, .buf = c->data,
+                };
+                owner[k++] = i;
+            }
+        }
+        if (k == 0) break;
+
+        read_batch_run(rb, reqs, k);
+
+        for (size_t j = 0; j < k; j++) {
+            elf_view_t *v = &b[owner[j]].view;
+            range_chunk_t *c = (range_chunk_t *)((char *)reqs[j].buf - offsetof(range_chunk_t, data));
+            v->io->reads++;
+            if (reqs[j].res == (long)reqs[j].len) {
+                chunk_link(v->io, c);
+                continue;
+            }
+            free(c);
+            if (!busy[owner[j]]) continue;
+            busy[owner[j]] = 0;
+            b[owner[j]].err = reqs[j].res < 0 ? (int)-reqs[j].res : ENOEXEC;
+            elf_view_close(v);
+        }
+    }
+
+    free(busy);
+    free(owner);
+    free(reqs);
+}
+
+void elf_view_io_stats(const elf_view_t *v, unsigned long *reads, uint64_t *bytes) {
+    *reads = v->io ? v->io->reads : 0;
+    *bytes = v->io ? v->io->bytes : 0;
+}
+
+void elf_view_close(elf_view_t *v) {
+    guard_del(v);
+    if (v->map) {
+        munmap((void *)v->map, v->size);
+    }
+    if (v->io) {
+        for (range_chunk_t *c = v->io->chunks, *next; c; c = next) {
+            next = c->next;
+            free(c);
+        }
+        free(v->io);
+        v->io = NULL;
+    }
+    if (v->owns_fd && v->fd >= 0) {
+        close(v->fd);
+    }
+    v->map = NULL;
+    v->fd = -1;
+}
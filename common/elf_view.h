@@ -0,0 +1,179 @@
+/*
+ * elf_view.h - Single-pass ELF file view shared by the scanners
+ *
+ * rpath_scanner, got_inspector and dt_needed_explorer all need the same
+ * pieces of a file: the ELF header, the program headers, the dynamic
+ * segment, .dynstr and (for display) the section headers. Instead of
+ * each analysis opening and mapping the file again, elf_view_open()
+ * maps it once and indexes everything up front:
+ *
+ *   ┌──────────────┐     ┌──────────────────────────────────────────┐
+ *   │ open + fstat │ ──→ │ elf_view_t                               │
+ *   │ mmap (once)  │     │   ehdr, phdr[], PT_DYNAMIC/GNU_RELRO/... │
+ *   └──────────────┘     │   dyn_val[] (tag → value table)          │
+ *                        │   dynstr, shdr[] (bounds only)           │
+ *                        └──────────────────────────────────────────┘
+ *                             │        │         │          │
+ *                           RPATH   NEEDED     RELRO       GOT
+ *
+ * Nothing in the index needs the section header table, which usually
+ * sits at the very end of the file: it is only read when a caller asks
+ * for a section by name, so an analysis that works from PT_DYNAMIC
+ * touches just the first pages and the dynamic data they point to.
+ *
+ * A mapping still lets the kernel fault in (and read ahead) far more
+ * than that, and on a multi-GB binary with debug info or a network
+ * mount that is most of the cost. A ranged view maps nothing: it reads
+ * the pieces the index needs with pread() into private buffers, whole
+ * pages at a time and with readahead off, and any later elf_view_at()
+ * outside them reads just that range. elf_view_open_batch() opens many
+ * ranged views together, one read_batch (io_uring) submission per step:
+ *
+ *   round 1   ELF header page of every file       ─┐
+ *   round 2   program headers (if past that page)  │ one read_batch_run()
+ *   round 3   PT_DYNAMIC                           │ per round, all files
+ *   round 4   first page of .dynstr                │ in flight at once
+ *   round 5   NEEDED/SONAME/RPATH/RUNPATH strings ─┘
+ *
+ * Ranged views skip the section headers (shdr NULL, shnum 0); they are
+ * meant for analyses that work from PT_DYNAMIC.
+ *
+ * Nothing in the file is trusted: every offset, address and count goes
+ * through elf_view_at(), which checks it against the file size, and
+ * strings are only returned with their NUL inside the table. A mapped
+ * file that shrinks while it is read would raise SIGBUS on the pages
+ * past its new end; those pages are replaced with zeroes instead and
+ * the view is marked, so a long scan survives a file being rewritten
+ * under it (see elf_view_truncated()).
+ *
+ * Only 64-bit ELF is supported, matching the rest of the tools.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef ELF_VIEW_H
+#define ELF_VIEW_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <elf.h>
+#include <sys/stat.h>
+
+#include "read_batch.h"
+
+/*
+ * Dynamic tags below DT_NUM are stored at their own index; the handful
+ * of OS-specific tags the tools care about get the slots after that.
+ */
+#define ELF_VIEW_DT_EXTRA   8
+#define ELF_VIEW_DT_SLOTS   (DT_NUM + ELF_VIEW_DT_EXTRA)
+
+typedef struct {
+    const char        *path;
+    int                fd;
+    int                owns_fd;
+    struct stat        st;
+    const uint8_t     *map;             /* NULL for a ranged view */
+    int                guard;           /* SIGBUS guard slot + 1, 0 if unguarded */
+    size_t             size;
+    struct elf_view_io *io;             /* ranged view: the pieces read so far */
+
+    /* Headers */
+    const Elf64_Ehdr  *ehdr;
+    const Elf64_Phdr  *phdr;
+    int                phnum;
+
+    /* Program headers of interest (NULL if absent) */
+    const Elf64_Phdr  *pt_dynamic;
+    const Elf64_Phdr  *pt_interp;
+    const Elf64_Phdr  *pt_gnu_relro;
+    const Elf64_Phdr  *pt_gnu_stack;
+
+    /* Dynamic segment, up to (not including) DT_NULL */
+    const Elf64_Dyn   *dynamic;
+    size_t             dyn_count;
+    uint64_t           dyn_val[ELF_VIEW_DT_SLOTS];
+    uint64_t           dyn_seen;        /* bit per slot present */
+    int                needed_count;
+
+    /*
+     * .dynstr located through DT_STRTAB/DT_STRSZ. A ranged view holds
+     * only its first page; read strings through elf_view_dynstr().
+     */
+    const char        *dynstr;
+    size_t             dynstr_size;
+    uint64_t           dynstr_off;
+
+    /* Section headers (NULL/0 if stripped); not read until needed */
+    const Elf64_Shdr  *shdr;
+    int                shnum;
+} elf_view_t;
+
+/* Map and index a file. Returns 0, or -1 with errno set (ENOEXEC = not ELF64). */
+int elf_view_open(elf_view_t *v, const char *path);
+/* Same, on a descriptor the caller already holds (and keeps ownership of) */
+int elf_view_open_fd(elf_view_t *v, int fd, const char *path);
+void elf_view_close(elf_view_t *v);
+
+/*
+ * Ranged view on a descriptor the caller keeps: no mapping, only the
+ * needed pieces are read. Sets POSIX_FADV_RANDOM on fd.
+ */
+int elf_view_open_ranged(elf_view_t *v, int fd, const char *path);
+
+/* One file of elf_view_open_batch() */
+typedef struct {
+    int          fd;            /* in: open read-only; the caller keeps it */
+    const char  *path;          /* in */
+    elf_view_t   view;          /* out: a ranged view when err == 0 */
+    int          err;           /* out: 0, or errno as elf_view_open_fd() sets it */
+    int          is_elf;        /* out: the file starts with the ELF magic */
+} elf_view_batch_t;
+
+/*
+ * Open n ranged views at once, reading through rb. Every entry gets its
+ * err; the ones with err == 0 must be closed with elf_view_close(). A
+ * file that still needs pieces after the batched rounds (a string over
+ * many pages) is finished with plain pread() rather than failed.
+ */
+void elf_view_open_batch(elf_view_batch_t *b, size_t n, read_batch_t *rb);
+
+/* Reads issued and bytes held by a ranged view (0 for a mapped one) */
+void elf_view_io_stats(const elf_view_t *v, unsigned long *reads, uint64_t *bytes);
+
+/*
+ * Nonzero if the file was truncated under a mapped view since it was
+ * opened: the pages past the new end read as zeroes, so whatever was
+ * read from them is not the file's. Opening fails with EIO when the
+ * index itself hit such a page. Only the thread that opened the view
+ * is guarded, so read a mapped view on that thread.
+ */
+int elf_view_truncated(const elf_view_t *v);
+
+/* Dynamic tag table */
+int elf_view_has(const elf_view_t *v, int64_t tag);
+uint64_t elf_view_dyn(const elf_view_t *v, int64_t tag);
+
+/*
+ * Bounds-checked pointers into the file: by offset, or by virtual
+ * address (the whole range within the file bytes of one PT_LOAD)
+ */
+const void *elf_view_at(const elf_view_t *v, uint64_t off, uint64_t len);
+int elf_view_vaddr_to_off(const elf_view_t *v, uint64_t vaddr, uint64_t *off);
+const void *elf_view_vaddr(const elf_view_t *v, uint64_t vaddr, uint64_t len);
+
+/* String at a .dynstr offset, or NULL if out of range or unterminated */
+const char *elf_view_dynstr(const elf_view_t *v, uint64_t off);
+
+/* Section lookup by name (NULL if absent or no section headers); for display */
+const Elf64_Shdr *elf_view_section(const elf_view_t *v, const char *name);
+
+/*
+ * Dynamic symbol table through DT_SYMTAB. The count comes from DT_HASH,
+ * else DT_GNU_HASH and the table that follows .dynsym, else the
+ * SHT_DYNSYM section header.
+ * NULL (count 0) if absent or out of bounds.
+ */
+const Elf64_Sym *elf_view_dynsym(const elf_view_t *v, size_t *count);
+
+#endif /* ELF_VIEW_H */
@@ -0,0 +1,440 @@
+/*
+ * fs_walk.c - Parallel filesystem walker for the scanners
+ *
+ * See fs_walk.h. Every directory, and every FILE_BATCH files of a
+ * large one, is a task in a work-stealing pool (task_pool.h), so the
+ * getdents64/openat work and the callbacks run fully in parallel
+ * without a shared lock.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <elf.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "fs_walk.h"
+#include "task_pool.h"
+
+_Static_assert(FS_WALK_MAX_THREADS == TASK_POOL_MAX_THREADS, "worker index bound");
+
+#define DENTS_BUF_SIZE  (64 * 1024)
+#define FILE_BATCH      FS_WALK_BATCH   /* files per stealable task */
+#define MAX_SHARED_DIRS 256         /* directories held open for batches in flight */
+
+struct linux_dirent64 {
+    uint64_t       d_ino;
+    int64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[];
+};
+
+/* A directory being walked; it stays open until the last batch of its files is done */
+typedef struct {
+    int   fd;
+    char *path;
+    int   refs;
+    int   shared;           /* counted in shared_dirs */
+} walk_dir_t;
+
+/* Up to FILE_BATCH names from one directory, handed to whichever worker takes it */
+typedef struct {
+    walk_dir_t   *dir;
+    int           count;
+    size_t        used;
+    uint16_t      name_off[FILE_BATCH];
+    char          names[FILE_BATCH * (NAME_MAX + 1)];
+} file_batch_t;
+
+/* Per-worker state, on its own cache lines */
+typedef struct {
+    fs_walk_stats_t stats;
+    char           *dents;          /* getdents64 buffer */
+    int             dents_busy;     /* in use further up this worker's stack */
+} __attribute__((aligned(64))) walk_worker_t;
+
+typedef struct {
+    const fs_walk_opts_t *opts;
+    task_pool_t           pool;         /* tasks find their walk_state_t through this */
+    walk_worker_t        *workers;
+    int                   shared_dirs;  /* directories with batches in flight */
+} walk_state_t;
+
+/* Pseudo filesystems that never contain anything worth scanning */
+static const char *pruned_dirs[] = { "/proc", "/sys", "/dev", "/run", NULL };
+
+int fs_walk_default_threads(void) {
+    return task_pool_default_threads();
+}
+
+static walk_state_t *walk_of(task_pool_t *pool) {
+    return (walk_state_t *)((char *)pool - offsetof(walk_state_t, pool));
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * FILES
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static char *join_path(const char *dir, const char *name) {
+    size_t dl = strlen(dir), nl = strlen(name);
+    int slash = dl > 0 && dir[dl - 1] != '/';
+    char *p = malloc(dl + slash + nl + 1);
+    if (!p) return NULL;
+    memcpy(p, dir, dl);
+    if (slash) p[dl] = '/';
+    memcpy(p + dl + slash, name, nl + 1);
+    return p;
+}
+
+static int is_pruned(const char *path) {
+    for (int i = 0; pruned_dirs[i]; i++) {
+        if (strcmp(path, pruned_dirs[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+/*
+ * The entry may have been replaced since getdents64: O_NONBLOCK keeps a
+ * FIFO swapped in from blocking the open, and anything that is no
+ * longer a regular file is skipped before it is read.
+ */
+static int open_file(int dirfd, const char *name, fs_walk_stats_t *local) {
+    struct stat st;
+    int fd = openat(dirfd, name, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NOFOLLOW | O_NONBLOCK);
+    if (fd < 0) {
+        local->errors++;
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void visit_batch(walk_state_t *w, int worker, int dirfd, const char *dir,
+                        const char *const *names, int count) {
+    const fs_walk_opts_t *o = w->opts;
+    fs_walk_stats_t *local = &w->workers[worker].stats;
+    fs_walk_file_t files[FILE_BATCH];
+    int n = 0;
+
+    for (int i = 0; i < count; i++) {
+        local->files++;
+        int fd = open_file(dirfd, names[i], local);
+        if (fd < 0) continue;
+        char *path = join_path(dir, names[i]);
+        if (!path) {
+            close(fd);
+            continue;
+        }
+        files[n].path = path;
+        files[n++].fd = fd;
+    }
+
+    if (n > 0) {
+        local->matched += n;
+        o->batch_fn(worker, files, n, o->arg);
+    }
+    for (int i = 0; i < n; i++) {
+        close(files[i].fd);
+        free((char *)files[i].path);
+    }
+}
+
+static void visit_file(walk_state_t *w, int worker, int dirfd, const char *dir,
+                       const char *name) {
+    const fs_walk_opts_t *o = w->opts;
+    fs_walk_stats_t *local = &w->workers[worker].stats;
+
+    if (o->batch_fn) {
+        visit_batch(w, worker, dirfd, dir, &name, 1);
+        return;
+    }
+
+    local->files++;
+
+    int fd = open_file(dirfd, name, local);
+    if (fd < 0) return;
+
+    if (o->elf_only) {
+        unsigned char magic[SELFMAG];
+        if (pread(fd, magic, SELFMAG, 0) != SELFMAG ||
+            memcmp(magic, ELFMAG, SELFMAG) != 0) {
+            close(fd);
+            return;
+        }
+    }
+
+    char *path = join_path(dir, name);
+    if (path) {
+        local->matched++;
+        o->fn(path, fd, o->arg);
+        free(path);
+    }
+    close(fd);
+}
+
+static void dir_release(walk_state_t *w, walk_dir_t *d) {
+    if (__atomic_sub_fetch(&d->refs, 1, __ATOMIC_ACQ_REL) > 0) return;
+    if (d->shared) __atomic_fetch_sub(&w->shared_dirs, 1, __ATOMIC_RELAXED);
+    close(d->fd);
+    free(d->path);
+    free(d);
+}
+
+static void run_batch(task_pool_t *pool, int worker, void *arg) {
+    walk_state_t *w = walk_of(pool);
+    file_batch_t *b = arg;
+
+    if (w->opts->batch_fn) {
+        const char *names[FILE_BATCH];
+        for (int i = 0; i < b->count; i++) {
+            names[i] = b->names + b->name_off[i];
+        }
+        visit_batch(w, worker, b->dir->fd, b->dir->path, names, b->count);
+    } else {
+        for (int i = 0; i < b->count; i++) {
+            visit_file(w, worker, b->dir->fd, b->dir->path, b->names + b->name_off[i]);
+        }
+    }
+    dir_release(w, b->dir);
+    free(b);
+}
+
+/*
+ * Let another worker take a full batch. Past MAX_SHARED_DIRS open
+ * directories, or with the deque full, the batch runs right here.
+ */
+static void hand_off(task_pool_t *pool, int worker, file_batch_t *b) {
+    walk_state_t *w = walk_of(pool);
+    walk_dir_t *d = b->dir;
+
+    if (!d->shared) {
+        if (__atomic_load_n(&w->shared_dirs, __ATOMIC_RELAXED) >= MAX_SHARED_DIRS) {
+            run_batch(pool, worker, b);
+            return;
+        }
+        d->shared = 1;
+        __atomic_fetch_add(&w->shared_dirs, 1, __ATOMIC_RELAXED);
+    }
+    if (task_spawn(pool, worker, run_batch, b) < 0) {
+        run_batch(pool, worker, b);
+    }
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * DIRECTORIES
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/*
+ * A directory still to be walked. Below the roots it is opened relative
+ * to its parent with O_NOFOLLOW, so a symlink swapped in after getdents64
+ * is not followed; the parent stays open until then.
+ */
+typedef struct {
+    walk_dir_t *parent;         /* NULL for a root */
+    char       *path;
+    const char *name;           /* within path */
+} dir_task_t;
+
+static void run_dir(task_pool_t *pool, int worker, void *arg);
+
+static dir_task_t *dir_task_new(walk_dir_t *parent, char *path, const char *name) {
+    dir_task_t *t = malloc(sizeof(*t));
+    if (!t) return NULL;
+    if (parent) __atomic_fetch_add(&parent->refs, 1, __ATOMIC_RELAXED);
+    t->parent = parent;
+    t->path = path;
+    t->name = name;
+    return t;
+}
+
+static void spawn_dir(task_pool_t *pool, int worker, dir_task_t *t) {
+    if (task_spawn(pool, worker, run_dir, t) < 0) {
+        run_dir(pool, worker, t);
+    }
+}
+
+static void add_file(task_pool_t *pool, int worker, walk_dir_t *dir,
+                     file_batch_t **batch, const char *name) {
+    walk_state_t *w = walk_of(pool);
+    file_batch_t *b = *batch;
+
+    if (!b) {
+        b = malloc(sizeof(*b));
+        if (!b) {
+            visit_file(w, worker, dir->fd, dir->path, name);
+            return;
+        }
+        __atomic_fetch_add(&dir->refs, 1, __ATOMIC_RELAXED);
+        b->dir = dir;
+        b->count = 0;
+        b->used = 0;
+        *batch = b;
+    }
+
+    size_t len = strlen(name) + 1;
+    b->name_off[b->count++] = b->used;
+    memcpy(b->names + b->used, name, len);
+    b->used += len;
+
+    if (b->count == FILE_BATCH) {
+        *batch = NULL;
+        hand_off(pool, worker, b);
+    }
+}
+
+static void run_dir(task_pool_t *pool, int worker, void *arg) {
+    walk_state_t *w = walk_of(pool);
+    walk_worker_t *me = &w->workers[worker];
+    fs_walk_stats_t *local = &me->stats;
+    dir_task_t *t = arg;
+    char *path = t->path;
+
+    int dirfd;
+    if (t->parent) {
+        dirfd = openat(t->parent->fd, t->name, O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+        dir_release(w, t->parent);
+    } else {
+        dirfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+    free(t);
+
+    walk_dir_t *dir = dirfd < 0 ? NULL : malloc(sizeof(*dir));
+    if (!dir) {
+        local->errors++;
+        if (dirfd >= 0) close(dirfd);
+        free(path);
+        return;
+    }
+    dir->fd = dirfd;
+    dir->path = path;
+    dir->refs = 1;
+    dir->shared = 0;
+    local->dirs++;
+
+    /* A subdirectory run inline (full deque) must not reuse our buffer */
+    char *buf = me->dents_busy ? NULL : me->dents;
+    if (!buf) {
+        buf = malloc(DENTS_BUF_SIZE);
+        if (!me->dents_busy) me->dents = buf;
+    }
+    int own_buf = buf != me->dents;
+    if (!own_buf) me->dents_busy = 1;
+
+    file_batch_t *batch = NULL;
+    for (;;) {
+        long n = buf ? syscall(SYS_getdents64, dirfd, buf, DENTS_BUF_SIZE) : -1;
+        if (n <= 0) {
+            if (n < 0) local->errors++;
+            break;
+        }
+
+        for (long pos = 0; pos < n; ) {
+            struct linux_dirent64 *de = (struct linux_dirent64 *)(buf + pos);
+            pos += de->d_reclen;
+
+            const char *name = de->d_name;
+            if (name[0] == '.' &&
+                (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+
+            unsigned char type = de->d_type;
+            if (type == DT_UNKNOWN) {
+                /* Some filesystems don't fill d_type; only then pay for a stat */
+                struct stat st;
+                if (fstatat(dirfd, name, &st, AT_SYMLINK_NOFOLLOW) < 0) {
+                    local->errors++;
+                    continue;
+                }
+                type = S_ISDIR(st.st_mode) ? DT_DIR :
+                       S_ISREG(st.st_mode) ? DT_REG : DT_LNK;
+            }
+
+            if (type == DT_DIR) {
+                char *sub = join_path(path, name);
+                dir_task_t *st = NULL;
+                if (sub && !is_pruned(sub)) {
+                    st = dir_task_new(dir, sub, sub + strlen(sub) - strlen(name));
+                }
+                if (st) {
+                    spawn_dir(pool, worker, st);
+                } else {
+                    free(sub);
+                }
+            } else if (type == DT_REG) {
+                add_file(pool, worker, dir, &batch, name);
+            }
+        }
+    }
+
+    if (own_buf) {
+        free(buf);
+    } else {
+        me->dents_busy = 0;
+    }
+
+    /* The last partial batch is ours to finish */
+    if (batch) run_batch(pool, worker, batch);
+    dir_release(w, dir);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * ENTRY POINT
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int fs_walk(const fs_walk_opts_t *opts, fs_walk_stats_t *stats) {
+    walk_state_t w;
+    memset(&w, 0, sizeof(w));
+    w.opts = opts;
+    if (stats) memset(stats, 0, sizeof(*stats));
+
+    if (task_pool_init(&w.pool, opts->nthreads) < 0) return -1;
+    if (posix_memalign((void **)&w.workers, 64, w.pool.nworkers * sizeof(*w.workers)) != 0) {
+        task_pool_destroy(&w.pool);
+        errno = ENOMEM;
+        return -1;
+    }
+    memset(w.workers, 0, w.pool.nworkers * sizeof(*w.workers));
+
+    unsigned long lost = 0;
+    for (int i = 0; i < opts->nroots; i++) {
+        char *root = strdup(opts->roots[i]);
+        dir_task_t *t = root ? dir_task_new(NULL, root, root) : NULL;
+        if (!t || task_pool_submit(&w.pool, run_dir, t) < 0) {
+            free(root);
+            free(t);
+            lost++;
+        }
+    }
+
+    task_pool_run(&w.pool);
+
+    fs_walk_stats_t total = { .errors = lost };
+    for (int i = 0; i < w.pool.nworkers; i++) {
+        total.dirs += w.workers[i].stats.dirs;
+        total.files += w.workers[i].stats.files;
+        total.matched += w.workers[i].stats.matched;
+        total.errors += w.workers[i].stats.errors;
+        free(w.workers[i].dents);
+    }
+    free(w.workers);
+    task_pool_destroy(&w.pool);
+
+    if (stats) *stats = total;
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * fs_walk.h - Parallel filesystem walker for the scanners
+ *
+ * Walks one or more directory trees on a pool of threads using
+ * openat() + getdents64(). The d_type reported by the kernel decides
+ * what each entry is, so no path stat() is issued per entry (only for
+ * the rare DT_UNKNOWN); an opened file gets one fstat() to make sure it
+ * is still a regular file. Regular files can be filtered down to ELF
+ * objects by reading just their 4-byte magic before the callback runs.
+ *
+ * The walk is a pipeline of tasks on a work-stealing pool (task_pool.h):
+ *
+ *   walk     directory task: getdents64, spawns a task per subdirectory
+ *      │     and one per 64 regular files
+ *      ▼
+ *   read     file batch task: openat + 4-byte magic check
+ *      ▼
+ *   parse, check, emit
+ *            the callback, on the same worker while the file is hot
+ *
+ * With a batch callback the walker only opens the files of a batch and
+ * hands them over together, so their reads can be in flight at once
+ * (see read_batch.h) instead of one blocking pread() after another.
+ *
+ * Every task lands on its producer's bounded deque and idle workers
+ * steal the oldest ones, so a directory with thousands of files is
+ * spread over all workers instead of being walked by one. A full deque
+ * makes the producer run the task itself, which throttles the walk to
+ * the speed of the callbacks.
+ *
+ * Symlinks are never followed below the roots, so loops and duplicate
+ * visits through /lib → /usr/lib style links cannot happen. Everything
+ * below a root is opened relative to its directory with O_NOFOLLOW, so
+ * this holds even for entries swapped for a symlink mid-walk, and files
+ * are opened O_NONBLOCK so a FIFO swapped in cannot stall a worker.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef FS_WALK_H
+#define FS_WALK_H
+
+#include <stddef.h>
+
+/*
+ * Called once per matching file, possibly from several threads at once.
+ * fd is open read-only on the file and is closed by the walker after
+ * the callback returns.
+ */
+typedef void (*fs_walk_fn)(const char *path, int fd, void *arg);
+
+#define FS_WALK_BATCH       64          /* most files handed to one batch callback */
+#define FS_WALK_MAX_THREADS 256         /* bound on the worker index */
+
+typedef struct {
+    const char *path;
+    int         fd;             /* open read-only; closed by the walker */
+} fs_walk_file_t;
+
+/*
+ * Alternative to fs_walk_fn: up to FS_WALK_BATCH files of one directory
+ * at once. worker is the calling thread's index (below the thread count
+ * and FS_WALK_MAX_THREADS), for per-thread state such as a read_batch_t.
+ * elf_only is not applied: the callback reads the header anyway, and a
+ * blocking magic check per file is the round trip batching avoids.
+ */
+typedef void (*fs_walk_batch_fn)(int worker, const fs_walk_file_t *files, int n, void *arg);
+
+typedef struct {
+    const char **roots;
+    int          nroots;
+    int          nthreads;      /* <= 0: one per online CPU */
+    int          elf_only;      /* skip files without the ELF magic */
+    fs_walk_fn   fn;
+    fs_walk_batch_fn batch_fn;  /* used instead of fn when set */
+    void        *arg;
+} fs_walk_opts_t;
+
+typedef struct {
+    unsigned long dirs;
+    unsigned long files;        /* regular files seen */
+    unsigned long matched;      /* files passed to the callback */
+    unsigned long errors;       /* directories/files that could not be opened */
+} fs_walk_stats_t;
+
+/*
+ * Walks every root to completion; falls back to the calling thread if no
+ * worker starts. Returns 0, or -1 if the pool cannot be set up.
+ */
+int fs_walk(const fs_walk_opts_t *opts, fs_walk_stats_t *stats);
+
+/* Default thread count used when opts->nthreads <= 0 */
+int fs_walk_default_threads(void);
+
+#endif /* FS_WALK_H */
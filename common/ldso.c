@@ -0,0 +1,759 @@
+/*
+ * ldso.c - ld.so library search emulation
+ *
+ * See ldso.h for the search order being emulated.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ldso.h"
+
+#define LDSO_CACHE_FILE     "/etc/ld.so.cache"
+
+/* Separators inside a search key; neither can appear in a path from ELF */
+#define KEY_DIR_SEP         '\x1f'
+#define KEY_SONAME_SEP      '\x1e'
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * STRING TABLE (chained hash, key/value stored inline)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct ldso_entry {
+    struct ldso_entry *next;
+    uint64_t           hash;
+    int32_t            aux;         /* source, cache flags, probe verdict */
+    uint64_t           aux2;        /* cache hwcap */
+    const char        *value;       /* points into data[], or NULL */
+    char               data[];      /* key\0value\0 */
+} ldso_entry_t;
+
+struct ldso_table {
+    ldso_entry_t **buckets;
+    size_t         nbuckets;
+    size_t         count;
+};
+
+static uint64_t str_hash(const char *s) {
+    /* FNV-1a */
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*s) {
+        h = (h ^ (unsigned char)*s++) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static ldso_table_t *table_new(void) {
+    ldso_table_t *t = calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    t->nbuckets = 256;
+    t->buckets = calloc(t->nbuckets, sizeof(*t->buckets));
+    if (!t->buckets) {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+static void table_free(ldso_table_t *t) {
+    if (!t) return;
+    for (size_t b = 0; b < t->nbuckets; b++) {
+        ldso_entry_t *e = t->buckets[b];
+        while (e) {
+            ldso_entry_t *next = e->next;
+            free(e);
+            e = next;
+        }
+    }
+    free(t->buckets);
+    free(t);
+}
+
+static ldso_entry_t *table_find(const ldso_table_t *t, uint64_t hash, const char *key) {
+    for (ldso_entry_t *e = t->buckets[hash & (t->nbuckets - 1)]; e; e = e->next) {
+        if (e->hash == hash && strcmp(e->data, key) == 0) return e;
+    }
+    return NULL;
+}
+
+static ldso_entry_t *table_add(ldso_table_t *t, uint64_t hash, const char *key,
+                               const char *value, int32_t aux, uint64_t aux2) {
+    if (t->count >= t->nbuckets) {
+        size_t nb = t->nbuckets * 2;
+        ldso_entry_t **buckets = calloc(nb, sizeof(*buckets));
+        if (buckets) {
+            for (size_t b = 0; b < t->nbuckets; b++) {
+                ldso_entry_t *e = t->buckets[b];
+                while (e) {
+                    ldso_entry_t *next = e->next;
+                    e->next = buckets[e->hash & (nb - 1)];
+                    buckets[e->hash & (nb - 1)] = e;
+                    e = next;
+                }
+            }
+            free(t->buckets);
+            t->buckets = buckets;
+            t->nbuckets = nb;
+        }
+    }
+
+    size_t klen = strlen(key) + 1;
+    size_t vlen = value ? strlen(value) + 1 : 0;
+    ldso_entry_t *e = malloc(sizeof(*e) + klen + vlen);
+    if (!e) return NULL;
+
+    e->hash = hash;
+    e->aux = aux;
+    e->aux2 = aux2;
+    memcpy(e->data, key, klen);
+    e->value = NULL;
+    if (value) {
+        memcpy(e->data + klen, value, vlen);
+        e->value = e->data + klen;
+    }
+
+    /* Append, so entries with equal keys keep their insertion order */
+    ldso_entry_t **slot = &t->buckets[hash & (t->nbuckets - 1)];
+    while (*slot) slot = &(*slot)->next;
+    e->next = NULL;
+    *slot = e;
+    t->count++;
+    return e;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * MACHINE DETAILS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* ld.so.cache flag values (glibc sysdeps/generic/ldconfig.h) */
+#define FLAG_ELF_LIBC6          0x0003
+#define FLAG_SPARC_LIB64        0x0100
+#define FLAG_X8664_LIB64        0x0300
+#define FLAG_S390_LIB64         0x0400
+#define FLAG_POWERPC_LIB64      0x0500
+#define FLAG_MIPS64_LIBN64      0x0700
+#define FLAG_AARCH64_LIB64      0x0a00
+#define FLAG_RISCV_FLOAT_DOUBLE 0x1000
+
+typedef struct {
+    uint16_t    machine;
+    int32_t     cache_flags;
+    const char *triplet;        /* Debian multiarch directory name */
+    const char *platform;       /* $PLATFORM */
+} machine_info_t;
+
+static const machine_info_t machines[] = {
+    { EM_X86_64,  FLAG_X8664_LIB64 | FLAG_ELF_LIBC6,        "x86_64-linux-gnu",      "x86_64"  },
+    { EM_AARCH64, FLAG_AARCH64_LIB64 | FLAG_ELF_LIBC6,      "aarch64-linux-gnu",     "aarch64" },
+    { EM_PPC64,   FLAG_POWERPC_LIB64 | FLAG_ELF_LIBC6,      "powerpc64le-linux-gnu", "ppc64le" },
+    { EM_S390,    FLAG_S390_LIB64 | FLAG_ELF_LIBC6,         "s390x-linux-gnu",       "s390x"   },
+    { EM_RISCV,   FLAG_RISCV_FLOAT_DOUBLE | FLAG_ELF_LIBC6, "riscv64-linux-gnu",     "riscv64" },
+    { EM_MIPS,    FLAG_MIPS64_LIBN64 | FLAG_ELF_LIBC6,      "mips64el-linux-gnuabi64", "mips64" },
+    { EM_SPARCV9, FLAG_SPARC_LIB64 | FLAG_ELF_LIBC6,        "sparc64-linux-gnu",     "sparc64" },
+};
+
+static const machine_info_t *machine_info(uint16_t machine) {
+    for (size_t i = 0; i < sizeof(machines) / sizeof(machines[0]); i++) {
+        if (machines[i].machine == machine) return &machines[i];
+    }
+    return &machines[0];
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * LD.SO.CACHE PARSER
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+#define CACHEMAGIC          "ld.so-1.7.0"
+#define CACHEMAGIC_NEW      "glibc-ld.so.cache"
+#define CACHE_VERSION_NEW   "1.1"
+
+struct file_entry_old {
+    int32_t  flags;
+    uint32_t key, value;
+};
+
+struct cache_file_old {
+    char     magic[sizeof(CACHEMAGIC) - 1];
+    uint32_t nlibs;
+};
+
+struct file_entry_new {
+    int32_t  flags;
+    uint32_t key, value;
+    uint32_t osversion_unused;
+    uint64_t hwcap;
+};
+
+struct cache_file_new {
+    char     magic[sizeof(CACHEMAGIC_NEW) - 1];
+    char     version[sizeof(CACHE_VERSION_NEW) - 1];
+    uint32_t nlibs;
+    uint32_t len_strings;
+    uint8_t  flags;
+    uint8_t  padding_unused[3];
+    uint32_t extension_offset;
+    uint32_t unused[3];
+};
+
+static int load_cache(ldso_ctx_t *ctx, const char *file) {
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    ctx->cache_st = st;         /* even if it is unusable: no retry until it changes */
+    if (st.st_size < (off_t)sizeof(struct cache_file_new)) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    ctx->cache_map = map;
+    ctx->cache_size = st.st_size;
+
+    /* Old libc5 table first? The new-format table follows it, 8-aligned */
+    size_t off = 0;
+    const struct cache_file_old *old = map;
+    if (memcmp(old->magic, CACHEMAGIC, sizeof(old->magic)) == 0) {
+        off = sizeof(*old) + (size_t)old->nlibs * sizeof(struct file_entry_old);
+        off = (off + 7) & ~(size_t)7;
+    }
+
+    if (off > ctx->cache_size ||
+        ctx->cache_size - off < sizeof(struct cache_file_new)) {
+        return -1;
+    }
+
+    const struct cache_file_new *hdr = (const void *)(ctx->cache_map + off);
+    if (memcmp(hdr->magic, CACHEMAGIC_NEW, sizeof(hdr->magic)) != 0 ||
+        memcmp(hdr->version, CACHE_VERSION_NEW, sizeof(hdr->version)) != 0) {
+        return -1;
+    }
+
+    size_t avail = ctx->cache_size - off;
+    if (hdr->nlibs > (avail - sizeof(*hdr)) / sizeof(struct file_entry_new)) {
+        return -1;
+    }
+
+    /* String offsets are relative to the start of the new-format table */
+    const char *base = (const char *)hdr;
+    const struct file_entry_new *libs = (const void *)(hdr + 1);
+
+    ctx->cache_index = table_new();
+    if (!ctx->cache_index) return -1;
+
+    for (uint32_t i = 0; i < hdr->nlibs; i++) {
+        const struct file_entry_new *e = &libs[i];
+        if (e->key >= avail || e->value >= avail ||
+            !memchr(base + e->key, '\0', avail - e->key) ||
+            !memchr(base + e->value, '\0', avail - e->value)) {
+            continue;
+        }
+        const char *soname = base + e->key;
+        table_add(ctx->cache_index, str_hash(soname), soname,
+                  base + e->value, e->flags, e->hwcap);
+        ctx->cache_entries++;
+    }
+
+    return 0;
+}
+
+static void unload_cache(ldso_ctx_t *ctx) {
+    table_free(ctx->cache_index);
+    if (ctx->cache_map) munmap((void *)ctx->cache_map, ctx->cache_size);
+    ctx->cache_index = NULL;
+    ctx->cache_map = NULL;
+    ctx->cache_size = ctx->cache_entries = 0;
+    memset(&ctx->cache_st, 0, sizeof(ctx->cache_st));
+}
+
+/* Has ldconfig replaced or rewritten the cache since load_cache()? */
+static int cache_changed(const ldso_ctx_t *ctx) {
+    const struct stat *old = &ctx->cache_st;
+    struct stat st;
+
+    if (stat(ctx->cache_file, &st) < 0) return old->st_ino != 0;
+    return st.st_dev != old->st_dev || st.st_ino != old->st_ino ||
+           st.st_size != old->st_size ||
+           st.st_mtim.tv_sec != old->st_mtim.tv_sec ||
+           st.st_mtim.tv_nsec != old->st_mtim.tv_nsec;
+}
+
+const char *ldso_cache_lookup(ldso_ctx_t *ctx, const char *soname, uint16_t machine) {
+    if (!ctx->cache_index) return NULL;
+
+    int32_t want = machine_info(machine)->cache_flags;
+    uint64_t hash = str_hash(soname);
+    const char *fallback = NULL;
+
+    /* Prefer the baseline entry over glibc-hwcaps subdirectory entries */
+    for (ldso_entry_t *e = ctx->cache_index->buckets[hash & (ctx->cache_index->nbuckets - 1)];
+         e; e = e->next) {
+        if (e->hash != hash || e->aux != want || strcmp(e->data, soname) != 0) continue;
+        if (e->aux2 == 0) return e->value;
+        if (!fallback) fallback = e->value;
+    }
+    return fallback;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * INIT / DESTROY
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static char *default_dirs_for_host(void) {
+    const machine_info_t *mi = machine_info(EM_X86_64);
+#if defined(__aarch64__)
+    mi = machine_info(EM_AARCH64);
+#elif defined(__powerpc64__)
+    mi = machine_info(EM_PPC64);
+#elif defined(__s390x__)
+    mi = machine_info(EM_S390);
+#elif defined(__riscv)
+    mi = machine_info(EM_RISCV);
+#endif
+
+    /* Debian-style multiarch dirs first, then the upstream lib64 pair */
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "/lib/%s:/usr/lib/%s:/lib64:/usr/lib64:/lib:/usr/lib",
+             mi->triplet, mi->triplet);
+
+    /* Keep only directories that exist (and aren't links to ones we have) */
+    char out[512] = "";
+    dev_t devs[8];
+    ino_t inos[8];
+    int n = 0;
+    char *save = NULL;
+    for (char *d = strtok_r(buf, ":", &save); d; d = strtok_r(NULL, ":", &save)) {
+        struct stat st;
+        if (stat(d, &st) < 0 || !S_ISDIR(st.st_mode)) continue;
+        int dup = 0;
+        for (int i = 0; i < n; i++) {
+            if (devs[i] == st.st_dev && inos[i] == st.st_ino) dup = 1;
+        }
+        if (dup || n == 8) continue;
+        devs[n] = st.st_dev;
+        inos[n] = st.st_ino;
+        n++;
+        if (out[0]) strcat(out, ":");
+        strcat(out, d);
+    }
+    return strdup(out);
+}
+
+int ldso_init(ldso_ctx_t *ctx, const ldso_opts_t *opts) {
+    memset(ctx, 0, sizeof(*ctx));
+    pthread_mutex_init(&ctx->lock, NULL);
+
+    if (opts && opts->ld_library_path && opts->ld_library_path[0]) {
+        ctx->ld_library_path = strdup(opts->ld_library_path);
+    }
+    ctx->default_dirs = (opts && opts->default_dirs) ?
+        strdup(opts->default_dirs) : default_dirs_for_host();
+    ctx->cache_file = strdup((opts && opts->cache_file) ? opts->cache_file : LDSO_CACHE_FILE);
+
+    ctx->resolved = table_new();
+    ctx->probed = table_new();
+    if (!ctx->default_dirs || !ctx->cache_file || !ctx->resolved || !ctx->probed) {
+        ldso_destroy(ctx);
+        return -1;
+    }
+
+    /* A missing cache is not fatal: ld.so just falls back to the defaults */
+    load_cache(ctx, ctx->cache_file);
+    return 0;
+}
+
+void ldso_destroy(ldso_ctx_t *ctx) {
+    unload_cache(ctx);
+    table_free(ctx->resolved);
+    table_free(ctx->probed);
+    free(ctx->cache_file);
+    free(ctx->ld_library_path);
+    free(ctx->default_dirs);
+    pthread_mutex_destroy(&ctx->lock);
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+int ldso_reset(ldso_ctx_t *ctx) {
+    ldso_table_t *resolved = table_new();
+    ldso_table_t *probed = table_new();
+    if (!resolved || !probed) {
+        table_free(resolved);
+        table_free(probed);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    /* After an ldconfig the old mapping is of an unlinked file */
+    if (cache_changed(ctx)) {
+        ldso_ctx_t fresh = { .cache_file = ctx->cache_file };
+        errno = 0;              /* a bad or missing file is no cache, as at init */
+        if (load_cache(&fresh, fresh.cache_file) < 0 && errno == ENOMEM) {
+            unload_cache(&fresh);
+            table_free(resolved);
+            table_free(probed);
+            errno = ENOMEM;
+            return -1;
+        }
+        unload_cache(ctx);
+        ctx->cache_st = fresh.cache_st;
+        ctx->cache_map = fresh.cache_map;
+        ctx->cache_size = fresh.cache_size;
+        ctx->cache_index = fresh.cache_index;
+        ctx->cache_entries = fresh.cache_entries;
+    }
+
+    table_free(ctx->resolved);
+    table_free(ctx->probed);
+    ctx->resolved = resolved;
+    ctx->probed = probed;
+    ctx->memo_hits = ctx->memo_misses = 0;
+    return 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * OBJECTS AND SEARCH KEYS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+void ldso_object_from_view(ldso_object_t *o, const elf_view_t *v,
+                           const ldso_object_t *loader) {
+    memset(o, 0, sizeof(*o));
+    o->path = v->path;
+    o->machine = v->ehdr->e_machine;
+    o->loader = loader;
+    o->nodeflib = (elf_view_dyn(v, DT_FLAGS_1) & DF_1_NODEFLIB) != 0;
+    o->secure = loader ? loader->secure :
+                (v->st.st_mode & (S_ISUID | S_ISGID)) != 0;
+    if (elf_view_has(v, DT_RPATH)) {
+        o->rpath = elf_view_dynstr(v, elf_view_dyn(v, DT_RPATH));
+    }
+    if (elf_view_has(v, DT_RUNPATH)) {
+        o->runpath = elf_view_dynstr(v, elf_view_dyn(v, DT_RUNPATH));
+    }
+}
+
+void ldso_object_release(ldso_object_t *o) {
+    free(o->search_key);
+    o->search_key = NULL;
+}
+
+typedef struct {
+    char  *buf;
+    size_t len;
+    size_t cap;
+} strbuf_t;
+
+static void sb_putn(strbuf_t *sb, const char *s, size_t n) {
+    if (sb->len + n + 1 > sb->cap) {
+        size_t cap = sb->cap ? sb->cap : 256;
+        while (cap < sb->len + n + 1) cap *= 2;
+        char *buf = realloc(sb->buf, cap);
+        if (!buf) return;
+        sb->buf = buf;
+        sb->cap = cap;
+    }
+    memcpy(sb->buf + sb->len, s, n);
+    sb->len += n;
+    sb->buf[sb->len] = '\0';
+}
+
+static void sb_puts(strbuf_t *sb, const char *s) {
+    sb_putn(sb, s, strlen(s));
+}
+
+static void sb_putc(strbuf_t *sb, char c) {
+    sb_putn(sb, &c, 1);
+}
+
+/* Directory containing the object, symlinks resolved, for $ORIGIN */
+static void object_origin(const ldso_object_t *o, char *out, size_t outsz) {
+    char real[PATH_MAX];
+    const char *p = realpath(o->path, real) ? real : o->path;
+    const char *slash = strrchr(p, '/');
+
+    if (!slash) {
+        snprintf(out, outsz, ".");
+    } else if (slash == p) {
+        snprintf(out, outsz, "/");
+    } else {
+        snprintf(out, outsz, "%.*s", (int)(slash - p), p);
+    }
+}
+
+/* Does the name at s match a DST ("$NAME" or "${NAME}")? Returns its length. */
+static size_t dst_len(const char *s, const char *name) {
+    size_t n = strlen(name);
+    if (s[0] != '$') return 0;
+    if (s[1] == '{') {
+        return (strncmp(s + 2, name, n) == 0 && s[2 + n] == '}') ? n + 3 : 0;
+    }
+    if (strncmp(s + 1, name, n) != 0) return 0;
+    char c = s[1 + n];
+    return (c == '_' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+            (c >= '0' && c <= '9')) ? 0 : n + 1;
+}
+
+/* Append each expanded component of a colon list, tagged with its source */
+static void add_path_list(strbuf_t *sb, const char *list, char tag,
+                          const ldso_object_t *owner) {
+    const machine_info_t *mi = machine_info(owner ? owner->machine : EM_X86_64);
+    char origin[PATH_MAX] = "";
+
+    for (const char *p = list; ; ) {
+        const char *end = strchr(p, ':');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        if (sb->len) sb_putc(sb, KEY_DIR_SEP);
+        sb_putc(sb, tag);
+
+        if (len == 0) {
+            sb_putc(sb, '.');       /* empty component = current directory */
+        }
+        for (size_t i = 0; i < len; ) {
+            size_t n;
+            if (owner && (n = dst_len(p + i, "ORIGIN"))) {
+                if (!origin[0]) object_origin(owner, origin, sizeof(origin));
+                sb_puts(sb, origin);
+            } else if ((n = dst_len(p + i, "LIB"))) {
+                /* Debian builds ld.so with $LIB = lib/<triplet> */
+                char lib[128];
+                snprintf(lib, sizeof(lib), "/lib/%s", mi->triplet);
+                struct stat st;
+                sb_puts(sb, stat(lib, &st) == 0 ? lib + 1 : "lib64");
+            } else if ((n = dst_len(p + i, "PLATFORM"))) {
+                sb_puts(sb, mi->platform);
+            } else {
+                n = 1;
+                sb_putc(sb, p[i]);
+            }
+            i += n;
+        }
+
+        if (!end) break;
+        p = end + 1;
+    }
+}
+
+static const char *search_key(ldso_ctx_t *ctx, ldso_object_t *obj) {
+    if (obj->search_key) return obj->search_key;
+
+    strbuf_t sb = {0};
+    const ldso_object_t *root = obj;
+    while (root->loader) root = root->loader;
+
+    /* Fixed header: machine + nodeflib, since both change the answer */
+    char head[32];
+    snprintf(head, sizeof(head), "M%u%s", obj->machine, obj->nodeflib ? "N" : "");
+    sb_puts(&sb, head);
+
+    /* DT_RPATH of the loader chain, unless the loader uses DT_RUNPATH */
+    if (!obj->runpath) {
+        for (const ldso_object_t *o = obj; o; o = o->loader) {
+            if (o->rpath && !o->runpath) add_path_list(&sb, o->rpath, 'R', o);
+        }
+    }
+    if (ctx->ld_library_path && !root->secure) {
+        add_path_list(&sb, ctx->ld_library_path, 'L', NULL);
+    }
+    if (obj->runpath) {
+        add_path_list(&sb, obj->runpath, 'U', obj);
+    }
+
+    obj->search_key = sb.buf ? sb.buf : strdup("");
+    return obj->search_key;
+}
+
+static ldso_source_t tag_source(char tag) {
+    switch (tag) {
+        case 'R': return LDSO_RPATH;
+        case 'L': return LDSO_LD_LIBRARY_PATH;
+        case 'U': return LDSO_RUNPATH;
+        default:  return LDSO_DEFAULT;
+    }
+}
+
+void ldso_search_dirs(ldso_ctx_t *ctx, const ldso_object_t *obj,
+                      ldso_dir_fn fn, void *arg) {
+    ldso_object_t tmp = *obj;
+    tmp.search_key = NULL;
+    const char *key = obj->search_key ? obj->search_key : search_key(ctx, &tmp);
+
+    const char *p = strchr(key, KEY_DIR_SEP);
+    while (p) {
+        const char *end = strchr(p + 1, KEY_DIR_SEP);
+        size_t len = end ? (size_t)(end - p - 2) : strlen(p + 2);
+        char dir[PATH_MAX];
+        snprintf(dir, sizeof(dir), "%.*s", (int)len, p + 2);
+        fn(dir, tag_source(p[1]), arg);
+        p = end;
+    }
+
+    if (!obj->nodeflib) {
+        fn(LDSO_CACHE_FILE, LDSO_CACHE, arg);
+        char *copy = strdup(ctx->default_dirs), *save = NULL;
+        for (char *d = copy ? strtok_r(copy, ":", &save) : NULL; d;
+             d = strtok_r(NULL, ":", &save)) {
+            fn(d, LDSO_DEFAULT, arg);
+        }
+        free(copy);
+    }
+
+    if (tmp.search_key) ldso_object_release(&tmp);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RESOLUTION
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Would ld.so accept this file for an object of this machine? (memoized) */
+static int probe(ldso_ctx_t *ctx, const char *path, uint16_t machine) {
+    char key[PATH_MAX + 16];
+    snprintf(key, sizeof(key), "%s%c%u", path, KEY_SONAME_SEP, machine);
+    uint64_t hash = str_hash(key);
+
+    pthread_mutex_lock(&ctx->lock);
+    ldso_entry_t *e = table_find(ctx->probed, hash, key);
+    int ok = e ? e->aux : -1;
+    pthread_mutex_unlock(&ctx->lock);
+    if (ok >= 0) return ok;
+
+    ok = 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        Elf64_Ehdr eh;
+        if (pread(fd, &eh, sizeof(eh), 0) == (ssize_t)sizeof(eh) &&
+            memcmp(eh.e_ident, ELFMAG, SELFMAG) == 0 &&
+            eh.e_ident[EI_CLASS] == ELFCLASS64 &&
+            eh.e_type == ET_DYN &&
+            (machine == 0 || eh.e_machine == machine)) {
+            ok = 1;
+        }
+        close(fd);
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    if (!table_find(ctx->probed, hash, key)) {
+        table_add(ctx->probed, hash, key, NULL, ok, 0);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    return ok;
+}
+
+static int try_dir(ldso_ctx_t *ctx, const char *dir, size_t dirlen,
+                   const char *soname, uint16_t machine, char *out) {
+    while (dirlen > 1 && dir[dirlen - 1] == '/') dirlen--;
+    int n = snprintf(out, PATH_MAX, "%.*s/%s", (int)dirlen, dir, soname);
+    return n > 0 && n < PATH_MAX && probe(ctx, out, machine);
+}
+
+static ldso_source_t search(ldso_ctx_t *ctx, const char *key, const ldso_object_t *obj,
+                            const char *soname, char *out) {
+    /* Explicit directories from the key */
+    for (const char *p = strchr(key, KEY_DIR_SEP); p; ) {
+        const char *end = strchr(p + 1, KEY_DIR_SEP);
+        size_t len = end ? (size_t)(end - p - 2) : strlen(p + 2);
+        if (try_dir(ctx, p + 2, len, soname, obj->machine, out)) {
+            return tag_source(p[1]);
+        }
+        p = end;
+    }
+
+    if (obj->nodeflib) return LDSO_NOT_FOUND;
+
+    const char *cached = ldso_cache_lookup(ctx, soname, obj->machine);
+    if (cached && probe(ctx, cached, obj->machine)) {
+        snprintf(out, PATH_MAX, "%s", cached);
+        return LDSO_CACHE;
+    }
+
+    for (const char *p = ctx->default_dirs; p && *p; ) {
+        const char *end = strchr(p, ':');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len && try_dir(ctx, p, len, soname, obj->machine, out)) {
+            return LDSO_DEFAULT;
+        }
+        p = end ? end + 1 : NULL;
+    }
+
+    return LDSO_NOT_FOUND;
+}
+
+int ldso_resolve(ldso_ctx_t *ctx, ldso_object_t *obj, const char *soname,
+                 ldso_result_t *res) {
+    const char *key = search_key(ctx, obj);
+
+    strbuf_t memo = {0};
+    if (strchr(soname, '/')) {
+        /* Paths bypass the search entirely */
+        sb_puts(&memo, "/");
+    } else {
+        sb_puts(&memo, key);
+    }
+    sb_putc(&memo, KEY_SONAME_SEP);
+    sb_puts(&memo, soname);
+    if (!memo.buf) return -1;
+
+    uint64_t hash = str_hash(memo.buf);
+
+    pthread_mutex_lock(&ctx->lock);
+    ldso_entry_t *e = table_find(ctx->resolved, hash, memo.buf);
+    pthread_mutex_unlock(&ctx->lock);
+
+    if (e) {
+        __atomic_fetch_add(&ctx->memo_hits, 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_add(&ctx->memo_misses, 1, __ATOMIC_RELAXED);
+
+        char path[PATH_MAX];
+        ldso_source_t src;
+        if (strchr(soname, '/')) {
+            snprintf(path, sizeof(path), "%s", soname);
+            src = probe(ctx, path, obj->machine) ? LDSO_DIRECT : LDSO_NOT_FOUND;
+        } else {
+            src = search(ctx, key, obj, soname, path);
+        }
+
+        pthread_mutex_lock(&ctx->lock);
+        e = table_find(ctx->resolved, hash, memo.buf);
+        if (!e) {
+            e = table_add(ctx->resolved, hash, memo.buf,
+                          src != LDSO_NOT_FOUND ? path : NULL, src, 0);
+        }
+        pthread_mutex_unlock(&ctx->lock);
+    }
+    free(memo.buf);
+
+    if (!e) return -1;
+    res->path = e->value;
+    res->source = (ldso_source_t)e->aux;
+    return res->source == LDSO_NOT_FOUND ? -1 : 0;
+}
+
+const char *ldso_source_name(ldso_source_t source) {
+    switch (source) {
+        case LDSO_DIRECT:           return "path";
+        case LDSO_RPATH:            return "DT_RPATH";
+        case LDSO_LD_LIBRARY_PATH:  return "LD_LIBRARY_PATH";
+        case LDSO_RUNPATH:          return "DT_RUNPATH";
+        case LDSO_CACHE:            return "ld.so.cache";
+        case LDSO_DEFAULT:          return "default path";
+        case LDSO_LOADED:           return "already loaded";
+        default:                    return "not found";
+    }
+}
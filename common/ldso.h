@@ -0,0 +1,132 @@
+/*
+ * ldso.h - ld.so library search emulation
+ *
+ * Resolves a DT_NEEDED soname to the exact file the dynamic linker
+ * would load, without running ldd or the binary itself. The search
+ * follows glibc's _dl_map_object():
+ *
+ *   1. soname containing '/'      → used as-is
+ *   2. DT_RPATH of the loader, then of each object up the loader chain
+ *      and of the executable     (skipped if the loader has DT_RUNPATH)
+ *   3. LD_LIBRARY_PATH           (ignored for setuid/setgid binaries)
+ *   4. DT_RUNPATH of the loader  (the loader only, never inherited)
+ *   5. /etc/ld.so.cache          (skipped with DF_1_NODEFLIB)
+ *   6. default system dirs       (skipped with DF_1_NODEFLIB)
+ *
+ * $ORIGIN, $LIB and $PLATFORM are expanded per object. A candidate
+ * only counts if it is an ELF file of the loader's class and machine,
+ * as ld.so silently skips anything else.
+ *
+ * ld.so.cache is parsed directly (new "glibc-ld.so.cache1.1" format,
+ * alone or after the old libc5 table) into an in-memory hash index.
+ * Results are memoized per (expanded search-path list, soname), so the
+ * thousands of binaries that share a search list share the work.
+ * Every function here is thread-safe.
+ *
+ * Not emulated: glibc-hwcaps/legacy hwcap subdirectories and
+ * LD_PRELOAD/LD_AUDIT (objects that are not part of DT_NEEDED).
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef LDSO_H
+#define LDSO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "elf_view.h"
+
+typedef enum {
+    LDSO_NOT_FOUND = 0,
+    LDSO_DIRECT,            /* soname contained a '/' */
+    LDSO_RPATH,
+    LDSO_LD_LIBRARY_PATH,
+    LDSO_RUNPATH,
+    LDSO_CACHE,
+    LDSO_DEFAULT,
+    LDSO_LOADED             /* matched an already-loaded soname (set by callers) */
+} ldso_source_t;
+
+/* One object taking part in a load: the thing whose DT_NEEDED we resolve */
+typedef struct ldso_object {
+    const char *path;           /* file path, for $ORIGIN */
+    const char *rpath;          /* raw DT_RPATH, or NULL */
+    const char *runpath;        /* raw DT_RUNPATH, or NULL */
+    uint16_t    machine;        /* e_machine; candidates must match */
+    int         nodeflib;       /* DF_1_NODEFLIB */
+    int         secure;         /* setuid/setgid: LD_LIBRARY_PATH ignored */
+    const struct ldso_object *loader;   /* who loaded us (NULL = executable) */
+
+    /* Filled on first use by ldso_resolve() */
+    char       *search_key;
+} ldso_object_t;
+
+typedef struct {
+    const char     *path;       /* owned by the context, NULL if not found */
+    ldso_source_t   source;
+} ldso_result_t;
+
+typedef struct {
+    const char *ld_library_path;    /* NULL: no LD_LIBRARY_PATH */
+    const char *cache_file;         /* NULL: /etc/ld.so.cache */
+    const char *default_dirs;       /* NULL: built-in list for the machine */
+} ldso_opts_t;
+
+typedef struct ldso_table ldso_table_t;
+
+typedef struct {
+    char           *ld_library_path;
+    char           *default_dirs;
+
+    /* ld.so.cache index: soname → entries */
+    char           *cache_file;
+    struct stat     cache_st;       /* the file as loaded; st_ino 0: there was none */
+    const uint8_t  *cache_map;
+    size_t          cache_size;
+    ldso_table_t   *cache_index;
+    size_t          cache_entries;
+
+    /* Memo tables */
+    pthread_mutex_t lock;
+    ldso_table_t   *resolved;       /* search key + soname → result */
+    ldso_table_t   *probed;         /* candidate path + machine → usable? */
+
+    unsigned long   memo_hits;
+    unsigned long   memo_misses;
+} ldso_ctx_t;
+
+int ldso_init(ldso_ctx_t *ctx, const ldso_opts_t *opts);
+void ldso_destroy(ldso_ctx_t *ctx);
+
+/*
+ * Forget every memoized resolution and probe, e.g. after packages
+ * changed. ld.so.cache is reloaded if ldconfig has replaced or rewritten
+ * it since it was loaded (device, inode, size or mtime differ), and kept
+ * otherwise. No other call may be in flight, and result paths handed
+ * out earlier become invalid. Returns 0, or -1 (ENOMEM) with the memo
+ * and the cache left as they were.
+ */
+int ldso_reset(ldso_ctx_t *ctx);
+
+/* Describe an object from its view (strings point into the view) */
+void ldso_object_from_view(ldso_object_t *o, const elf_view_t *v,
+                           const ldso_object_t *loader);
+void ldso_object_release(ldso_object_t *o);
+
+/* Resolve one soname needed by obj. Returns 0 if found, -1 if not. */
+int ldso_resolve(ldso_ctx_t *ctx, ldso_object_t *obj, const char *soname,
+                 ldso_result_t *res);
+
+/* Expanded search directories for obj, in order, for display */
+typedef void (*ldso_dir_fn)(const char *dir, ldso_source_t source, void *arg);
+void ldso_search_dirs(ldso_ctx_t *ctx, const ldso_object_t *obj,
+                      ldso_dir_fn fn, void *arg);
+
+/* Look a soname up in ld.so.cache only */
+const char *ldso_cache_lookup(ldso_ctx_t *ctx, const char *soname, uint16_t machine);
+
+const char *ldso_source_name(ldso_source_t source);
+
+#endif /* LDSO_H */
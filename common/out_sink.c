@@ -0,0 +1,669 @@
+/*
+ * out_sink.c - Machine-readable output for the scanners
+ *
+ * See out_sink.h for the record formats.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "out_sink.h"
+
+#define FLUSH_AT        (64 * 1024)     /* streaming: hand a buffer to writev() past this */
+#define RUN_AT          (32 * 1024 * 1024)  /* ordered: spill a sorted run past this */
+#define IOV_BATCH       1024            /* IOV_MAX on Linux */
+
+typedef struct {
+    size_t key_off;                     /* ordered mode: NUL-terminated sort key */
+    size_t off;
+    size_t len;
+} rec_index_t;
+
+struct out_writer {
+    out_writer_t *next;
+
+    char         *buf;
+    size_t        len;
+    size_t        cap;
+
+    rec_index_t  *recs;
+    size_t        nrecs;
+    size_t        cap_recs;
+
+    size_t        rec_start;
+    size_t        key_off;
+    int           oom;
+
+    FILE        **runs;                 /* ordered: sorted runs spilled to temp files */
+    size_t        nruns;
+    int           no_spill;             /* no temp file could be made: keep it all */
+};
+
+static unsigned long next_sink_id = 1;
+static __thread out_writer_t *tls_writer;
+static __thread unsigned long tls_sink_id;
+
+int out_format_parse(const char *name, out_format_t *format) {
+    if (strcmp(name, "text") == 0) *format = OUT_TEXT;
+    else if (strcmp(name, "jsonl") == 0 || strcmp(name, "json") == 0) *format = OUT_JSONL;
+    else if (strcmp(name, "binary") == 0) *format = OUT_BINARY;
+    else return -1;
+    return 0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RAW OUTPUT
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static int writev_all(int fd, struct iovec *iov, int n) {
+    while (n > 0) {
+        ssize_t r = writev(fd, iov, n);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (n > 0 && (size_t)r >= iov->iov_len) {
+            r -= iov->iov_len;
+            iov++;
+            n--;
+        }
+        if (n > 0) {
+            iov->iov_base = (char *)iov->iov_base + r;
+            iov->iov_len -= r;
+        }
+    }
+    return 0;
+}
+
+static void note_error(out_sink_t *s) {
+    if (!s->error) s->error = errno ? errno : EIO;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * PER-THREAD WRITERS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static out_writer_t *get_writer(out_sink_t *s) {
+    if (tls_sink_id == s->id) return tls_writer;
+
+    out_writer_t *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+
+    pthread_mutex_lock(&s->lock);
+    w->next = s->writers;
+    s->writers = w;
+    pthread_mutex_unlock(&s->lock);
+
+    tls_writer = w;
+    tls_sink_id = s->id;
+    return w;
+}
+
+static int reserve(out_writer_t *w, size_t n) {
+    if (w->oom) return -1;
+    if (w->len + n > w->cap) {
+        size_t cap = w->cap ? w->cap : 8192;
+        while (cap < w->len + n) cap *= 2;
+        char *buf = realloc(w->buf, cap);
+        if (!buf) {
+            w->oom = 1;
+            return -1;
+        }
+        w->buf = buf;
+        w->cap = cap;
+    }
+    return 0;
+}
+
+static void put(out_writer_t *w, const void *p, size_t n) {
+    if (reserve(w, n) == 0) {
+        memcpy(w->buf + w->len, p, n);
+        w->len += n;
+    }
+}
+
+static void put_u8(out_writer_t *w, uint8_t v) {
+    put(w, &v, 1);
+}
+
+static void put_u32(out_writer_t *w, uint32_t v) {
+    put(w, &v, sizeof(v));
+}
+
+static void put_lstr(out_writer_t *w, const char *s) {
+    size_t n = strlen(s);
+    put_u32(w, (uint32_t)n);
+    put(w, s, n);
+}
+
+/* Length of the well-formed UTF-8 sequence at s (lead byte >= 0x80), or 0 */
+static int utf8_len(const unsigned char *s) {
+    int n;
+    unsigned char lo = 0x80, hi = 0xbf;     /* bounds for the second byte */
+
+    if (s[0] >= 0xc2 && s[0] <= 0xdf) n = 2;
+    else if (s[0] >= 0xe0 && s[0] <= 0xef) n = 3;
+    else if (s[0] >= 0xf0 && s[0] <= 0xf4) n = 4;
+    else return 0;
+
+    if (s[0] == 0xe0) lo = 0xa0;            /* overlong */
+    if (s[0] == 0xed) hi = 0x9f;            /* surrogates */
+    if (s[0] == 0xf0) lo = 0x90;            /* overlong */
+    if (s[0] == 0xf4) hi = 0x8f;            /* past U+10FFFF */
+
+    if (s[1] < lo || s[1] > hi) return 0;
+    for (int i = 2; i < n; i++) {
+        if (s[i] < 0x80 || s[i] > 0xbf) return 0;
+    }
+    return n;
+}
+
+/*
+ * Paths are bytes, not text. Well-formed UTF-8 is copied; any other byte
+ * b becomes the lone surrogate \udcXX (Python's "surrogateescape"), so
+ * the line stays valid JSON and the original bytes can be recovered.
+ */
+static void put_json_str(out_writer_t *w, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+
+    if (reserve(w, strlen(s) * 6 + 2) < 0) return;
+    char *p = w->buf + w->len;
+    *p++ = '"';
+    while (*s) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            *p++ = '\\';
+            *p++ = c;
+        } else if (c < 0x20) {
+            memcpy(p, "\\u00", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 15];
+            p += 6;
+        } else if (c >= 0x80) {
+            int n = utf8_len((const unsigned char *)s);
+            if (n) {
+                memcpy(p, s, n);
+                p += n;
+                s += n;
+                continue;
+            }
+            memcpy(p, "\\udc", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 15];
+            p += 6;
+        } else {
+            *p++ = c;
+        }
+        s++;
+    }
+    *p++ = '"';
+    w->len = p - w->buf;
+}
+
+/* Field header: `,"name":` or kind + name */
+static void put_name(out_sink_t *s, out_writer_t *w, int kind, const char *name) {
+    if (s->format == OUT_JSONL) {
+        put(w, ",", 1);
+        put_json_str(w, name);
+        put(w, ":", 1);
+    } else {
+        size_t n = strlen(name);
+        if (n > 255) n = 255;
+        put_u8(w, (uint8_t)kind);
+        put_u8(w, (uint8_t)n);
+        put(w, name, n);
+    }
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RECORDS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+void out_begin(out_sink_t *s, const char *type, const char *key) {
+    out_writer_t *w = get_writer(s);
+    if (!w) return;
+
+    if (s->ordered) {
+        w->key_off = w->len;
+        put(w, key ? key : "", strlen(key ? key : "") + 1);
+    }
+    w->rec_start = w->len;
+
+    if (s->format == OUT_JSONL) {
+        put(w, "{\"type\":", 8);
+        put_json_str(w, type);
+    } else {
+        size_t n = strlen(type);
+        if (n > 255) n = 255;
+        put_u32(w, 0);                  /* patched by out_end() */
+        put_u8(w, (uint8_t)n);
+        put(w, type, n);
+    }
+}
+
+void out_str(out_sink_t *s, const char *name, const char *value) {
+    out_writer_t *w = get_writer(s);
+    if (!w) return;
+
+    put_name(s, w, value ? OUT_KIND_STR : OUT_KIND_NULL, name);
+    if (s->format == OUT_JSONL) {
+        if (value) put_json_str(w, value);
+        else put(w, "null", 4);
+    } else if (value) {
+        put_lstr(w, value);
+    }
+}
+
+void out_int(out_sink_t *s, const char *name, int64_t value) {
+    out_writer_t *w = get_writer(s);
+    if (!w) return;
+
+    put_name(s, w, OUT_KIND_INT, name);
+    if (s->format == OUT_JSONL) {
+        char num[24];
+        int n = snprintf(num, sizeof(num), "%lld", (long long)value);
+        put(w, num, n);
+    } else {
+        put(w, &value, sizeof(value));
+    }
+}
+
+void out_bool(out_sink_t *s, const char *name, int value) {
+    out_writer_t *w = get_writer(s);
+    if (!w) return;
+
+    put_name(s, w, OUT_KIND_BOOL, name);
+    if (s->format == OUT_JSONL) {
+        if (value) put(w, "true", 4);
+        else put(w, "false", 5);
+    } else {
+        put_u8(w, value ? 1 : 0);
+    }
+}
+
+void out_strv(out_sink_t *s, const char *name, const char *const *values, size_t n) {
+    out_writer_t *w = get_writer(s);
+    if (!w) return;
+
+    put_name(s, w, OUT_KIND_STRV, name);
+    if (s->format == OUT_JSONL) {
+        put(w, "[", 1);
+        for (size_t i = 0; i < n; i++) {
+            if (i) put(w, ",", 1);
+            put_json_str(w, values[i]);
+        }
+        put(w, "]", 1);
+    } else {
+        put_u32(w, (uint32_t)n);
+        for (size_t i = 0; i < n; i++) put_lstr(w, values[i]);
+    }
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * ORDERING
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    const out_writer_t *w;
+    const rec_index_t  *r;
+} rec_ref_t;
+
+/* By key, then by content, so equal keys still come out the same way every run */
+static int cmp_key_rec(const char *xk, const char *x, size_t xlen,
+                       const char *yk, const char *y, size_t ylen) {
+    int c = strcmp(xk, yk);
+    if (c) return c;
+
+    c = memcmp(x, y, xlen < ylen ? xlen : ylen);
+    if (c) return c;
+    return (xlen > ylen) - (xlen < ylen);
+}
+
+static int cmp_rec(const void *a, const void *b) {
+    const rec_ref_t *x = a, *y = b;
+    return cmp_key_rec(x->w->buf + x->r->key_off, x->w->buf + x->r->off, x->r->len,
+                       y->w->buf + y->r->key_off, y->w->buf + y->r->off, y->r->len);
+}
+
+/* Every buffered record, sorted; NULL (and *n = 0) if there are none */
+static rec_ref_t *sorted_refs(out_writer_t *const *ws, size_t nws, size_t *n) {
+    size_t total = 0;
+    for (size_t i = 0; i < nws; i++) total += ws[i]->nrecs;
+
+    *n = 0;
+    rec_ref_t *refs = malloc((total ? total : 1) * sizeof(*refs));
+    if (!refs) return NULL;
+    for (size_t i = 0; i < nws; i++) {
+        for (size_t r = 0; r < ws[i]->nrecs; r++) refs[(*n)++] = (rec_ref_t){ ws[i], &ws[i]->recs[r] };
+    }
+    qsort(refs, *n, sizeof(*refs), cmp_rec);
+    return refs;
+}
+
+/* Run entry: u32 key_len, key with its NUL, u32 len, record */
+static int run_put(FILE *f, const char *key, const char *rec, uint32_t len) {
+    uint32_t klen = strlen(key) + 1;
+    return fwrite(&klen, sizeof(klen), 1, f) == 1 && fwrite(key, klen, 1, f) == 1 &&
+           fwrite(&len, sizeof(len), 1, f) == 1 && (!len || fwrite(rec, len, 1, f) == 1) ? 0 : -1;
+}
+
+/*
+ * Past RUN_AT bytes a writer sorts what it holds into a run in an
+ * unlinked temp file and starts over, so an ordered sink needs memory
+ * for RUN_AT per thread, not for the whole scan. If no temp file can be
+ * made the records just stay in memory.
+ */
+static void spill_run(out_sink_t *s, out_writer_t *w) {
+    size_t n;
+    rec_ref_t *refs = sorted_refs(&w, 1, &n);
+    FILE **runs = refs ? realloc(w->runs, (w->nruns + 1) * sizeof(*runs)) : NULL;
+    FILE *f = runs ? tmpfile() : NULL;
+    if (runs) w->runs = runs;
+    if (!f) {
+        w->no_spill = 1;
+        free(refs);
+        return;
+    }
+
+    int ok = 1;
+    for (size_t i = 0; ok && i < n; i++) {
+        ok = run_put(f, w->buf + refs[i].r->key_off, w->buf + refs[i].r->off,
+                     (uint32_t)refs[i].r->len) == 0;
+    }
+    if (!ok || fflush(f) != 0) {
+        pthread_mutex_lock(&s->lock);
+        note_error(s);
+        pthread_mutex_unlock(&s->lock);
+    }
+    free(refs);
+
+    w->runs[w->nruns++] = f;
+    w->len = 0;
+    w->nrecs = 0;
+}
+
+static void flush_writer(out_sink_t *s, out_writer_t *w) {
+    struct iovec iov = { w->buf, w->len };
+
+    pthread_mutex_lock(&s->lock);
+    if (writev_all(s->fd, &iov, 1) < 0) note_error(s);
+    pthread_mutex_unlock(&s->lock);
+    w->len = 0;
+}
+
+void out_end(out_sink_t *s) {
+    out_writer_t *w = get_writer(s);
+    if (!w) return;
+
+    if (s->format == OUT_JSONL) {
+        put(w, "}\n", 2);
+    } else if (!w->oom) {
+        uint32_t len = (uint32_t)(w->len - w->rec_start - sizeof(uint32_t));
+        memcpy(w->buf + w->rec_start, &len, sizeof(len));
+    }
+    if (w->oom) return;
+
+    __atomic_fetch_add(&s->records, 1, __ATOMIC_RELAXED);
+
+    if (!s->ordered) {
+        if (w->len >= FLUSH_AT) flush_writer(s, w);
+        return;
+    }
+
+    if (w->nrecs == w->cap_recs) {
+        size_t cap = w->cap_recs ? w->cap_recs * 2 : 256;
+        rec_index_t *recs = realloc(w->recs, cap * sizeof(*recs));
+        if (!recs) {
+            w->oom = 1;
+            return;
+        }
+        w->recs = recs;
+        w->cap_recs = cap;
+    }
+    w->recs[w->nrecs++] = (rec_index_t){ w->key_off, w->rec_start, w->len - w->rec_start };
+    if (w->len >= RUN_AT && !w->no_spill) spill_run(s, w);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * OPEN / CLOSE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+int out_sink_open(out_sink_t *s, int fd, out_format_t format, int ordered) {
+    memset(s, 0, sizeof(*s));
+    s->fd = fd;
+    s->format = format;
+    s->ordered = ordered;
+    s->id = __atomic_fetch_add(&next_sink_id, 1, __ATOMIC_RELAXED);
+    pthread_mutex_init(&s->lock, NULL);
+
+    if (format == OUT_BINARY) {
+        struct iovec iov = { (void *)OUT_BINARY_MAGIC, sizeof(OUT_BINARY_MAGIC) - 1 };
+        if (writev_all(fd, &iov, 1) < 0) return -1;
+    }
+    return 0;
+}
+
+/* Everything buffered in memory, sorted, straight from the buffers */
+static void write_sorted(out_sink_t *s, const rec_ref_t *refs, size_t n) {
+    /* Consecutive records that sit back to back in one buffer share an iovec */
+    struct iovec iov[IOV_BATCH];
+    int niov = 0;
+    for (size_t i = 0; i < n && !s->error; i++) {
+        char *p = refs[i].w->buf + refs[i].r->off;
+        if (niov && (char *)iov[niov - 1].iov_base + iov[niov - 1].iov_len == p) {
+            iov[niov - 1].iov_len += refs[i].r->len;
+            continue;
+        }
+        if (niov == IOV_BATCH) {
+            if (writev_all(s->fd, iov, niov) < 0) note_error(s);
+            niov = 0;
+        }
+        iov[niov++] = (struct iovec){ p, refs[i].r->len };
+    }
+    if (niov && !s->error && writev_all(s->fd, iov, niov) < 0) note_error(s);
+}
+
+/* One input of the final merge: a spilled run, or the sorted in-memory rest */
+typedef struct {
+    FILE            *f;
+    char            *buf;           /* run: the current entry */
+    size_t           cap;
+    const rec_ref_t *refs;          /* memory */
+    size_t           i, n;
+
+    const char      *key;
+    const char      *rec;
+    size_t           len;
+} merge_src_t;
+
+/* Advance to the next entry; 0 when the source is used up */
+static int src_next(out_sink_t *s, merge_src_t *m) {
+    if (!m->f) {
+        if (m->i == m->n) return 0;
+        const rec_ref_t *r = &m->refs[m->i++];
+        m->key = r->w->buf + r->r->key_off;
+        m->rec = r->w->buf + r->r->off;
+        m->len = r->r->len;
+        return 1;
+    }
+
+    uint32_t klen, len;
+    if (fread(&klen, sizeof(klen), 1, m->f) != 1) {
+        if (ferror(m->f)) note_error(s);
+        return 0;
+    }
+    if (klen == 0) goto fail;
+    if (klen > m->cap) {
+        free(m->buf);
+        m->cap = klen > 4096 ? klen : 4096;
+        if (!(m->buf = malloc(m->cap))) goto fail;
+    }
+    if (fread(m->buf, klen, 1, m->f) != 1 || m->buf[klen - 1] != '\0' ||
+        fread(&len, sizeof(len), 1, m->f) != 1) {
+        goto fail;
+    }
+    if ((size_t)klen + len > m->cap) {
+        char *buf = realloc(m->buf, (size_t)klen + len);
+        if (!buf) goto fail;
+        m->buf = buf;
+        m->cap = (size_t)klen + len;
+    }
+    if (len && fread(m->buf + klen, len, 1, m->f) != 1) goto fail;
+    m->key = m->buf;
+    m->rec = m->buf + klen;
+    m->len = len;
+    return 1;
+
+fail:
+    if (!s->error) s->error = EIO;
+    return 0;
+}
+
+static int src_less(const merge_src_t *a, const merge_src_t *b) {
+    return cmp_key_rec(a->key, a->rec, a->len, b->key, b->rec, b->len) < 0;
+}
+
+static void heap_down(merge_src_t *m, size_t *heap, size_t n, size_t i) {
+    for (;;) {
+        size_t l = 2 * i + 1, min = i;
+        if (l < n && src_less(&m[heap[l]], &m[heap[min]])) min = l;
+        if (l + 1 < n && src_less(&m[heap[l + 1]], &m[heap[min]])) min = l + 1;
+        if (min == i) return;
+        size_t t = heap[i];
+        heap[i] = heap[min];
+        heap[min] = t;
+        i = min;
+    }
+}
+
+/* k-way merge of the spilled runs and the in-memory rest through one buffer */
+static void write_merged(out_sink_t *s, const rec_ref_t *refs, size_t nrefs, size_t nruns) {
+    merge_src_t *m = calloc(nruns + 1, sizeof(*m));
+    size_t *heap = malloc((nruns + 1) * sizeof(*heap));
+    char *out = malloc(FLUSH_AT);
+    size_t nsrc = 0, nheap = 0, used = 0;
+
+    if (!m || !heap || !out) {
+        note_error(s);
+        goto done;
+    }
+    for (out_writer_t *w = s->writers; w; w = w->next) {
+        for (size_t r = 0; r < w->nruns; r++) {
+            rewind(w->runs[r]);
+            m[nsrc++].f = w->runs[r];
+        }
+    }
+    m[nsrc].refs = refs;
+    m[nsrc++].n = nrefs;
+
+    for (size_t i = 0; i < nsrc; i++) {
+        if (src_next(s, &m[i])) heap[nheap++] = i;
+    }
+    for (size_t i = nheap; i-- > 0; ) heap_down(m, heap, nheap, i);
+
+    while (nheap && !s->error) {
+        merge_src_t *top = &m[heap[0]];
+        if (used + top->len > FLUSH_AT) {
+            struct iovec iov[2] = { { out, used }, { (void *)top->rec, top->len } };
+            int big = top->len > FLUSH_AT;
+            if (writev_all(s->fd, iov, big ? 2 : 1) < 0) note_error(s);
+            used = 0;
+            if (!big) {
+                memcpy(out, top->rec, top->len);
+                used = top->len;
+            }
+        } else {
+            memcpy(out + used, top->rec, top->len);
+            used += top->len;
+        }
+
+        if (!src_next(s, top)) heap[0] = heap[--nheap];
+        heap_down(m, heap, nheap, 0);
+    }
+    if (used && !s->error) {
+        struct iovec iov = { out, used };
+        if (writev_all(s->fd, &iov, 1) < 0) note_error(s);
+    }
+
+done:
+    for (size_t i = 0; m && i < nsrc; i++) free(m[i].buf);
+    free(m);
+    free(heap);
+    free(out);
+}
+
+static void write_ordered(out_sink_t *s) {
+    size_t nws = 0, nruns = 0;
+    for (out_writer_t *w = s->writers; w; w = w->next) {
+        nws++;
+        nruns += w->nruns;
+    }
+
+    out_writer_t **ws = malloc((nws ? nws : 1) * sizeof(*ws));
+    size_t n = 0;
+    rec_ref_t *refs = NULL;
+    if (ws) {
+        nws = 0;
+        for (out_writer_t *w = s->writers; w; w = w->next) ws[nws++] = w;
+        refs = sorted_refs(ws, nws, &n);
+        free(ws);
+    }
+    if (!refs) {
+        note_error(s);
+        return;
+    }
+
+    if (nruns) write_merged(s, refs, n, nruns);
+    else write_sorted(s, refs, n);
+    free(refs);
+}
+
+static void write_streamed(out_sink_t *s) {
+    struct iovec iov[IOV_BATCH];
+    int niov = 0;
+
+    for (out_writer_t *w = s->writers; w && !s->error; w = w->next) {
+        if (!w->len) continue;
+        if (niov == IOV_BATCH) {
+            if (writev_all(s->fd, iov, niov) < 0) note_error(s);
+            niov = 0;
+        }
+        iov[niov++] = (struct iovec){ w->buf, w->len };
+    }
+    if (niov && !s->error && writev_all(s->fd, iov, niov) < 0) note_error(s);
+}
+
+int out_sink_close(out_sink_t *s) {
+    int oom = 0;
+    for (out_writer_t *w = s->writers; w; w = w->next) oom |= w->oom;
+    if (oom && !s->error) s->error = ENOMEM;
+
+    if (s->ordered) write_ordered(s);
+    else write_streamed(s);
+
+    out_writer_t *w = s->writers;
+    while (w) {
+        out_writer_t *next = w->next;
+        free(w->buf);
+        free(w->recs);
+        for (size_t r = 0; r < w->nruns; r++) fclose(w->runs[r]);
+        free(w->runs);
+        free(w);
+        w = next;
+    }
+    s->writers = NULL;
+    pthread_mutex_destroy(&s->lock);
+
+    if (s->error) {
+        errno = s->error;
+        return -1;
+    }
+    return 0;
+}
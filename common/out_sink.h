@@ -0,0 +1,91 @@
+/*
+ * out_sink.h - Machine-readable output for the scanners
+ *
+ * The human reports are colored box-drawing text. Pipelines get flat
+ * records instead, in one of two encodings:
+ *
+ *   jsonl   one JSON object per line:
+ *             {"type":"binary","path":"/usr/bin/x","rpath":null,...}
+ *
+ *   binary  "ELFREC1\n", then length-prefixed records (little-endian):
+ *             u32 record_len                  bytes that follow
+ *             u8  type_len, type
+ *             fields...  u8 kind, u8 name_len, name, value
+ *               OUT_KIND_NULL   -
+ *               OUT_KIND_STR    u32 len, bytes
+ *               OUT_KIND_INT    i64
+ *               OUT_KIND_BOOL   u8
+ *               OUT_KIND_STRV   u32 count, count × (u32 len, bytes)
+ *
+ * Every thread appends whole records to its own buffer, so scan threads
+ * never contend while formatting. Buffers reach the fd through writev():
+ * as they fill (streaming), or all at once when the sink is closed
+ * (ordered). In ordered mode records are sorted by the key given to
+ * out_begin() (ties by content), so the output is byte-identical
+ * whatever the thread count or scheduling was. A thread holding more
+ * than 32 MiB of records sorts them into a run in an unlinked temp file,
+ * and closing merges the runs, so memory stays bounded on any scan size.
+ *
+ * JSON strings carry file names, which are bytes: well-formed UTF-8 is
+ * copied, and every other byte b is written as the lone surrogate \udcXX
+ * (Python's "surrogateescape"), keeping each line valid JSON.
+ *
+ * A record is built by one thread between out_begin() and out_end().
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef OUT_SINK_H
+#define OUT_SINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+typedef enum {
+    OUT_TEXT = 0,           /* no sink: the tools print their usual reports */
+    OUT_JSONL,
+    OUT_BINARY
+} out_format_t;
+
+enum {
+    OUT_KIND_NULL = 0,
+    OUT_KIND_STR,
+    OUT_KIND_INT,
+    OUT_KIND_BOOL,
+    OUT_KIND_STRV
+};
+
+#define OUT_BINARY_MAGIC    "ELFREC1\n"
+
+typedef struct out_writer out_writer_t;
+
+typedef struct {
+    int             fd;
+    out_format_t    format;
+    int             ordered;
+    unsigned long   id;             /* tells thread-local writers apart */
+
+    pthread_mutex_t lock;
+    out_writer_t   *writers;
+
+    unsigned long   records;
+    int             error;          /* a write failed; errno was saved here */
+} out_sink_t;
+
+/* "text", "jsonl", "binary"; returns -1 for anything else */
+int out_format_parse(const char *name, out_format_t *format);
+
+int out_sink_open(out_sink_t *s, int fd, out_format_t format, int ordered);
+
+/* Flush everything (sorted, if ordered) and free the buffers; -1 on write error */
+int out_sink_close(out_sink_t *s);
+
+void out_begin(out_sink_t *s, const char *type, const char *key);
+void out_str(out_sink_t *s, const char *name, const char *value);    /* NULL → null */
+void out_int(out_sink_t *s, const char *name, int64_t value);
+void out_bool(out_sink_t *s, const char *name, int value);
+void out_strv(out_sink_t *s, const char *name, const char *const *values, size_t n);
+void out_end(out_sink_t *s);
+
+#endif /* OUT_SINK_H */
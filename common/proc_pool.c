@@ -0,0 +1,278 @@
+/*
+ * proc_pool.c - Forked worker processes that parse files in isolation
+ *
+ * See proc_pool.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "proc_pool.h"
+
+#define WORKER_SOCK     3               /* the worker's end, after close_inherited() */
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * WORKER PROCESS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* One file per message: the path as data, the descriptor as SCM_RIGHTS */
+static int recv_job(int sock, char *path, size_t cap) {
+    union {
+        struct cmsghdr hdr;
+        char           buf[CMSG_SPACE(sizeof(int))];
+    } cm;
+    struct iovec iov = { path, cap - 1 };
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = cm.buf, .msg_controllen = sizeof(cm.buf),
+    };
+    ssize_t n;
+    int fd = -1;
+
+    while ((n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR) {}
+    if (n <= 0) return -2;              /* the parent is done with us */
+    path[n] = '\0';
+
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    if (c && c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+        memcpy(&fd, CMSG_DATA(c), sizeof(fd));
+    }
+    return fd;
+}
+
+/*
+ * Everything the fork copied but stdio and sock, which ends up as
+ * WORKER_SOCK: the files other walker threads had open, and the
+ * parent's ends of other workers' sockets. Kept, those would hold a
+ * worker's socket open after its parent closed it, and its EOF would
+ * never come.
+ */
+static int close_inherited(int sock) {
+    if (sock != WORKER_SOCK && dup2(sock, WORKER_SOCK) < 0) return -1;
+#ifdef SYS_close_range
+    if (syscall(SYS_close_range, WORKER_SOCK + 1, ~0U, 0) == 0) return 0;
+#endif
+    struct rlimit rl;
+    int max = getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < INT_MAX ? (int)rl.rlim_cur : 65536;
+    for (int fd = WORKER_SOCK + 1; fd < max; fd++) close(fd);
+    return 0;
+}
+
+static void worker_main(const proc_worker_t *w, int sock, pid_t parent) {
+    char path[PATH_MAX + 1];
+
+    if (close_inherited(sock) < 0) _exit(1);
+    sock = WORKER_SOCK;
+
+    /*
+     * Nobody would read our replies. The death signal follows the
+     * thread that forked us, not the process (see proc_worker_run()),
+     * and a parent gone before prctl() is caught by the getppid() check;
+     * a parent's normal exit also shows up as EOF on the socket.
+     */
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent) _exit(0);
+
+    void *reply = malloc(w->reply_max);
+
+    for (;;) {
+        int fd = recv_job(sock, path, sizeof(path));
+        if (fd == -2) break;
+
+        int err = 0;
+        ssize_t len = 0;
+        if (fd < 0 || !reply) {
+            err = fd < 0 ? EBADF : ENOMEM;
+        } else if ((len = w->fn(fd, path, reply, w->reply_max, w->arg)) < 0) {
+            err = errno ? errno : EIO;
+        }
+        if (fd >= 0) close(fd);
+
+        struct iovec iov[2] = {
+            { &err, sizeof(err) },
+            { reply, err ? 0 : (size_t)len },
+        };
+        struct msghdr msg = { .msg_iov = iov, .msg_iovlen = 2 };
+        if (sendmsg(sock, &msg, MSG_NOSIGNAL) < 0) break;
+    }
+    _exit(0);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * PARENT SIDE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+void proc_worker_init(proc_worker_t *w, proc_pool_fn fn, void *arg,
+                      size_t reply_max, int timeout_ms) {
+    memset(w, 0, sizeof(*w));
+    w->fn = fn;
+    w->arg = arg;
+    w->reply_max = reply_max;
+    w->timeout_ms = timeout_ms;
+    w->sock = -1;
+}
+
+static int worker_start(proc_worker_t *w) {
+    int sv[2];
+    pid_t parent = getpid();
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) < 0) {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        worker_main(w, sv[1], parent);
+    }
+    int err = errno;
+    close(sv[1]);
+
+    if (pid < 0) {
+        close(sv[0]);
+        errno = err;
+        return -1;
+    }
+    w->pid = pid;
+    w->sock = sv[0];
+    w->owner = pthread_self();
+    w->forks++;
+    return 0;
+}
+
+/* Kill and reap the worker; its wait status in *status */
+static void worker_stop(proc_worker_t *w, int *status) {
+    int st = 0;
+
+    if (!w->pid) return;
+    shutdown(w->sock, SHUT_RDWR);
+    close(w->sock);
+    kill(w->pid, SIGKILL);
+    while (waitpid(w->pid, &st, 0) < 0 && errno == EINTR) {}
+    if (status) *status = st;
+    w->pid = 0;
+    w->sock = -1;
+}
+
+void proc_worker_destroy(proc_worker_t *w) {
+    worker_stop(w, NULL);
+}
+
+static int send_job(proc_worker_t *w, const proc_job_t *job) {
+    union {
+        struct cmsghdr hdr;
+        char           buf[CMSG_SPACE(sizeof(int))];
+    } cm;
+    struct iovec iov = { (void *)job->path, strlen(job->path) };
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = cm.buf, .msg_controllen = sizeof(cm.buf),
+    };
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+
+    memset(&cm, 0, sizeof(cm));
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(c), &job->fd, sizeof(int));
+
+    ssize_t n;
+    while ((n = sendmsg(w->sock, &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR) {}
+    return n < 0 ? -1 : 0;
+}
+
+/* The next reply, into job; -1 if the worker is gone, or silent (*timed_out) */
+static int recv_reply(proc_worker_t *w, proc_job_t *job, int *timed_out) {
+    struct pollfd p = { .fd = w->sock, .events = POLLIN };
+    int err;
+    struct iovec iov[2] = {
+        { &err, sizeof(err) },
+        { job->reply, w->reply_max },
+    };
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = 2 };
+
+    *timed_out = 0;
+    for (;;) {
+        int r = poll(&p, 1, w->timeout_ms);
+        if (r < 0 && errno == EINTR) continue;
+        if (r == 0) {
+            *timed_out = 1;
+            return -1;
+        }
+        if (r < 0) return -1;
+
+        /*
+         * A worker that dies with files still queued to it leaves one
+         * ECONNRESET ahead of the replies it did send; those come next.
+         */
+        ssize_t n = recvmsg(w->sock, &msg, 0);
+        if (n < 0 && (errno == EINTR || errno == ECONNRESET)) continue;
+        if (n < (ssize_t)sizeof(err)) return -1;        /* EOF: it died */
+
+        job->err = err;
+        job->len = err ? 0 : (size_t)n - sizeof(err);
+        job->sig = 0;
+        return 0;
+    }
+}
+
+/*
+ * Replies come back in order, so the first job without one is the file
+ * the worker was on when it died or hung. Everything sent after it is
+ * sent again to the next worker.
+ */
+void proc_worker_run(proc_worker_t *w, proc_job_t *jobs, size_t n) {
+    size_t sent = 0, done = 0;
+
+    /*
+     * PR_SET_PDEATHSIG kills the worker when the thread that forked it
+     * exits. Run from another thread, the worker may already be gone,
+     * and the first file sent would be blamed for it: start afresh.
+     */
+    if (w->pid && !pthread_equal(w->owner, pthread_self())) {
+        worker_stop(w, NULL);
+    }
+
+    while (done < n) {
+        if (!w->pid && worker_start(w) < 0) {
+            int err = errno;
+            for (; done < n; done++) {
+                jobs[done].err = err;
+                jobs[done].sig = 0;
+            }
+            return;
+        }
+
+        while (sent < n && sent - done < PROC_WINDOW && send_job(w, &jobs[sent]) == 0) {
+            sent++;
+        }
+
+        int timed_out;
+        if (recv_reply(w, &jobs[done], &timed_out) == 0) {
+            w->jobs++;
+            done++;
+            continue;
+        }
+
+        int status = 0;
+        worker_stop(w, &status);
+        jobs[done].err = timed_out ? ETIMEDOUT : ECHILD;
+        jobs[done].sig = !timed_out && WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+        if (timed_out) w->timeouts++;
+        else w->crashes++;
+        w->jobs++;
+        sent = ++done;
+    }
+}
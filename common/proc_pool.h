@@ -0,0 +1,89 @@
+/*
+ * proc_pool.h - Forked worker processes that parse files in isolation
+ *
+ * The parsers check every offset they take from a file, but a scan of a
+ * whole fleet meets files nobody has tested against, and one crash or
+ * hang in a parser must not end a multi-hour run. In isolated mode each
+ * walker thread hands its files to a worker process of its own instead
+ * of parsing them in place:
+ *
+ *   walker thread                         worker process (fork)
+ *   ┌─────────────────┐   path + fd      ┌──────────────────────┐
+ *   │ proc_worker_run │ ──SCM_RIGHTS──→  │ fn(fd, path, reply)  │
+ *   │                 │ ←──── reply ──── │ one reply per file   │
+ *   └─────────────────┘                  └──────────────────────┘
+ *
+ * Up to PROC_WINDOW files are in flight at once, so the round trips
+ * overlap. If the worker dies (a signal, or any exit) or does not
+ * answer within the timeout, the file it was on is the culprit: its job
+ * gets the error, the worker is killed and forked again, and the files
+ * after it are sent to the new one. Every other file of the batch gets
+ * the same answer it would have got without the crash.
+ *
+ * The worker is a fork() of a threaded process: fn runs with a copy of
+ * the parent's memory, must not take locks other threads may have held
+ * at the fork, and sends back what the parent needs as plain bytes. It
+ * keeps only stdin, stdout, stderr and its socket; fn must not use a
+ * descriptor opened before the fork.
+ *
+ * A proc_worker_t belongs to one thread: give every walker its own. The
+ * worker dies with the thread that forked it (PR_SET_PDEATHSIG is tied
+ * to the thread), and a run from any other thread forks a new one.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef PROC_POOL_H
+#define PROC_POOL_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#define PROC_WINDOW         8           /* files sent ahead of their replies */
+
+/*
+ * Runs in the worker: parse fd (path is for messages) and write at most
+ * cap bytes of reply. Returns the reply length, or -1 with errno set.
+ */
+typedef ssize_t (*proc_pool_fn)(int fd, const char *path, void *reply, size_t cap, void *arg);
+
+typedef struct {
+    int          fd;            /* in: the parent keeps it open */
+    const char  *path;          /* in */
+    void        *reply;         /* in: reply_max bytes, filled by the worker */
+    size_t       len;           /* out: reply length when err == 0 */
+    int          err;           /* out: 0, errno from fn, ECHILD (worker died) or ETIMEDOUT */
+    int          sig;           /* out: ECHILD: the signal that killed it (0 if it exited) */
+} proc_job_t;
+
+typedef struct {
+    proc_pool_fn fn;
+    void        *arg;
+    size_t       reply_max;
+    int          timeout_ms;    /* per reply */
+
+    pid_t        pid;           /* 0: not running */
+    int          sock;          /* SOCK_SEQPACKET to the worker */
+    pthread_t    owner;         /* the thread that forked it */
+
+    /* Statistics */
+    unsigned long jobs;
+    unsigned long crashes;      /* workers that died on a file */
+    unsigned long timeouts;     /* workers killed for not answering */
+    unsigned long forks;
+} proc_worker_t;
+
+/* Set up a worker; the process is forked on the first run */
+void proc_worker_init(proc_worker_t *w, proc_pool_fn fn, void *arg,
+                      size_t reply_max, int timeout_ms);
+void proc_worker_destroy(proc_worker_t *w);
+
+/*
+ * Run n jobs on the worker, restarting it as often as needed, and fill
+ * in every job's len or err. If no worker can be started, the remaining
+ * jobs get that errno.
+ */
+void proc_worker_run(proc_worker_t *w, proc_job_t *jobs, size_t n);
+
+#endif /* PROC_POOL_H */
@@ -0,0 +1,267 @@
+/*
+ * read_batch.c - Batched positional reads over io_uring, or pread()
+ *
+ * See read_batch.h.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "read_batch.h"
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup     425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter     426
+#endif
+
+#define ADVISE_TAG      UINT64_MAX      /* user_data of a linked fadvise */
+#define MAX_READ        (1u << 30)      /* per SQE; a longer request reads short */
+
+static int uring_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uring_enter(int fd, unsigned submit, unsigned wait, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, submit, wait, flags, NULL, 0);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * SETUP
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void ring_unmap(read_batch_t *rb) {
+    if (rb->sqes) munmap(rb->sqes, rb->sqes_size);
+    if (rb->cq_ring && rb->cq_ring != rb->sq_ring) munmap(rb->cq_ring, rb->cq_ring_size);
+    if (rb->sq_ring) munmap(rb->sq_ring, rb->sq_ring_size);
+    if (rb->ring_fd >= 0) close(rb->ring_fd);
+    rb->sqes = rb->cq_ring = rb->sq_ring = NULL;
+    rb->ring_fd = -1;
+}
+
+static int ring_map(read_batch_t *rb, const struct io_uring_params *p) {
+    rb->sq_ring_size = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+    rb->cq_ring_size = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        if (rb->cq_ring_size > rb->sq_ring_size) rb->sq_ring_size = rb->cq_ring_size;
+        rb->cq_ring_size = rb->sq_ring_size;
+    }
+
+    rb->sq_ring = mmap(NULL, rb->sq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, rb->ring_fd, IORING_OFF_SQ_RING);
+    if (rb->sq_ring == MAP_FAILED) {
+        rb->sq_ring = NULL;
+        return -1;
+    }
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        rb->cq_ring = rb->sq_ring;
+    } else {
+        rb->cq_ring = mmap(NULL, rb->cq_ring_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, rb->ring_fd, IORING_OFF_CQ_RING);
+        if (rb->cq_ring == MAP_FAILED) {
+            rb->cq_ring = NULL;
+            return -1;
+        }
+    }
+    rb->sqes_size = p->sq_entries * sizeof(struct io_uring_sqe);
+    rb->sqes = mmap(NULL, rb->sqes_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, rb->ring_fd, IORING_OFF_SQES);
+    if (rb->sqes == MAP_FAILED) {
+        rb->sqes = NULL;
+        return -1;
+    }
+
+    char *sq = rb->sq_ring, *cq = rb->cq_ring;
+    rb->sq_head = (unsigned *)(sq + p->sq_off.head);
+    rb->sq_tail = (unsigned *)(sq + p->sq_off.tail);
+    rb->sq_mask = (unsigned *)(sq + p->sq_off.ring_mask);
+    rb->sq_array = (unsigned *)(sq + p->sq_off.array);
+    rb->cq_head = (unsigned *)(cq + p->cq_off.head);
+    rb->cq_tail = (unsigned *)(cq + p->cq_off.tail);
+    rb->cq_mask = (unsigned *)(cq + p->cq_off.ring_mask);
+    rb->cqes = cq + p->cq_off.cqes;
+    rb->depth = p->sq_entries;
+    return 0;
+}
+
+int read_batch_init(read_batch_t *rb, unsigned depth, int use_uring) {
+    memset(rb, 0, sizeof(*rb));
+    rb->ring_fd = -1;
+    if (depth == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    rb->depth = depth;
+    if (!use_uring) return 0;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CLAMP;
+    rb->ring_fd = uring_setup(depth, &p);
+    if (rb->ring_fd < 0) {
+        rb->ring_fd = -1;
+        return 0;
+    }
+    if (ring_map(rb, &p) < 0) {
+        ring_unmap(rb);
+        rb->depth = depth;
+    }
+    return 0;
+}
+
+void read_batch_destroy(read_batch_t *rb) {
+    ring_unmap(rb);
+}
+
+const char *read_batch_backend(const read_batch_t *rb) {
+    return rb->ring_fd >= 0 ? "io_uring" : "pread";
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * READS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void run_pread(read_batch_t *rb, read_req_t *r) {
+    if (r->random) posix_fadvise(r->fd, 0, 0, POSIX_FADV_RANDOM);
+    ssize_t n = pread(r->fd, r->buf, r->len, r->off);
+    r->res = n < 0 ? -errno : n;
+    if (n > 0) rb->bytes += n;
+    rb->enters++;
+}
+
+static struct io_uring_sqe *next_sqe(read_batch_t *rb, unsigned *tail) {
+    unsigned idx = *tail & *rb->sq_mask;
+    struct io_uring_sqe *sqe = (struct io_uring_sqe *)rb->sqes + idx;
+    memset(sqe, 0, sizeof(*sqe));
+    rb->sq_array[idx] = idx;
+    (*tail)++;
+    return sqe;
+}
+
+/* Take every completion posted so far */
+static void reap(read_batch_t *rb, read_req_t *reqs, unsigned *inflight, size_t *done) {
+    unsigned head = *rb->cq_head;
+    unsigned ctail = __atomic_load_n(rb->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != ctail; head++) {
+        const struct io_uring_cqe *cqe =
+            (const struct io_uring_cqe *)rb->cqes + (head & *rb->cq_mask);
+        (*inflight)--;
+        if (cqe->user_data == ADVISE_TAG) continue;
+
+        read_req_t *r = &reqs[cqe->user_data];
+        (*done)++;
+        if (cqe->res == -ECANCELED && r->random) {
+            /* The advice failed and took its linked read with it */
+            r->random = 0;
+            run_pread(rb, r);
+            continue;
+        }
+        r->res = cqe->res;
+        if (cqe->res > 0) rb->bytes += cqe->res;
+    }
+    __atomic_store_n(rb->cq_head, head, __ATOMIC_RELEASE);
+}
+
+/*
+ * The ring is failing: take back the SQEs the kernel has not consumed,
+ * and wait out the ones it has, whose reads still land in the callers'
+ * buffers. Completions are posted without our help, so if even a plain
+ * wait fails the CQ is simply looked at again a little later.
+ */
+static void drain(read_batch_t *rb, read_req_t *reqs, unsigned *inflight, size_t *done) {
+    unsigned head = __atomic_load_n(rb->sq_head, __ATOMIC_ACQUIRE);
+    *inflight -= *rb->sq_tail - head;
+    __atomic_store_n(rb->sq_tail, head, __ATOMIC_RELEASE);
+
+    while (*inflight) {
+        if (uring_enter(rb->ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            struct timespec ts = { 0, 1000000 };
+            nanosleep(&ts, NULL);
+        }
+        reap(rb, reqs, inflight, done);
+    }
+}
+
+/*
+ * Fill the SQ with as many requests as fit, then one enter both submits
+ * them and waits for at least one completion. The SQ head tells how many
+ * the kernel has taken, so an interrupted enter simply resubmits the rest.
+ */
+static void run_uring(read_batch_t *rb, read_req_t *reqs, size_t n) {
+    size_t next = 0, done = 0;
+    unsigned inflight = 0;          /* SQEs submitted or queued, not yet reaped */
+
+    for (size_t i = 0; i < n; i++) reqs[i].res = -EINPROGRESS;
+
+    while (done < n) {
+        unsigned tail = *rb->sq_tail;
+        while (next < n && inflight + 1u + (reqs[next].random != 0) <= rb->depth) {
+            read_req_t *r = &reqs[next];
+            if (r->random) {
+                struct io_uring_sqe *sqe = next_sqe(rb, &tail);
+                sqe->opcode = IORING_OP_FADVISE;
+                sqe->fd = r->fd;
+                sqe->fadvise_advice = POSIX_FADV_RANDOM;
+                sqe->flags = IOSQE_IO_LINK;
+                sqe->user_data = ADVISE_TAG;
+                inflight++;
+            }
+            struct io_uring_sqe *sqe = next_sqe(rb, &tail);
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = r->fd;
+            sqe->off = r->off;
+            sqe->addr = (uintptr_t)r->buf;
+            sqe->len = r->len < MAX_READ ? r->len : MAX_READ;
+            sqe->user_data = next;
+            inflight++;
+            next++;
+        }
+        __atomic_store_n(rb->sq_tail, tail, __ATOMIC_RELEASE);
+
+        unsigned pending = tail - __atomic_load_n(rb->sq_head, __ATOMIC_ACQUIRE);
+        rb->enters++;
+        if (uring_enter(rb->ring_fd, pending, 1, IORING_ENTER_GETEVENTS) < 0 &&
+            errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            /*
+             * Not expected once the ring is set up. Once nothing is in
+             * flight, the requests that never completed are read with
+             * pread(), and this reader stays on pread() from now on.
+             */
+            int err = errno;
+            drain(rb, reqs, &inflight, &done);
+            for (size_t i = 0; i < n; i++) {
+                if (reqs[i].res == -EINPROGRESS) run_pread(rb, &reqs[i]);
+            }
+            ring_unmap(rb);
+            errno = err;
+            return;
+        }
+
+        reap(rb, reqs, &inflight, &done);
+    }
+}
+
+void read_batch_run(read_batch_t *rb, read_req_t *reqs, size_t n) {
+    if (n == 0) return;
+    rb->batches++;
+    rb->reads += n;
+
+    if (rb->ring_fd >= 0) {
+        run_uring(rb, reqs, n);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        run_pread(rb, &reqs[i]);
+    }
+}
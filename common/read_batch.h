@@ -0,0 +1,75 @@
+/*
+ * read_batch.h - Batched positional reads over io_uring, or pread()
+ *
+ * The scanners need a few small pieces of each file (ELF header,
+ * program headers, dynamic segment, .dynstr) and many files at once.
+ * Reading those pieces one pread() at a time means one blocking round
+ * trip per piece, which on a cold cache or a network mount is the whole
+ * cost of a scan. read_batch_run() instead submits every request of a
+ * batch in one go and waits for them together:
+ *
+ *   reqs[0..n)  ──SQEs──→  io_uring  ──CQEs──→  reqs[i].res
+ *               (up to depth in flight; one io_uring_enter per window)
+ *
+ * The ring is driven with the raw syscalls (no liburing). Where
+ * io_uring is unavailable (old kernel, seccomp, io_uring_disabled) the
+ * same requests are served with one pread() each, so callers never
+ * need a second code path.
+ *
+ * A read_batch_t belongs to one thread: give every worker its own.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef READ_BATCH_H
+#define READ_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    int         fd;
+    int         random;     /* POSIX_FADV_RANDOM first: no readahead past the range */
+    uint64_t    off;
+    size_t      len;
+    void       *buf;
+    long        res;        /* out: bytes read (short only at EOF), or -errno */
+} read_req_t;
+
+typedef struct {
+    int         ring_fd;    /* -1: pread() fallback */
+    unsigned    depth;      /* SQ entries */
+
+    /* Ring mappings (see io_uring_setup(2)) */
+    void       *sq_ring;
+    size_t      sq_ring_size;
+    void       *cq_ring;
+    size_t      cq_ring_size;
+    void       *sqes;
+    size_t      sqes_size;
+    unsigned   *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned   *cq_head, *cq_tail, *cq_mask;
+    void       *cqes;
+
+    /* Statistics */
+    unsigned long batches;
+    unsigned long reads;
+    unsigned long enters;   /* io_uring_enter() calls, or preads issued */
+    uint64_t      bytes;
+} read_batch_t;
+
+/*
+ * Set up a reader with room for depth reads in flight. With use_uring
+ * 0, or if the ring cannot be created, reads fall back to pread().
+ * Returns 0 (always usable), or -1 only for a depth of 0.
+ */
+int read_batch_init(read_batch_t *rb, unsigned depth, int use_uring);
+void read_batch_destroy(read_batch_t *rb);
+
+/* Whether the ring is in use; "io_uring" or "pread" for reports */
+const char *read_batch_backend(const read_batch_t *rb);
+
+/* Run n requests and fill in every res. Returns once all have completed. */
+void read_batch_run(read_batch_t *rb, read_req_t *reqs, size_t n);
+
+#endif /* READ_BATCH_H */
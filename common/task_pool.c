@@ -0,0 +1,245 @@
+/*
+ * task_pool.c - Work-stealing task pool for the scanners
+ *
+ * See task_pool.h. The deque follows Chase & Lev ("Dynamic Circular
+ * Work-Stealing Deque", SPAA 2005) with the memory orderings of Lê et
+ * al. ("Correct and Efficient Work-Stealing for Weak Memory Models",
+ * PPoPP 2013), their seq-cst fences folded into seq-cst accesses of
+ * top and bottom, and minus the resizing: a full deque refuses.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "task_pool.h"
+
+#define DEQUE_MASK      (TASK_DEQUE_SIZE - 1)
+#define IDLE_SPINS      64          /* failed steal rounds before parking */
+#define PARK_NS         1000000     /* re-check at least every millisecond */
+
+int task_pool_default_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > TASK_POOL_MAX_THREADS) n = TASK_POOL_MAX_THREADS;
+    return (int)n;
+}
+
+int task_pool_init(task_pool_t *p, int nworkers) {
+    memset(p, 0, sizeof(*p));
+    if (nworkers <= 0) nworkers = task_pool_default_threads();
+    if (nworkers > TASK_POOL_MAX_THREADS) nworkers = TASK_POOL_MAX_THREADS;
+
+    if (posix_memalign((void **)&p->deques, 64, nworkers * sizeof(*p->deques)) != 0) {
+        p->deques = NULL;
+        errno = ENOMEM;
+        return -1;
+    }
+    memset(p->deques, 0, nworkers * sizeof(*p->deques));
+    p->nworkers = nworkers;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->wake, NULL);
+    return 0;
+}
+
+void task_pool_destroy(task_pool_t *p) {
+    free(p->deques);
+    pthread_cond_destroy(&p->wake);
+    pthread_mutex_destroy(&p->lock);
+    memset(p, 0, sizeof(*p));
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * DEQUE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* Owner only; the number of tasks that were already queued, or -1 if full */
+static long deque_push(task_deque_t *q, task_fn fn, void *arg) {
+    long b = __atomic_load_n(&q->bottom, __ATOMIC_RELAXED);
+    long t = __atomic_load_n(&q->top, __ATOMIC_ACQUIRE);
+    if (b - t >= TASK_DEQUE_SIZE) return -1;
+
+    task_t *slot = &q->slots[b & DEQUE_MASK];
+    __atomic_store_n(&slot->fn, fn, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->arg, arg, __ATOMIC_RELAXED);
+    __atomic_store_n(&q->bottom, b + 1, __ATOMIC_RELEASE);
+    return b > t ? b - t : 0;
+}
+
+/* Owner only; 1 if a task was taken */
+static int deque_pop(task_deque_t *q, task_t *out) {
+    /* Seq-cst store then load: a thief cannot miss the claim on the last task */
+    long b = __atomic_load_n(&q->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&q->bottom, b, __ATOMIC_SEQ_CST);
+    long t = __atomic_load_n(&q->top, __ATOMIC_SEQ_CST);
+
+    if (t > b) {
+        /* Empty */
+        __atomic_store_n(&q->bottom, b + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    task_t *slot = &q->slots[b & DEQUE_MASK];
+    out->fn = __atomic_load_n(&slot->fn, __ATOMIC_RELAXED);
+    out->arg = __atomic_load_n(&slot->arg, __ATOMIC_RELAXED);
+    if (t == b) {
+        /* Last one: race any thief for it */
+        int won = __atomic_compare_exchange_n(&q->top, &t, t + 1, 0,
+                                              __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&q->bottom, b + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return 1;
+}
+
+/* Any thread; 1 if a task was taken */
+static int deque_steal(task_deque_t *q, task_t *out) {
+    long t = __atomic_load_n(&q->top, __ATOMIC_SEQ_CST);
+    long b = __atomic_load_n(&q->bottom, __ATOMIC_SEQ_CST);
+    if (t >= b) return 0;
+
+    /* The slot may be rewritten once top moves on; the CAS tells us if it did */
+    task_t *slot = &q->slots[t & DEQUE_MASK];
+    out->fn = __atomic_load_n(&slot->fn, __ATOMIC_RELAXED);
+    out->arg = __atomic_load_n(&slot->arg, __ATOMIC_RELAXED);
+    return __atomic_compare_exchange_n(&q->top, &t, t + 1, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * SPAWNING
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void wake_one(task_pool_t *p) {
+    if (__atomic_load_n(&p->sleepers, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&p->lock);
+        pthread_cond_signal(&p->wake);
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+int task_spawn(task_pool_t *p, int worker, task_fn fn, void *arg) {
+    /* Counted before it is visible, so a thief can never see pending hit 0 early */
+    __atomic_fetch_add(&p->pending, 1, __ATOMIC_RELAXED);
+    long queued = deque_push(&p->deques[worker], fn, arg);
+    if (queued < 0) {
+        __atomic_fetch_sub(&p->pending, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&p->inline_runs, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    /* The first task is the one we pop next ourselves; wake a thief for the surplus */
+    if (queued > 0) wake_one(p);
+    return 0;
+}
+
+int task_pool_submit(task_pool_t *p, task_fn fn, void *arg) {
+    for (int tries = 0; tries < p->nworkers; tries++) {
+        int w = p->next_submit++ % p->nworkers;
+        if (deque_push(&p->deques[w], fn, arg) >= 0) {
+            p->pending++;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * WORKERS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    task_pool_t *pool;
+    int          id;
+} worker_arg_t;
+
+static int find_task(task_pool_t *p, int id, unsigned *seed, task_t *t) {
+    if (deque_pop(&p->deques[id], t)) return 1;
+
+    /* Start at a random victim so thieves spread out */
+    *seed = *seed * 1103515245u + 12345u;
+    int start = (*seed >> 16) % p->nworkers;
+    for (int i = 0; i < p->nworkers; i++) {
+        int v = (start + i) % p->nworkers;
+        if (v != id && deque_steal(&p->deques[v], t)) {
+            __atomic_fetch_add(&p->steals, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void park(task_pool_t *p) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += PARK_NS;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    __atomic_fetch_add(&p->sleepers, 1, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&p->pending, __ATOMIC_ACQUIRE) > 0) {
+        pthread_cond_timedwait(&p->wake, &p->lock, &ts);
+    }
+    __atomic_fetch_sub(&p->sleepers, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void *worker_main(void *arg) {
+    worker_arg_t *wa = arg;
+    task_pool_t *p = wa->pool;
+    unsigned seed = wa->id * 2654435761u + 1;
+    int idle = 0;
+
+    for (;;) {
+        task_t t;
+        if (find_task(p, wa->id, &seed, &t)) {
+            idle = 0;
+            t.fn(p, wa->id, t.arg);
+            if (__atomic_sub_fetch(&p->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+                pthread_mutex_lock(&p->lock);
+                pthread_cond_broadcast(&p->wake);
+                pthread_mutex_unlock(&p->lock);
+            }
+            continue;
+        }
+        if (__atomic_load_n(&p->pending, __ATOMIC_ACQUIRE) == 0) break;
+        if (++idle < IDLE_SPINS) {
+            sched_yield();
+        } else {
+            park(p);
+        }
+    }
+    return NULL;
+}
+
+void task_pool_run(task_pool_t *p) {
+    pthread_t threads[TASK_POOL_MAX_THREADS];
+    worker_arg_t args[TASK_POOL_MAX_THREADS];
+    int started = 0;
+
+    for (; started < p->nworkers; started++) {
+        args[started].pool = p;
+        args[started].id = started;
+        if (pthread_create(&threads[started], NULL, worker_main, &args[started]) != 0) break;
+    }
+
+    if (started == 0) {
+        /* Could not start any thread: run on the caller's thread instead */
+        args[0].pool = p;
+        args[0].id = 0;
+        worker_main(&args[0]);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
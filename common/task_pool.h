@@ -0,0 +1,87 @@
+/*
+ * task_pool.h - Work-stealing task pool for the scanners
+ *
+ * Each worker owns a bounded deque (Chase-Lev). A worker pushes the
+ * tasks it spawns onto the bottom of its own deque and pops them from
+ * there again, LIFO, so the work it just produced runs while it is
+ * still hot in cache. An idle worker steals from the top of someone
+ * else's deque, taking the oldest (usually largest) piece of work:
+ *
+ *          push/pop                        steal
+ *   worker 0 ──→ [ bottom ... top ] ←──┐
+ *   worker 1 ──→ [ bottom ... top ]    ├── idle worker
+ *   worker 2 ──→ [ bottom ... top ] ←──┘
+ *
+ * Push, pop and steal are lock-free; the only lock is the one idle
+ * workers sleep on. A deque holds TASK_DEQUE_SIZE tasks: when it is
+ * full task_spawn() refuses and the caller runs the work itself, which
+ * is the pool's backpressure: producers slow down to the speed of the
+ * consumers instead of queueing without bound.
+ *
+ * The pool runs until no task is queued or running anywhere.
+ *
+ * EDUCATIONAL PURPOSES ONLY
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <pthread.h>
+
+#define TASK_POOL_MAX_THREADS   256
+#define TASK_DEQUE_SIZE         4096        /* power of two */
+
+typedef struct task_pool task_pool_t;
+
+/* worker is the index of the thread running the task (0 .. nworkers-1) */
+typedef void (*task_fn)(task_pool_t *pool, int worker, void *arg);
+
+typedef struct {
+    task_fn  fn;
+    void    *arg;
+} task_t;
+
+typedef struct {
+    long    top __attribute__((aligned(64)));       /* thieves take from here */
+    long    bottom __attribute__((aligned(64)));    /* the owner's end */
+    task_t  slots[TASK_DEQUE_SIZE];
+} task_deque_t;
+
+struct task_pool {
+    int             nworkers;
+    task_deque_t   *deques;         /* one per worker */
+    long            pending;        /* tasks queued or running */
+    int             sleepers;
+    int             next_submit;
+
+    pthread_mutex_t lock;           /* idle workers park here */
+    pthread_cond_t  wake;
+
+    unsigned long   steals;
+    unsigned long   inline_runs;    /* spawns refused because a deque was full */
+};
+
+/* nworkers <= 0: one per online CPU. Returns 0, or -1 when out of memory. */
+int task_pool_init(task_pool_t *p, int nworkers);
+void task_pool_destroy(task_pool_t *p);
+
+/* Queue a task before task_pool_run(); -1 if every deque is full */
+int task_pool_submit(task_pool_t *p, task_fn fn, void *arg);
+
+/*
+ * From inside a task: queue fn(arg) on the calling worker's deque.
+ * Returns -1 if the deque is full; the caller should then do the work
+ * itself.
+ */
+int task_spawn(task_pool_t *p, int worker, task_fn fn, void *arg);
+
+/*
+ * Run every submitted task, and everything they spawn, to completion.
+ * Falls back to the calling thread if no worker thread starts.
+ */
+void task_pool_run(task_pool_t *p);
+
+/* Default worker count used when nworkers <= 0 */
+int task_pool_default_threads(void);
+
+#endif /* TASK_POOL_H */